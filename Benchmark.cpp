@@ -0,0 +1,90 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+#include "Graph.h"
+#include "Graph_frozen.h"
+#include "Graph_algorithms.h"
+
+// Scaling benchmark of parallel delta-stepping against sequential Dijkstra
+// Usage: Benchmark [vertices] [edges] [max edge value] [max threads]
+//		Random graph with uniformly distributed edges has low diameter, which suits delta-stepping.
+
+Graph::FrozenGraph<size_t, size_t> randomGraph(size_t verticesCount, size_t edgesCount, size_t maxValue)
+{
+	std::mt19937_64 rng(42);
+	std::vector<std::pair<size_t, size_t>> edges;
+	edges.reserve(edgesCount);
+	for(size_t i = 0; i < edgesCount; ++i)
+	{
+		edges.emplace_back(rng() % verticesCount, rng() % verticesCount);
+	}
+	std::sort(edges.begin(), edges.end());
+	edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+	std::vector<size_t> ids(verticesCount);
+	for(size_t i = 0; i < verticesCount; ++i)
+	{
+		ids[i] = i;
+	}
+	std::vector<size_t> offsets(verticesCount + 1, 0);
+	std::vector<size_t> targets;
+	std::vector<size_t> weights;
+	targets.reserve(edges.size());
+	weights.reserve(edges.size());
+	for(const auto& e : edges)
+	{
+		++offsets[e.first + 1];
+		targets.push_back(e.second);
+		weights.push_back(1 + rng() % maxValue);
+	}
+	for(size_t i = 0; i < verticesCount; ++i)
+	{
+		offsets[i + 1] += offsets[i];
+	}
+	std::vector<size_t> values = ids;
+	return Graph::FrozenGraph<size_t, size_t>(true, std::move(ids), std::move(values), std::move(offsets),
+	                                          std::move(targets), std::move(weights));
+}
+
+template<typename Func>
+double measure(Func f)
+{
+	auto start = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+	size_t verticesCount = argc > 1 ? std::stoull(argv[1]) : 1000000;
+	size_t edgesCount = argc > 2 ? std::stoull(argv[2]) : 20000000;
+	size_t maxValue = argc > 3 ? std::stoull(argv[3]) : 100;
+	size_t maxThreads = argc > 4 ? std::stoull(argv[4]) : std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+
+	std::cout << "Generating graph with " << verticesCount << " vertices and " << edgesCount << " edges..." << std::endl;
+	auto graph = randomGraph(verticesCount, edgesCount, maxValue);
+
+	Graph::ShortestPaths<size_t> reference;
+	double sequential = measure([&]() { reference = Graph::dijkstraDense(graph, 0); });
+	std::cout << "dijkstraDense: " << sequential << " ms" << std::endl;
+
+	double single = 0;
+	for(size_t threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		Graph::ShortestPaths<size_t> result;
+		double time = measure([&]() { result = Graph::deltaSteppingDense(graph, 0, size_t(0), threads); });
+		if(threads == 1)
+		{
+			single = time;
+		}
+		std::cout << "deltaStepping, " << threads << " threads: " << time << " ms, speedup " << single / time
+		          << ", same distances? " << (result.distance == reference.distance) << std::endl;
+	}
+
+	return 0;
+}
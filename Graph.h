@@ -7,6 +7,25 @@
 #include <fstream>
 #include <algorithm>
 #include <set>
+#include <unordered_set>
+#include <tuple>
+#include <iterator>
+#include <iostream>
+#include <stdexcept>
+#include <limits>
+#include <future>
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <cstdio>
+#include "Graph_storage.h"
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 namespace Graph
 {
@@ -17,110 +36,951 @@ namespace Graph
 	{
 		bool operator==(const Unweight&) const
 		{
-			return true;
+			return true;
+		}
+
+		bool operator!=(const Unweight&) const
+		{
+			return false;
+		}
+	};
+
+	/**
+	 * Estimated memory consumption of graph in bytes
+	 */
+	struct MemoryUsage
+	{
+		// Vertex container and vertex structs (without their values)
+		size_t vertices = 0;
+		// Adjacency containers (without edge values) and incoming index
+		size_t adjacency = 0;
+		// Edge values including heap memory owned by them
+		size_t edgeValues = 0;
+		// Vertex values including heap memory owned by them
+		size_t vertexValues = 0;
+
+		size_t total() const
+		{
+			return vertices + adjacency + edgeValues + vertexValues;
+		}
+	};
+
+	/**
+	 * Parsing of values in text graph format without streams (used by loadFromFileParallel)
+	 * Value is read from the rest of line [pos, end), the result is the same as of reading it
+	 * by operator>> from stream; fast paths handle integers and plain decimal floating numbers,
+	 * other types and unusual inputs fall back to stream.
+	 */
+	namespace helper
+	{
+		inline const char* skipBlanks(const char* pos, const char* end)
+		{
+			while(pos != end && (*pos == ' ' || *pos == '\t'))
+			{
+				++pos;
+			}
+			return pos;
+		}
+
+		/**
+		 * Parses id of vertex (decimal digits)
+		 * @param pos position in line, moved behind parsed id
+		 * @param end end of line
+		 * @param id parsed id
+		 * @return false if there is no valid id
+		 */
+		inline bool parseTextId(const char*& pos, const char* end, size_t& id)
+		{
+			const char* it = skipBlanks(pos, end);
+			if(it == end || *it < '0' || *it > '9')
+			{
+				return false;
+			}
+			size_t result = 0;
+			for(; it != end && *it >= '0' && *it <= '9'; ++it)
+			{
+				size_t digit = size_t(*it - '0');
+				if(result > (std::numeric_limits<size_t>::max() - digit) / 10)
+				{
+					return false;
+				}
+				result = result * 10 + digit;
+			}
+			id = result;
+			pos = it;
+			return true;
+		}
+
+		template<typename T>
+		void parseTextValueStream(const char* pos, const char* end, T& value)
+		{
+			std::istringstream ss(std::string(pos, end));
+			ss >> value;
+		}
+
+		template<typename T>
+		using isTextInteger = std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+		        !std::is_same<T, char>::value && !std::is_same<T, signed char>::value && !std::is_same<T, unsigned char>::value &&
+		        !std::is_same<T, wchar_t>::value && !std::is_same<T, char16_t>::value && !std::is_same<T, char32_t>::value>;
+
+		template<typename T>
+		std::enable_if_t<!isTextInteger<T>::value && !std::is_floating_point<T>::value>
+		parseTextValue(const char* pos, const char* end, T& value)
+		{
+			parseTextValueStream(pos, end, value);
+		}
+
+		template<typename T>
+		std::enable_if_t<isTextInteger<T>::value>
+		parseTextValue(const char* pos, const char* end, T& value)
+		{
+			const char* it = skipBlanks(pos, end);
+			bool negative = false;
+			if(it != end && (*it == '+' || *it == '-'))
+			{
+				negative = *it == '-';
+				++it;
+			}
+			// Negative unsigned numbers are wrapped by streams, overflow sets limit - both are left to stream
+			if(it == end || *it < '0' || *it > '9' || (negative && std::is_unsigned<T>::value))
+			{
+				parseTextValueStream(pos, end, value);
+				return;
+			}
+			using U = std::make_unsigned_t<T>;
+			U limit = negative ? U(U(std::numeric_limits<T>::max()) + 1) : U(std::numeric_limits<T>::max());
+			U result = 0;
+			for(; it != end && *it >= '0' && *it <= '9'; ++it)
+			{
+				U digit = U(*it - '0');
+				if(result > U((limit - digit) / 10))
+				{
+					parseTextValueStream(pos, end, value);
+					return;
+				}
+				result = U(result * 10 + digit);
+			}
+			value = negative ? T(U(0) - result) : T(result);
+		}
+
+		inline float parseFloating(const char* pos, char** last, float)
+		{
+			return std::strtof(pos, last);
+		}
+
+		inline double parseFloating(const char* pos, char** last, double)
+		{
+			return std::strtod(pos, last);
+		}
+
+		inline long double parseFloating(const char* pos, char** last, long double)
+		{
+			return std::strtold(pos, last);
+		}
+
+		/**
+		 * Line must be followed by character which is not part of number (e.g. new line or terminating zero)
+		 */
+		template<typename T>
+		std::enable_if_t<std::is_floating_point<T>::value>
+		parseTextValue(const char* pos, const char* end, T& value)
+		{
+			const char* first = skipBlanks(pos, end);
+			const char* last = first;
+			while(last != end && ((*last >= '0' && *last <= '9') || *last == '.' || *last == '-' ||
+			                      *last == '+' || *last == 'e' || *last == 'E'))
+			{
+				++last;
+			}
+			// Number has to be consumed whole (strtod also accepts hexadecimal, inf, nan and depends on locale)
+			char* parsedEnd = nullptr;
+			errno = 0;
+			T result = parseFloating(first, &parsedEnd, T());
+			if(last == first || parsedEnd != last || errno == ERANGE)
+			{
+				parseTextValueStream(pos, end, value);
+				return;
+			}
+			value = result;
+		}
+
+		/**
+		 * Extracts string between first and last quote of line
+		 * @return false if line does not contain two quotes
+		 */
+		inline bool parseTextQuoted(const char* pos, const char* end, std::string& value)
+		{
+			const char* first = static_cast<const char*>(std::memchr(pos, '"', size_t(end - pos)));
+			if(first == nullptr)
+			{
+				return false;
+			}
+			const char* last = end - 1;
+			while(*last != '"')
+			{
+				--last;
+			}
+			if(last == first)
+			{
+				return false;
+			}
+			value.assign(first + 1, last);
+			return true;
+		}
+
+		/**
+		 * Parses vertex value (strings are quoted, missing quotes result in empty string)
+		 */
+		template<typename T>
+		void parseTextVertexValue(const char* pos, const char* end, T& value)
+		{
+			parseTextValue(pos, end, value);
+		}
+
+		inline void parseTextVertexValue(const char* pos, const char* end, std::string& value)
+		{
+			parseTextQuoted(pos, end, value);
+		}
+
+		/**
+		 * Parses edge value
+		 * @return false if edge is not to be loaded (string value without quotes)
+		 */
+		template<typename T>
+		bool parseTextEdgeValue(const char* pos, const char* end, T& value)
+		{
+			parseTextValue(pos, end, value);
+			return true;
+		}
+
+		inline bool parseTextEdgeValue(const char* pos, const char* end, std::string& value)
+		{
+			return parseTextQuoted(pos, end, value);
+		}
+
+		inline bool parseTextEdgeValue(const char*, const char*, Unweight&)
+		{
+			return true;
+		}
+
+		/**
+		 * Writes value in text graph format (strings are quoted)
+		 */
+		template<typename T>
+		void writeTextValue(std::ostream& stream, const T& value)
+		{
+			stream << value;
+		}
+
+		inline void writeTextValue(std::ostream& stream, const std::string& value)
+		{
+			stream << '"' << value << '"';
+		}
+
+		inline void writeTextValue(std::ostream&, const Unweight&)
+		{
+		}
+
+		/**
+		 * Append-only journal file of graph mutations
+		 *
+		 * Records are buffered, they reach the file when buffer fills up, on sync and on close.
+		 * Copy of graph does not inherit journal (copy and assignment leave it as it is).
+		 */
+		class Journal
+		{
+		private:
+			struct FileCloser
+			{
+				void operator()(std::FILE* file) const
+				{
+					std::fclose(file);
+				}
+			};
+
+			static constexpr size_t bufferSize = 1 << 16;
+
+			std::unique_ptr<std::FILE, FileCloser> file;
+			std::string path;
+			// Record being written, it is moved to file buffer by commit
+			std::ostringstream pending;
+			bool failed = false;
+			// Counter of fresh ids is recorded once per opened or truncated file (before the first added vertex)
+			bool counterRecorded = false;
+
+		public:
+			Journal() = default;
+
+			Journal(const Journal&)
+			{
+			}
+
+			Journal(Journal&&) = default;
+
+			Journal& operator=(const Journal&)
+			{
+				return *this;
+			}
+
+			Journal& operator=(Journal&&) = default;
+
+			/**
+			 * Opens journal file for appending
+			 * @param filePath path to file (created if it does not exist)
+			 * @return true if file was opened
+			 */
+			bool open(const std::string& filePath)
+			{
+				std::unique_ptr<std::FILE, FileCloser> opened(std::fopen(filePath.c_str(), "a"));
+				if(!opened)
+				{
+					return false;
+				}
+				std::setvbuf(opened.get(), nullptr, _IOFBF, bufferSize);
+				file = std::move(opened);
+				path = filePath;
+				failed = false;
+				counterRecorded = false;
+				return true;
+			}
+
+			void close()
+			{
+				file.reset();
+				path.clear();
+			}
+
+			/**
+			 * Removes all records from journal
+			 * @return true if journal is open and was truncated
+			 */
+			bool truncate()
+			{
+				if(!file)
+				{
+					return false;
+				}
+				pending.str(std::string());
+				file.reset(std::fopen(path.c_str(), "w"));
+				failed = false;
+				counterRecorded = false;
+				return file != nullptr;
+			}
+
+			bool isOpen() const
+			{
+				return file != nullptr;
+			}
+
+			/**
+			 * Marks counter of fresh ids as recorded
+			 * @return true if it was not recorded yet
+			 */
+			bool markCounter()
+			{
+				bool first = !counterRecorded;
+				counterRecorded = true;
+				return first;
+			}
+
+			/**
+			 * Checks that all records were written
+			 */
+			bool good() const
+			{
+				return file && !failed && !std::ferror(file.get());
+			}
+
+			std::ostream& record()
+			{
+				return pending;
+			}
+
+			/**
+			 * Moves written records to file buffer (file is written only when buffer is full)
+			 */
+			void commit()
+			{
+				const std::string records = pending.str();
+				if(std::fwrite(records.data(), 1, records.size(), file.get()) != records.size())
+				{
+					failed = true;
+				}
+				pending.str(std::string());
+			}
+
+			/**
+			 * Writes buffered records to file and waits until they are stored on disk
+			 * @return true if all records were written and stored
+			 */
+			bool sync()
+			{
+				if(!file)
+				{
+					return false;
+				}
+				if(std::fflush(file.get()) != 0)
+				{
+					failed = true;
+				}
+#if defined(_WIN32)
+				failed = _commit(_fileno(file.get())) != 0 || failed;
+#else
+				failed = ::fsync(fileno(file.get())) != 0 || failed;
+#endif
+				return good();
+			}
+		};
+
+		/**
+		 * Hash of pair of vertex ids (edge)
+		 */
+		struct EdgeHash
+		{
+			size_t operator()(const std::pair<size_t, size_t>& edge) const
+			{
+				return std::hash<size_t>()(edge.first) ^ (std::hash<size_t>()(edge.second) + 0x9e3779b97f4a7c15ull + (edge.first << 6) + (edge.first >> 2));
+			}
+		};
+	}
+
+	/**
+	 * Classes declarations
+	 */
+	template<typename V, typename E, typename S = DefaultStorage>
+	class GraphBase;
+
+	template<typename V, typename E = Unweight, typename S = DefaultStorage>
+	class Graph;
+
+	template<typename U, typename S>
+	class Graph<U, Unweight, S>;
+
+	template<typename V, typename E>
+	class FrozenGraph;
+
+	/**
+	 * Base Graph class
+	 */
+	template<typename V, typename E, typename S>
+	class GraphBase
+	{
+	protected:
+		template<typename, typename>
+		friend class FrozenGraph;
+
+		using edgeStore_t = typename S::template edge_store<E, S::template allocator>;
+		using edgeEntry = typename edgeStore_t::entry_type;
+		using edgeMap = typename S::template edge_container<edgeEntry, S::template allocator>;
+
+		/**
+		 * Vertex struct
+		 * 
+		 * Just simple "value-holder" which is visible only to GraphBase and derived classes
+		 */
+		// Allocator of graph, containers rebind it (it refers to arena of graph)
+		using nodeAllocator = typename S::template allocator<char>;
+
+		struct Vertex
+		{
+			size_t id;
+			V value;
+			edgeMap outgoingEdges;
+			// Ids of predecessors, maintained only when incoming index of directed graph is enabled
+			std::vector<size_t> incomingEdges;
+	
+			Vertex(size_t id, V value, const nodeAllocator& allocator)
+				:id(id), value(std::move(value)), outgoingEdges(helper::makeContainer<edgeMap>(allocator))
+			{}
+		};
+
+		using vertexHolder = typename S::template holder<Vertex>;
+		using vertexMap = typename S::template vertex_container<vertexHolder, S::template allocator>;
+		using vertexMapHolder = typename S::template holder<vertexMap>;
+		using edgeStoreHolder = typename S::template holder<edgeStore_t>;
+
+	public:
+		/**
+		 * Views of neighbours, outgoing and incoming edges, they stay valid until the vertex is modified
+		 * (view of incoming edges until any of its predecessors is modified as well), the same holds for references
+		 * to vertex and edge values. Edge values kept in shared edge store are the exception - while copy of graph
+		 * shares them, modification of any edge value may invalidate views of edges and references to edge values.
+		 */
+		using NeighboursView = Range<KeyIterator<typename edgeMap::const_iterator>>;
+		using EdgesView = Range<EdgeIterator<typename edgeMap::const_iterator, edgeStore_t>>;
+		using IncomingEdgesView = Range<IncomingEdgeIterator<std::vector<size_t>::const_iterator, vertexMap, edgeStore_t>>;
+
+	protected:
+		const bool directed;
+		// Arena outlives containers which allocate from it
+		typename S::arena arena;
+		// Holders are read through -> and modified through mutate() (see storage policy)
+		vertexMapHolder vertices;
+		// Values of edges (adjacency holds entries referring to them)
+		edgeStoreHolder edgeStore;
+		size_t total_id = 0;
+		bool incomingIndex = false;
+		// Journal of mutations (not inherited by copies)
+		helper::Journal journal;
+
+		/**
+		* Orientation constructor
+		* @param directed true for directed, false undirected
+		*/
+		GraphBase(bool directed = true)
+			:directed(directed), vertices(_makeVertexMap())
+		{}
+
+		GraphBase(const GraphBase&) = default;
+		
+		GraphBase(GraphBase&&) = default;
+
+		GraphBase& operator=(const GraphBase& rhs)
+		{
+			if(directed != rhs.directed)
+			{
+				throw std::invalid_argument("Graphs' orientation must be equal.");
+			}
+			
+			vertices = rhs.vertices;
+			edgeStore = rhs.edgeStore;
+			// Containers took allocator of rhs, so its arena is shared
+			arena = rhs.arena;
+			total_id = rhs.total_id;
+			incomingIndex = rhs.incomingIndex;
+			
+			return *this;
+		}
+		
+		GraphBase& operator=(GraphBase&& rhs)
+		{
+			if(directed != rhs.directed)
+			{
+				throw std::invalid_argument("Graphs' orientation must be equal.");
+			}
+			
+			vertices = std::move(rhs.vertices);
+			edgeStore = std::move(rhs.edgeStore);
+			arena = rhs.arena;
+			total_id = std::move(rhs.total_id);
+			incomingIndex = rhs.incomingIndex;
+			
+			return *this;
+		}
+
+		/**
+		 * Get allocator for containers of graph
+		 * @return allocator referring to arena of graph
+		 */
+		nodeAllocator _nodeAllocator() const
+		{
+			return arena.template allocator<nodeAllocator>();
+		}
+
+		/**
+		 * Creates empty vertex container using allocator of graph
+		 * @return holder of vertex container
+		 */
+		vertexMapHolder _makeVertexMap() const
+		{
+			return vertexMapHolder(helper::makeContainer<vertexMap>(_nodeAllocator()));
+		}
+
+		/**
+		 * Checks if predecessors are kept in incoming index
+		 * @return true if graph is directed and incoming index is enabled
+		 */
+		bool _tracksIncoming() const
+		{
+			return incomingIndex && directed;
+		}
+
+		/**
+		 * Records edge in incoming index of its end vertex (edge must be newly inserted)
+		 * @param from vertex from
+		 * @param target vertex to
+		 */
+		void _linkIncoming(size_t from, Vertex& target)
+		{
+			if(_tracksIncoming())
+			{
+				target.incomingEdges.push_back(from);
+			}
+		}
+
+		/**
+		 * Removes edge from incoming index of its end vertex
+		 * @param from vertex from
+		 * @param target vertex to
+		 */
+		void _unlinkIncoming(size_t from, Vertex& target)
+		{
+			auto& incoming = target.incomingEdges;
+			auto it = std::find(incoming.begin(), incoming.end(), from);
+			if(it != incoming.end())
+			{
+				*it = incoming.back();
+				incoming.pop_back();
+			}
+		}
+
+		/**
+		 * Rebuilds incoming index from outgoing edges of all vertices
+		 */
+		void _rebuildIncomingIndex()
+		{
+			// Vertices are iterated read-only, so copy-on-write storage clones only modified ones
+			auto& mutableVertices = vertices.mutate();
+			const vertexMap& constVertices = mutableVertices;
+			for(auto& v : constVertices)
+			{
+				if(!v.second->incomingEdges.empty())
+				{
+					mutableVertices.find(v.first)->second.mutate().incomingEdges.clear();
+				}
+			}
+
+			if(!_tracksIncoming())
+			{
+				return;
+			}
+
+			for(auto& v : constVertices)
+			{
+				for(auto& e : v.second->outgoingEdges)
+				{
+					mutableVertices.find(e.first)->second.mutate().incomingEdges.push_back(v.first);
+				}
+			}
+		}
+
+		/**
+		 * Erases edge from adjacency and releases its value, vertex is modified only if it has the edge
+		 * (mirror of undirected edge must be erased without releasing)
+		 * @param from holder of vertex from
+		 * @param to vertex to
+		 * @return number of erased edges - 0 or 1
+		 */
+		size_t _eraseEdge(vertexHolder& from, size_t to)
+		{
+			if(vertexHolder::copy_on_write && from->outgoingEdges.find(to) == from->outgoingEdges.end())
+			{
+				return 0;
+			}
+
+			auto& edges = from.mutate().outgoingEdges;
+			auto edge = edges.find(to);
+			if(edge == edges.end())
+			{
+				return 0;
+			}
+			edgeStore.mutate().release(edge->second);
+			edges.erase(edge);
+			return 1;
+		}
+
+		/**
+		 * Finds value of edge for modification - with copy-on-write storage only the part holding
+		 * the value is cloned (edge store for shared values, vertex from for inline ones)
+		 * @param from vertex from
+		 * @param to vertex to
+		 * @return pointer to value, nullptr if edge does not exist
+		 */
+		E* _findEdgeValue(size_t from, size_t to)
+		{
+			return _findEdgeValue(from, to, std::integral_constant<bool, edgeStore_t::shared>());
+		}
+
+		E* _findEdgeValue(size_t from, size_t to, std::true_type)
+		{
+			auto vertex_from = vertices->find(from);
+			if(vertex_from == vertices->end())
+			{
+				return nullptr;
+			}
+			auto edge = vertex_from->second->outgoingEdges.find(to);
+			return edge == vertex_from->second->outgoingEdges.end() ? nullptr : &edgeStore.mutate().value(edge->second);
+		}
+
+		E* _findEdgeValue(size_t from, size_t to, std::false_type)
+		{
+			if(vertexHolder::copy_on_write && !adjacent(from, to))
+			{
+				return nullptr;
+			}
+
+			auto& mutableVertices = vertices.mutate();
+			auto vertex_from = mutableVertices.find(from);
+			if(vertex_from == mutableVertices.end())
+			{
+				return nullptr;
+			}
+			auto& edges = vertex_from->second.mutate().outgoingEdges;
+			auto edge = edges.find(to);
+			return edge == edges.end() ? nullptr : &edgeStore.mutate().value(edge->second);
+		}
+
+		/**
+		 * Sets value of existing edge (both directions of undirected edge)
+		 * @param from vertex from
+		 * @param to vertex to
+		 * @param value new value of edge
+		 * @return true if edge was found and updated, false otherwise
+		 */
+		bool _setEdgeValue(size_t from, size_t to, E value)
+		{
+			E* valueFrom = _findEdgeValue(from, to);
+			if(valueFrom == nullptr)
+			{
+				return false;
+			}
+
+			_journalEdgeValue('u', from, to, value);
+			// Shared value of undirected edge is written once
+			if(directed || edgeStore_t::shared)
+			{
+				*valueFrom = std::move(value);
+			}
+			else
+			{
+				*valueFrom = value;
+				*_findEdgeValue(to, from) = std::move(value);
+			}
+			return true;
+		}
+
+		/**
+		 * Adds vertex with given id (used by journal replay, so that ids are the same as when recorded)
+		 * @param id id of vertex, vertex with this id must not be in graph
+		 * @param value value of vertex
+		 */
+		void _addVertexWithId(size_t id, V value)
+		{
+			vertices.mutate().emplace(id, vertexHolder(Vertex(id, std::move(value), _nodeAllocator())));
+			if(id >= total_id)
+			{
+				total_id = id + 1;
+			}
 		}
 
-		bool operator!=(const Unweight&) const
+		/**
+		 * Records mutation of vertex to journal (if it is open) in format "op id"
+		 */
+		void _journalVertex(char op, size_t id)
 		{
-			return false;
+			if(journal.isOpen())
+			{
+				journal.record() << op << ' ' << id << '\n';
+				journal.commit();
+			}
 		}
-	};
-
-	/**
-	 * Classes declarations
-	 */
-	template<typename V, typename E>
-	class GraphBase;
 
-	template<typename V, typename E = Unweight>
-	class Graph;
-
-	template<typename U>
-	class Graph<U, Unweight>;
+		/**
+		 * Records counter of fresh ids to journal (if it is open) before its first added vertex,
+		 * so that replay can reject ids which graph could not have handed out
+		 * @param counter counter of fresh ids before vertex was added
+		 */
+		void _journalCounter(size_t counter)
+		{
+			if(journal.isOpen() && journal.markCounter())
+			{
+				_journalVertex('n', counter);
+			}
+		}
 
-	/**
-	 * Base Graph class
-	 */
-	template<typename V, typename E>
-	class GraphBase
-	{
-	protected:
 		/**
-		 * Vertex struct
-		 * 
-		 * Just simple "value-holder" which is visible only to GraphBase and derived classes
+		 * Records mutation of vertex to journal (if it is open) in format "op id value"
 		 */
-		struct Vertex
+		void _journalVertexValue(char op, size_t id, const V& value)
 		{
-			size_t id;
-			V value;
-			std::map<size_t, E> outgoingEdges;
-	
-			Vertex(size_t id, V value)
-				:id(id), value(value)
-			{}
-			
-			bool operator==(const Vertex& rhs) const
+			if(journal.isOpen())
 			{
-				return value == rhs.value &&
-					id == rhs.id &&
-					outgoingEdges == rhs.outgoingEdges;
+				journal.record() << op << ' ' << id << ' ';
+				helper::writeTextValue(journal.record(), value);
+				journal.record() << '\n';
+				journal.commit();
 			}
-	
-			bool operator!=(const Vertex& rhs) const
+		}
+
+		/**
+		 * Records mutation of edge to journal (if it is open) in format "op from to"
+		 */
+		void _journalEdge(char op, size_t from, size_t to)
+		{
+			if(journal.isOpen())
 			{
-				return !(*this == rhs);
+				journal.record() << op << ' ' << from << ' ' << to << '\n';
+				journal.commit();
 			}
-		};
+		}
 
-		using vertexMap = std::map<size_t, Vertex >;
+		/**
+		 * Records mutation of edge to journal (if it is open) in format "op from to value"
+		 * @param commit false when more records follow (batch is committed at once)
+		 */
+		void _journalEdgeValue(char op, size_t from, size_t to, const E& value, bool commit = true)
+		{
+			if(journal.isOpen())
+			{
+				journal.record() << op << ' ' << from << ' ' << to;
+				if(!std::is_same<E, Unweight>::value)
+				{
+					journal.record() << ' ';
+					helper::writeTextValue(journal.record(), value);
+				}
+				journal.record() << '\n';
+				if(commit)
+				{
+					journal.commit();
+				}
+			}
+		}
 
-		const bool directed;
-		vertexMap vertices;
-		size_t total_id = 0;
+		/**
+		 * Saves graph to file through temporary file, which then replaces it, so file is never left half written
+		 *
+		 * Target file is never removed - if rename fails (e.g. on platforms where it does not replace
+		 * existing file), target keeps its previous content and complete snapshot stays in filePath + ".tmp".
+		 * @param graph graph to be saved
+		 * @param filePath path to file
+		 * @return true if save was successful, false otherwise
+		 */
+		static bool _saveToFileAtomic(const Graph<V,E,S>& graph, const std::string& filePath)
+		{
+			std::string tempPath = filePath + ".tmp";
+			if(!graph.saveToFile(tempPath))
+			{
+				std::remove(tempPath.c_str());
+				return false;
+			}
+			return std::rename(tempPath.c_str(), filePath.c_str()) == 0;
+		}
 
 		/**
-		* Orientation constructor
-		* @param directed true for directed, false undirected
-		*/
-		GraphBase(bool directed = true)
-			:directed(directed)
-		{}
+		 * Inserts edge read from file, mirror of undirected edge which is already loaded shares its value
+		 * @param vertex vertex from
+		 * @param target vertex to
+		 * @param value value of edge
+		 */
+		void _loadEdge(Vertex& vertex, size_t target, E value)
+		{
+			if(edgeStore_t::shared && !directed)
+			{
+				auto targetVertex = vertices->find(target);
+				if(targetVertex != vertices->end())
+				{
+					auto mirror = targetVertex->second->outgoingEdges.find(vertex.id);
+					if(mirror != targetVertex->second->outgoingEdges.end())
+					{
+						vertex.outgoingEdges.emplace(target, edgeStore->mirror(mirror->second));
+						return;
+					}
+				}
+			}
 
-		GraphBase(const GraphBase&) = default;
-		
-		GraphBase(GraphBase&&) = default;
+			auto entry = edgeStore.mutate().create(std::move(value));
+			if(!vertex.outgoingEdges.emplace(target, entry).second)
+			{
+				edgeStore.mutate().release(entry);
+			}
+		}
 
-		GraphBase& operator=(const GraphBase& rhs)
+		/**
+		 * Stages batch of edges for _insertStagedEdges, edges with invalid endpoints are skipped
+		 * @param begin iterator to first edge
+		 * @param end iterator behind last edge
+		 * @param f function returning value of edge (from tuple-like element of batch)
+		 * @return staged edges in format {from, to, entry} (mirrors of undirected edges included)
+		 */
+		template<typename Iterator, typename Func>
+		std::vector<std::tuple<size_t, size_t, edgeEntry>> _stageEdges(Iterator begin, Iterator end, Func f)
 		{
-			if(directed != rhs.directed)
+			std::vector<std::tuple<size_t, size_t, edgeEntry>> staged;
+			for(auto it = begin; it != end; ++it)
 			{
-				throw std::invalid_argument("Graphs' orientation must be equal.");
+				size_t from = std::get<0>(*it);
+				size_t to = std::get<1>(*it);
+				if(vertices->find(from) == vertices->end() || vertices->find(to) == vertices->end())
+				{
+					continue;
+				}
+
+				staged.emplace_back(from, to, edgeStore.mutate().create(f(*it)));
+				if(!directed && from != to)
+				{
+					staged.emplace_back(to, from, edgeStore->mirror(std::get<2>(staged.back())));
+				}
 			}
-			
-			vertices = rhs.vertices;
-			total_id = rhs.total_id;
-			
-			return *this;
+			return staged;
 		}
-		
-		GraphBase& operator=(GraphBase&& rhs)
+
+		/**
+		 * Inserts staged edges - sorts them by source and target and merges them into
+		 * adjacency of each source vertex at once. Duplicates keep the first value
+		 * (already existing edges are kept as well), which is the same as calling addEdge repeatedly.
+		 * @param staged edges in format {from, to, entry} with valid endpoints (mirrors of undirected edges included)
+		 * @return number of inserted edges
+		 */
+		size_t _insertStagedEdges(std::vector<std::tuple<size_t, size_t, edgeEntry>>& staged)
 		{
-			if(directed != rhs.directed)
+			std::stable_sort(staged.begin(), staged.end(), [](const auto& a, const auto& b)
 			{
-				throw std::invalid_argument("Graphs' orientation must be equal.");
+				return std::get<0>(a) < std::get<0>(b) || (std::get<0>(a) == std::get<0>(b) && std::get<1>(a) < std::get<1>(b));
+			});
+
+			size_t inserted = 0;
+			// Inserted edges are recorded to journal after merge, when their values are in place
+			std::vector<std::pair<size_t, size_t>> journaled;
+			auto it = staged.begin();
+			while(it != staged.end())
+			{
+				size_t from = std::get<0>(*it);
+				auto groupEnd = it;
+				while(groupEnd != staged.end() && std::get<0>(*groupEnd) == from)
+				{
+					++groupEnd;
+				}
+
+				auto& mutableVertices = vertices.mutate();
+				helper::mergeSortedEdges(mutableVertices.find(from)->second.mutate().outgoingEdges, it, groupEnd, [&, this](size_t to)
+				{
+					inserted += (directed || from <= to) ? 1 : 0;
+					if(journal.isOpen() && (directed || from <= to))
+					{
+						journaled.emplace_back(from, to);
+					}
+					if(_tracksIncoming())
+					{
+						_linkIncoming(from, mutableVertices.find(to)->second.mutate());
+					}
+				},
+				[&, this](size_t to, edgeEntry& entry)
+				{
+					// Mirrored entries are released once
+					if(directed || from <= to)
+					{
+						edgeStore.mutate().release(entry);
+					}
+				});
+				it = groupEnd;
 			}
-			
-			vertices = std::move(rhs.vertices);
-			total_id = std::move(rhs.total_id);
-			
-			return *this;
+
+			for(const auto& edge : journaled)
+			{
+				const auto& edges = vertices->find(edge.first)->second->outgoingEdges;
+				_journalEdgeValue('e', edge.first, edge.second, edgeStore->value(edges.find(edge.second)->second), false);
+			}
+			if(!journaled.empty())
+			{
+				journal.commit();
+			}
+			return inserted;
 		}
 
 		/**
 		 * Method providing core saving functionality
 		 * @param filePath path to file
-		 * @param f function to be called on output file and edge
+		 * @param f function to be called on output file and edge value
 		 * @param fv function to be called on output file and vertex
 		 * @return true if save was successful, false otherwise
 		 */
@@ -131,23 +991,25 @@ namespace Graph
 
 			if(outputFile.is_open())
 			{
-				for(const auto& v : vertices)
+				for(const auto& v : *vertices)
 				{
-					outputFile << "id " << v.second.id << " ";
+					outputFile << "id " << v.second->id << " ";
 					fv(outputFile, v);
-					outputFile << std::endl;
+					outputFile << '\n';
 
-					for(const auto& e : v.second.outgoingEdges)
+					for(const auto& e : v.second->outgoingEdges)
 					{
 						outputFile << e.first;
 
-						f(outputFile, e);
+						f(outputFile, edgeStore->value(e.second));
 
-						outputFile << std::endl;
+						outputFile << '\n';
 					}
 				}
 
-				return true;
+				// Failed write (e.g. full disk) must not be reported as successful save
+				outputFile.close();
+				return !outputFile.fail();
 			}
 
 			return false;
@@ -165,7 +1027,7 @@ namespace Graph
 		{
 			return _saveToFileBase(filePath, f, [](auto& outputFile, auto& v)
 			{
-				outputFile << v.second.value;
+				outputFile << v.second->value;
 			});
 		}
 
@@ -181,7 +1043,7 @@ namespace Graph
 		{
 			return _saveToFileBase(filePath, f, [](auto& outputFile, auto& v)
 			{
-				outputFile << "\"" << v.second.value << "\"";
+				outputFile << "\"" << v.second->value << "\"";
 			});
 		}
 
@@ -189,7 +1051,7 @@ namespace Graph
 		 * Basic method for loading graph from file
 		 * @param filePath path to file
 		 * @param isWeighted true if graph is weighted
-		 * @param f func which will be applied to stringstream and target id
+		 * @param f func which will be applied to stringstream, source vertex and target id
 		 * @param fv func which will be applied to stringstream and vertex value
 		 * @return true if loading from file was successful
 		 */
@@ -198,10 +1060,15 @@ namespace Graph
 		{
 			static_assert(std::is_default_constructible<V>::value, "Vertex type must be default constructible.");
 			
-			vertices.clear();
+			// Fresh containers are used, so that content shared with copies is not cloned
+			vertices = _makeVertexMap();
+			edgeStore = edgeStoreHolder();
+			auto& loaded = vertices.mutate();
 			std::ifstream inputFile(filePath);
 			std::string line;
 			bool retValue = false;
+			// Vertex whose edges are being read
+			auto current = loaded.end();
 
 			if(inputFile.is_open())
 			{
@@ -234,16 +1101,16 @@ namespace Graph
 
 						fv(ss, vertValue);
 
-						vertices.emplace(vertId, Vertex(vertId, std::move(vertValue)));
+						current = loaded.emplace(vertId, vertexHolder(Vertex(vertId, std::move(vertValue), _nodeAllocator()))).first;
 
-						if(vertId > total_id)
+						if(vertId >= total_id)
 						{
-							total_id = vertId;
+							total_id = vertId + 1;
 						}
 					}
 					else
 					{
-						if((isWeighted && line.size() < 3) || (!isWeighted && line.size() < 1))
+						if((isWeighted && line.size() < 3) || (!isWeighted && line.size() < 1) || current == loaded.end())
 						{
 							retValue = false;
 							break;
@@ -260,7 +1127,7 @@ namespace Graph
 							break;
 						}
 
-						f(ss, targetId);
+						f(ss, current->second.mutate(), targetId);
 					}
 
 					ss.flush();
@@ -269,7 +1136,12 @@ namespace Graph
 
 			if(!retValue)
 			{
-				vertices.clear();
+				loaded.clear();
+				edgeStore.mutate().clear();
+			}
+			else if(_tracksIncoming())
+			{
+				_rebuildIncomingIndex();
 			}
 
 			return retValue;
@@ -279,7 +1151,7 @@ namespace Graph
 		 * Loads graph from file (SFINAE helps to choose correct type of loading method)
 		 * @param filePath path to file
 		 * @param isWeighted true if graph is weighted
-		 * @param f func taking stringstream and index of end vertex as params and performs operation on those
+		 * @param f func taking stringstream, source vertex and index of end vertex as params and performs operation on those
 		 */
 		template<typename Func, typename TV = V>
 		typename std::enable_if_t<!std::is_same<TV, std::string>::value, bool>
@@ -295,118 +1167,353 @@ namespace Graph
 		 * Loads graph from file (SFINAE helps to choose correct type of loading method)
 		 * @param filePath path to file
 		 * @param isWeighted true if graph is weighted
-		 * @param f func taking stringstream and index of end vertex as params and performs operation on those
+		 * @param f func taking stringstream, source vertex and index of end vertex as params and performs operation on those
+		 */
+		template<typename Func, typename TV = V>
+		typename std::enable_if_t<std::is_same<TV, std::string>::value, bool>
+		_loadFromFile(const std::string& filePath, bool isWeighted, Func f)
+		{
+			return _loadFromFileBase(filePath, isWeighted, f, [](auto& ss, auto& v)
+			{
+				std::string result;
+				getline(ss, result);
+
+				size_t quotePos = result.find_first_of('"');
+				size_t quotePosEnd = result.find_last_of('"');
+				if(quotePos != std::string::npos && quotePosEnd != quotePos)
+				{
+					v = result.substr(quotePos + 1, quotePosEnd - quotePos - 1);
+				}
+			});
+		}
+
+		/**
+		 * Vertices and edges parsed from one chunk of text file
+		 */
+		struct _ParsedChunk
+		{
+			std::vector<std::pair<size_t, V>> vertices;
+			// Position in edges behind last edge of each vertex
+			std::vector<size_t> edgesEnd;
+			// Edges at the start of chunk belong to vertex from previous chunk
+			size_t leadingEdges = 0;
+			bool startsWithEdges = false;
+			std::vector<std::pair<size_t, E>> edges;
+			bool valid = true;
+		};
+
+		/**
+		 * Parses lines of text format in [first, last), last line may end without new line
+		 * @param first begin of chunk (start of line)
+		 * @param last end of chunk (behind new line)
+		 * @return parsed chunk, valid is false if some line is malformed
+		 */
+		static _ParsedChunk _parseChunk(const char* first, const char* last)
+		{
+			const bool isWeighted = !std::is_same<E, Unweight>::value;
+			_ParsedChunk chunk;
+
+			for(const char* line = first; line != last; )
+			{
+				const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', size_t(last - line)));
+				const char* next = lineEnd ? lineEnd + 1 : last;
+				if(!lineEnd)
+				{
+					lineEnd = last;
+				}
+				if(lineEnd != line && lineEnd[-1] == '\r')
+				{
+					--lineEnd;
+				}
+
+				const char* pos = line;
+				size_t id;
+				if(lineEnd - line >= 3 && std::memcmp(line, "id ", 3) == 0)
+				{
+					pos += 3;
+					// Id is followed by one separator and value
+					if(!helper::parseTextId(pos, lineEnd, id) || pos == lineEnd)
+					{
+						chunk.valid = false;
+						break;
+					}
+					V value = V();
+					helper::parseTextVertexValue(pos + 1, lineEnd, value);
+					chunk.vertices.emplace_back(id, std::move(value));
+					chunk.edgesEnd.push_back(chunk.edges.size());
+				}
+				else
+				{
+					if(!helper::parseTextId(pos, lineEnd, id) || (isWeighted && pos == lineEnd))
+					{
+						chunk.valid = false;
+						break;
+					}
+					chunk.startsWithEdges |= chunk.vertices.empty();
+					E value = E();
+					if(!isWeighted || helper::parseTextEdgeValue(pos + 1, lineEnd, value))
+					{
+						chunk.edges.emplace_back(id, std::move(value));
+						if(chunk.vertices.empty())
+						{
+							++chunk.leadingEdges;
+						}
+						else
+						{
+							chunk.edgesEnd.back() = chunk.edges.size();
+						}
+					}
+				}
+				line = next;
+			}
+			return chunk;
+		}
+
+		/**
+		 * Loading method reading file in large blocks, which are split to chunks parsed in parallel;
+		 * parsed vertices and edges are then inserted in order of file
+		 * @param filePath path to file
+		 * @param threads count of parsing threads, 0 = hardware concurrency
+		 * @return true if loading from file was successful
+		 */
+		bool _loadFromFileParallel(const std::string& filePath, size_t threads)
+		{
+			static_assert(std::is_default_constructible<V>::value, "Vertex type must be default constructible.");
+			static_assert(std::is_default_constructible<E>::value, "Edge type must be default constructible.");
+
+			if(threads == 0)
+			{
+				threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+			}
+			const size_t chunkSize = size_t(1) << 22;
+			const size_t blockSize = chunkSize * threads;
+
+			// Fresh containers are used, so that content shared with copies is not cloned
+			vertices = _makeVertexMap();
+			edgeStore = edgeStoreHolder();
+			auto& loaded = vertices.mutate();
+			std::ifstream inputFile(filePath, std::ios::binary);
+			bool retValue = inputFile.is_open();
+			// Vertex whose edges are being read
+			auto current = loaded.end();
+			std::string buffer;
+
+			while(retValue)
+			{
+				size_t carried = buffer.size();
+				buffer.resize(carried + blockSize);
+				inputFile.read(&buffer[carried], std::streamsize(blockSize));
+				buffer.resize(carried + size_t(inputFile.gcount()));
+				bool lastBlock = !inputFile;
+
+				// Only whole lines are parsed, rest of last line is carried to next block
+				size_t parsedSize = lastBlock ? buffer.size() : buffer.rfind('\n') + 1;
+				if(parsedSize == 0 && !lastBlock)
+				{
+					continue;
+				}
+
+				// Chunks start at line boundaries
+				const char* data = buffer.data();
+				std::vector<const char*> bounds{ data };
+				for(size_t i = 1; i < threads; ++i)
+				{
+					const char* bound = std::max(data + parsedSize * i / threads, bounds.back());
+					const char* newLine = static_cast<const char*>(std::memchr(bound, '\n', size_t(data + parsedSize - bound)));
+					bounds.push_back(newLine ? newLine + 1 : data + parsedSize);
+				}
+				bounds.push_back(data + parsedSize);
+
+				std::vector<std::future<_ParsedChunk>> parsing;
+				for(size_t i = 1; i < threads; ++i)
+				{
+					parsing.push_back(std::async(std::launch::async, &GraphBase::_parseChunk, bounds[i], bounds[i + 1]));
+				}
+				std::vector<_ParsedChunk> chunks;
+				chunks.push_back(_parseChunk(bounds[0], bounds[1]));
+				for(auto& chunk : parsing)
+				{
+					chunks.push_back(chunk.get());
+				}
+
+				for(auto& chunk : chunks)
+				{
+					if(!chunk.valid || (chunk.startsWithEdges && current == loaded.end()))
+					{
+						retValue = false;
+						break;
+					}
+
+					size_t edge = 0;
+					for(size_t i = 0; i <= chunk.vertices.size(); ++i)
+					{
+						size_t edgesEnd = i == 0 ? chunk.leadingEdges : chunk.edgesEnd[i - 1];
+						for(; edge < edgesEnd; ++edge)
+						{
+							_loadEdge(current->second.mutate(), chunk.edges[edge].first, std::move(chunk.edges[edge].second));
+						}
+						if(i == chunk.vertices.size())
+						{
+							break;
+						}
+
+						size_t vertId = chunk.vertices[i].first;
+						current = loaded.emplace(vertId, vertexHolder(Vertex(vertId, std::move(chunk.vertices[i].second), _nodeAllocator()))).first;
+						if(vertId >= total_id)
+						{
+							total_id = vertId + 1;
+						}
+					}
+				}
+
+				buffer.erase(0, parsedSize);
+				if(lastBlock)
+				{
+					break;
+				}
+			}
+
+			if(!retValue)
+			{
+				loaded.clear();
+				edgeStore.mutate().clear();
+			}
+			else if(_tracksIncoming())
+			{
+				_rebuildIncomingIndex();
+			}
+
+			return retValue;
+		}
+
+		/**
+		 * Set of edges highlighted in dot export
+		 */
+		using _EdgeSet = std::unordered_set<std::pair<size_t, size_t>, helper::EdgeHash>;
+
+		/**
+		 * Creates set of edges between consecutive vertices of path (both directions for undirected graph)
+		 * @param path ids of vertices
+		 * @return set of edges
+		 */
+		_EdgeSet _pathEdges(const std::vector<size_t>& path) const
+		{
+			_EdgeSet result;
+			for(size_t i = 1; i < path.size(); ++i)
+			{
+				result.emplace(path[i - 1], path[i]);
+				if(!directed)
+				{
+					result.emplace(path[i], path[i - 1]);
+				}
+			}
+			return result;
+		}
+
+		/**
+		 * Creates set of given edges (both directions for undirected graph)
+		 * @param edges pairs of ids of vertices
+		 * @return set of edges
 		 */
-		template<typename Func, typename TV = V>
-		typename std::enable_if_t<std::is_same<TV, std::string>::value, bool>
-		_loadFromFile(const std::string& filePath, bool isWeighted, Func f)
+		_EdgeSet _edgeSet(const std::vector<std::pair<size_t, size_t>>& edges) const
 		{
-			return _loadFromFileBase(filePath, isWeighted, f, [](auto& ss, auto& v)
+			_EdgeSet result(edges.begin(), edges.end());
+			if(!directed)
 			{
-				std::string result;
-				getline(ss, result);
-
-				size_t quotePos = result.find_first_of('"');
-				size_t quotePosEnd = result.find_last_of('"');
-				if(quotePos != std::string::npos && quotePosEnd != quotePos)
+				for(const auto& edge : edges)
 				{
-					v = result.substr(quotePos + 1, quotePosEnd - quotePos - 1);
+					result.emplace(edge.second, edge.first);
 				}
-			});
+			}
+			return result;
 		}
 
 		/**
-		 * Base method for exporting graph to dot format
+		 * Opens file with large output buffer and exports graph to it
 		 * @param filePath path to output file
-		 * @param f function gets ofstream and edge value as params and (possibly) modifies them
+		 * @param f function exporting graph to given ostream, returns true if export was successful
 		 * @return true if export was successful
 		 */
 		template<typename Func>
-		bool _exportToDot(const std::string& filePath, Func f) const
+		bool _exportToFile(const std::string& filePath, Func f) const
 		{
-			std::ofstream outputFile(filePath);
-			std::vector<std::pair<size_t, size_t>> exportedPairs;
+			// Buffer has to be set before file is opened and outlive the stream
+			std::vector<char> buffer(size_t(1) << 20);
+			std::ofstream outputFile;
+			outputFile.rdbuf()->pubsetbuf(buffer.data(), std::streamsize(buffer.size()));
+			outputFile.open(filePath);
 
 			if(!outputFile.is_open())
 			{
 				return false;
 			}
 
-			outputFile << (directed ? "digraph {" : "graph {") << std::endl;
+			bool result = f(outputFile);
+			outputFile.close();
+			return result && !outputFile.fail();
+		}
+
+		/**
+		 * Base method for exporting graph to dot format
+		 * @param outputFile output stream
+		 * @param f function gets ostream, edge value, start and end vertex as params and writes attributes of edge
+		 * @return true if export was successful
+		 */
+		template<typename Func>
+		bool _exportToDot(std::ostream& outputFile, Func f) const
+		{
+			outputFile << (directed ? "digraph {" : "graph {") << '\n';
 
 			// First we create labels and output them to file
 			// Loop is seperate from the one below to have all labels defined at the start
-			for(auto& v : vertices)
+			for(auto& v : *vertices)
 			{
-				outputFile << v.second.id << " [label=\"";
-
-				std::stringstream ss;
-				ss << v.second.value;
-
-				outputFile << ss.str();
-
-				ss.flush();
-
-				outputFile << "\"];" << std::endl;
+				outputFile << v.second->id << " [label=\"" << v.second->value << "\"];\n";
 			}
 
-			// Now we create edges between vertices
-			for(auto& v : vertices)
+			// Now we create edges between vertices, vertices are ordered by id,
+			// so undirected edge is exported when it is reached from its lower end
+			const char* connector = directed ? " -> " : " -- ";
+			for(auto& v : *vertices)
 			{
-				for(auto& e : v.second.outgoingEdges)
+				for(auto& e : v.second->outgoingEdges)
 				{
-					if(directed)
-					{
-						outputFile << v.second.id << " -> " << e.first;
-
-						f(outputFile, e.second, v.second.id, e.first);
-
-						outputFile << ";" << std::endl;
-					}
-					else
+					if(directed || v.first <= e.first)
 					{
-						if(std::find(exportedPairs.begin(), exportedPairs.end(), std::make_pair(e.first, v.second.id)) == exportedPairs.end())
-						{
-							outputFile << v.second.id << " -- " << e.first;
+						outputFile << v.second->id << connector << e.first;
 
-							f(outputFile, e.second, v.second.id, e.first);
+						f(outputFile, edgeStore->value(e.second), v.second->id, e.first);
 
-							exportedPairs.emplace_back(v.second.id, e.first);
-							outputFile << ";" << std::endl;
-						}
+						outputFile << ";\n";
 					}
 				}
 			}
 
 			outputFile << "}";
 
-			return true;
+			return !outputFile.fail();
 		}
-		
+
 		/**
 		 * Base method for returning vector of edges positions (and values)
 		 * @param includeUndirEdgesTwice if true, each edge of undirected graph will be included twice
-		 * @param f function to be applied to result vector, current vertex and current edge
+		 * @param f function to be applied to result vector, source vertex id, end vertex id and edge value
 		 * @return resulting vector
 		 */
 		template<typename T, typename Func>
 		std::vector<T> _getEdgesPositionsBase(bool includeUndirEdgesTwice, Func f) const
 		{
 			std::vector<T> result;
-			std::set<size_t> verIn;
-			for (auto& vert : vertices)
+			for (auto& vert : *vertices)
 			{
-				verIn.insert(vert.first);
-				for(auto& edge : vert.second.outgoingEdges)
+				for(auto& edge : vert.second->outgoingEdges)
 				{
-					if(!includeUndirEdgesTwice && !directed)
+					// Undirected edge is reported from its endpoint with lower id
+					if(!includeUndirEdgesTwice && !directed && edge.first < vert.first)
 					{
-						if ((vert.first != edge.first) && (verIn.find(edge.first) != verIn.end()))
-						{
-							continue;
-						}
+						continue;
 					}
-					f(result, vert, edge);
+					f(result, vert.first, edge.first, edgeStore->value(edge.second));
 				}
 			}
 			return result;
@@ -417,7 +1524,10 @@ namespace Graph
 		* Destructor
 		*/
 		virtual ~GraphBase()
-		{}
+		{
+			// The last owner of arena frees its chunks at once, single nodes are not returned to it
+			arena.release();
+		}
 		
 		/**
 		 * Add vertex
@@ -426,8 +1536,12 @@ namespace Graph
 		 */
 		size_t addVertex(V value)
 		{
-			auto toReturn = vertices.emplace(total_id, Vertex(total_id, std::move(value)));
-			total_id++;
+			auto& mutableVertices = vertices.mutate();
+			size_t counter = total_id;
+			size_t id = helper::acquireVertexId(mutableVertices, total_id);
+			auto toReturn = mutableVertices.emplace(id, vertexHolder(Vertex(id, std::move(value), _nodeAllocator())));
+			_journalCounter(counter);
+			_journalVertexValue('v', id, toReturn.first->second->value);
 			return toReturn.first->first;
 		}
 
@@ -437,7 +1551,7 @@ namespace Graph
 		 */
 		size_t getVerticesCount() const
 		{
-			return vertices.size();
+			return vertices->size();
 		}
 
 		/**
@@ -457,9 +1571,9 @@ namespace Graph
 		std::vector<std::pair<size_t, size_t>> getEdgesPositions(bool includeUndirEdgesTwice = false) const
 		{
 			return _getEdgesPositionsBase<std::pair<size_t, size_t>>(includeUndirEdgesTwice, 
-			[](auto& result, const auto& vert, const auto& edge)
+			[](auto& result, size_t from, size_t to, const E&)
 			{
-				result.emplace_back(vert.first, edge.first);
+				result.emplace_back(from, to);
 			});
 		}
 
@@ -471,9 +1585,9 @@ namespace Graph
 		std::vector<std::tuple<size_t, size_t, E>> getEdgesPositionsAndValues(bool includeUndirEdgesTwice = false) const
 		{
 			return _getEdgesPositionsBase<std::tuple<size_t, size_t, E>>(includeUndirEdgesTwice, 
-			[](auto& result, const auto& vert, const auto& edge)
+			[](auto& result, size_t from, size_t to, const E& value)
 			{
-				result.emplace_back(vert.first, edge.first, edge.second);
+				result.emplace_back(from, to, value);
 			});
 		}
 
@@ -484,12 +1598,34 @@ namespace Graph
 		 */
 		std::map<size_t, E> getEdgesFrom(size_t source) const
 		{
-			auto is_in = vertices.find(source);
-			if (is_in == vertices.end())
+			auto is_in = vertices->find(source);
+			if (is_in == vertices->end())
+			{
+				throw std::invalid_argument("vertex id not found");
+			}
+			std::map<size_t, E> result;
+			for (auto& e : is_in->second->outgoingEdges)
+			{
+				result.emplace_hint(result.end(), e.first, edgeStore->value(e.second));
+			}
+			return result;
+		}
+
+		/**
+		 * Get view of edges from vertex (no copy is made)
+		 * @param source
+		 * @throws invalid_argument exception if id is invalid
+		 * @return view of edges, iterating gives pairs of <target id, reference to edge value>
+		 */
+		EdgesView getEdgesFromView(size_t source) const
+		{
+			auto is_in = vertices->find(source);
+			if (is_in == vertices->end())
 			{
 				throw std::invalid_argument("vertex id not found");
 			}
-			return vertices.find(source)->second.outgoingEdges;
+			const auto& edges = is_in->second->outgoingEdges;
+			return EdgesView(typename EdgesView::iterator(edges.begin(), *edgeStore), typename EdgesView::iterator(edges.end(), *edgeStore), edges.size());
 		}
 
 		/**
@@ -499,9 +1635,9 @@ namespace Graph
 		std::vector<size_t> getVerticesIds() const
 		{
 			std::vector<size_t> result;
-			result.reserve(vertices.size());
+			result.reserve(vertices->size());
 			
-			for(auto& vert : vertices)
+			for(auto& vert : *vertices)
 			{
 				result.emplace_back(vert.first);
 			}
@@ -509,6 +1645,16 @@ namespace Graph
 			return result;
 		}
 
+		/**
+		 * Checks if vertex is part of graph
+		 * @param vertex id of vertex
+		 * @return true if graph contains vertex, false otherwise
+		 */
+		bool hasVertex(size_t vertex) const
+		{
+			return vertices->find(vertex) != vertices->end();
+		}
+
 		/**
 		 * Get value of given vertex
 		 * @param vertex id of vertex
@@ -517,12 +1663,12 @@ namespace Graph
 		 */
 		const V& getVertexValue(size_t vertex) const
 		{
-			auto is_in = vertices.find(vertex);
-			if (is_in == vertices.end())
+			auto is_in = vertices->find(vertex);
+			if (is_in == vertices->end())
 			{
 				throw std::invalid_argument("vertex id not found");
 			}
-			return vertices.find(vertex)->second.value;
+			return vertices->find(vertex)->second->value;
 		}
 		
 		/**
@@ -532,10 +1678,10 @@ namespace Graph
 		*/
 		bool setVertexValue(size_t vertex, V value)
 		{
-			auto is_in = vertices.find(vertex);
-			if (is_in != vertices.end())
+			if (vertices->find(vertex) != vertices->end())
 			{
-				is_in->second.value = std::move(value);
+				_journalVertexValue('s', vertex, value);
+				vertices.mutate().find(vertex)->second.mutate().value = std::move(value);
 				return true;
 			}
 			return false;
@@ -548,79 +1694,532 @@ namespace Graph
 		*/
 		size_t removeVertex(size_t vertex)
 		{
-			for (auto & i : vertices)
-			{
-				i.second.outgoingEdges.erase(vertex);
-			}
-			return vertices.erase(vertex);
+			if (vertices->find(vertex) == vertices->end())
+			{
+				return 0;
+			}
+
+			_journalVertex('x', vertex);
+			// Removed vertex itself is only read, other vertices are modified
+			auto& mutableVertices = vertices.mutate();
+			auto vertex_found = mutableVertices.find(vertex);
+
+			if (!directed)
+			{
+				// Neighbours are the only vertices with edges leading to removed one
+				for (auto & e : vertex_found->second->outgoingEdges)
+				{
+					if (e.first != vertex)
+					{
+						mutableVertices.find(e.first)->second.mutate().outgoingEdges.erase(vertex);
+					}
+					edgeStore.mutate().release(e.second);
+				}
+			}
+			else
+			{
+				if (incomingIndex)
+				{
+					for (auto & pred : vertex_found->second->incomingEdges)
+					{
+						_eraseEdge(mutableVertices.find(pred)->second, vertex);
+					}
+					for (auto & e : vertex_found->second->outgoingEdges)
+					{
+						if (e.first != vertex)
+						{
+							_unlinkIncoming(vertex, mutableVertices.find(e.first)->second.mutate());
+						}
+					}
+				}
+				else
+				{
+					const vertexMap& constVertices = mutableVertices;
+					for (auto & i : constVertices)
+					{
+						if (i.second->outgoingEdges.count(vertex))
+						{
+							_eraseEdge(mutableVertices.find(i.first)->second, vertex);
+						}
+					}
+				}
+
+				for (auto & e : vertex_found->second->outgoingEdges)
+				{
+					edgeStore.mutate().release(e.second);
+				}
+			}
+			return mutableVertices.erase(vertex);
+		}
+
+		/**
+		* Remove edge
+		* @param from vertex from
+		* @param to vertex to
+		* @return number edges removed - 0, 1 or 2 (only in case of undirected graph), 0 if either vertex is invalid
+		*/
+		size_t removeEdge(size_t from, size_t to)
+		{
+			if (vertices->find(from) == vertices->end() || vertices->find(to) == vertices->end())
+			{
+				return 0;
+			}
+
+			auto& mutableVertices = vertices.mutate();
+			size_t removed = _eraseEdge(mutableVertices.find(from)->second, to);
+			if (removed)
+			{
+				_journalEdge('r', from, to);
+			}
+			if (removed && _tracksIncoming())
+			{
+				_unlinkIncoming(from, mutableVertices.find(to)->second.mutate());
+			}
+			return removed + ((directed || !removed) ? 0 : mutableVertices.find(to)->second.mutate().outgoingEdges.erase(from));
+		}
+
+		/**
+		* Test adjacency of 2 vertices
+		* @param from vertex from
+		* @param to vertex to
+		* @return true if vertices are adjacent, false if not or if they are invalid
+		*/
+		bool adjacent(size_t from, size_t to) const
+		{
+			bool result = false;
+			auto findfrom = vertices->find(from);
+			if (findfrom != vertices->end())
+			{
+				if (findfrom->second->outgoingEdges.find(to) != findfrom->second->outgoingEdges.end())
+					result = true;
+			}
+			return result;
+		}
+
+		/**
+		* Find neighbours of vertex
+		* @param vertex
+		* @return vector of ids of neighbours, if invalid vertex - empty
+		*/
+		std::vector<size_t> getNeighbours(size_t vertex) const
+		{
+			std::vector<size_t> result;
+			auto vertex_found = vertices->find(vertex);
+			if (vertex_found != vertices->end())
+			{
+				for (auto & v : vertex_found->second->outgoingEdges)
+				{
+					result.push_back(v.first);
+				}
+			}
+			return result;
+		}
+
+		/**
+		* Get view of neighbours of vertex (no copy is made)
+		* @param vertex
+		* @return view of ids of neighbours, if invalid vertex - empty
+		*/
+		NeighboursView getNeighboursView(size_t vertex) const
+		{
+			auto vertex_found = vertices->find(vertex);
+			if (vertex_found == vertices->end())
+			{
+				return NeighboursView();
+			}
+			const auto& edges = vertex_found->second->outgoingEdges;
+			return NeighboursView(typename NeighboursView::iterator(edges.begin()), typename NeighboursView::iterator(edges.end()), edges.size());
+		}
+
+		/**
+		* Enables or disables index of incoming edges (only directed graphs need it)
+		*
+		* With index enabled predecessors are found in O(in-degree) and removeVertex
+		* costs O(in-degree + out-degree) instead of scanning the whole graph.
+		* Enabling builds the index in O(V + E), afterwards it is kept up to date by all modifications.
+		* @param enabled true to enable the index, false to drop it
+		*/
+		void setIncomingIndex(bool enabled)
+		{
+			if (incomingIndex != enabled)
+			{
+				incomingIndex = enabled;
+				_rebuildIncomingIndex();
+			}
+		}
+
+		/**
+		* Checks if index of incoming edges is enabled
+		* @return true if enabled, false otherwise
+		*/
+		bool hasIncomingIndex() const
+		{
+			return incomingIndex;
+		}
+
+		/**
+		* Find predecessors of vertex (vertices with edge leading to it)
+		* Without incoming index the whole directed graph is scanned.
+		* @param vertex
+		* @return vector of ids of predecessors (sorted), if invalid vertex - empty
+		*/
+		std::vector<size_t> getPredecessors(size_t vertex) const
+		{
+			std::vector<size_t> result;
+			auto vertex_found = vertices->find(vertex);
+			if (vertex_found == vertices->end())
+			{
+				return result;
+			}
+
+			if (!directed)
+			{
+				return getNeighbours(vertex);
+			}
+
+			if (incomingIndex)
+			{
+				result = vertex_found->second->incomingEdges;
+				std::sort(result.begin(), result.end());
+			}
+			else
+			{
+				for (auto & v : *vertices)
+				{
+					if (v.second->outgoingEdges.find(vertex) != v.second->outgoingEdges.end())
+					{
+						result.push_back(v.first);
+					}
+				}
+			}
+			return result;
+		}
+
+		/**
+		* Get edges leading to vertex
+		* Without incoming index the whole directed graph is scanned.
+		* @param target
+		* @throws invalid_argument exception if id is invalid
+		* @return edges (key = id of source vertex, value = value of edge)
+		*/
+		std::map<size_t, E> getIncomingEdges(size_t target) const
+		{
+			if (vertices->find(target) == vertices->end())
+			{
+				throw std::invalid_argument("vertex id not found");
+			}
+
+			std::map<size_t, E> result;
+			for (auto & pred : getPredecessors(target))
+			{
+				result.emplace_hint(result.end(), pred, edgeStore->value(vertices->find(pred)->second->outgoingEdges.find(target)->second));
+			}
+			return result;
+		}
+
+		/**
+		* Get view of edges leading to vertex (no copy is made), in order in which they were added
+		* @param target
+		* @throws invalid_argument exception if id is invalid or if graph has no incoming index
+		* (it is kept only by directed graph, incoming edges of undirected graph are given by getEdgesFromView)
+		* @return view of edges, iterating gives pairs of <source id, reference to edge value>
+		*/
+		IncomingEdgesView getIncomingEdgesView(size_t target) const
+		{
+			auto is_in = vertices->find(target);
+			if (is_in == vertices->end())
+			{
+				throw std::invalid_argument("vertex id not found");
+			}
+			if (!_tracksIncoming())
+			{
+				throw std::invalid_argument("incoming index is not enabled");
+			}
+			const auto& incoming = is_in->second->incomingEdges;
+			return IncomingEdgesView(typename IncomingEdgesView::iterator(incoming.begin(), *vertices, *edgeStore, target),
+			                         typename IncomingEdgesView::iterator(incoming.end(), *vertices, *edgeStore, target), incoming.size());
+		}
+
+		/**
+		 * Estimates memory used by graph, node-based containers are counted by their node layout
+		 * and heap memory owned by string (or vector) values is included
+		 * @return bytes broken down by parts of graph
+		 */
+		MemoryUsage memoryUsage() const
+		{
+			MemoryUsage usage;
+			// Holders add their own allocations only with copy-on-write storage
+			usage.vertices = sizeof(GraphBase) + helper::heapBytes(vertices) + helper::allocatedBytes(*vertices);
+
+			for(const auto& v : *vertices)
+			{
+				const Vertex& vertex = *v.second;
+				usage.vertices += helper::heapBytes(v.second);
+				usage.vertices -= sizeof(V);
+				usage.vertexValues += sizeof(V) + helper::heapBytes(vertex.value);
+				usage.adjacency += helper::allocatedBytes(vertex.outgoingEdges) + helper::allocatedBytes(vertex.incomingEdges);
+
+				// Shared values are counted with edge store below
+				for(const auto& e : vertex.outgoingEdges)
+				{
+					if(!edgeStore_t::shared)
+					{
+						usage.adjacency -= sizeof(E);
+						usage.edgeValues += sizeof(E) + helper::heapBytes(e.second);
+					}
+				}
+			}
+			usage.edgeValues += helper::heapBytes(edgeStore) + edgeStore->allocatedBytes();
+			return usage;
+		}
+
+		bool operator==(const GraphBase& rhs) const
+		{
+			if(directed != rhs.directed || vertices->size() != rhs.vertices->size())
+			{
+				return false;
+			}
+
+			// Entries of adjacency may refer to edge store, so values are compared instead
+			return std::equal(vertices->begin(), vertices->end(), rhs.vertices->begin(), [&, this](const auto& a, const auto& b)
+			{
+				const auto& edges = a.second->outgoingEdges;
+				const auto& rhsEdges = b.second->outgoingEdges;
+				return a.first == b.first && a.second->value == b.second->value && edges.size() == rhsEdges.size() &&
+					std::equal(edges.begin(), edges.end(), rhsEdges.begin(), [&, this](const auto& e, const auto& rhsE)
+					{
+						return e.first == rhsE.first && edgeStore->value(e.second) == rhs.edgeStore->value(rhsE.second);
+					});
+			});
+		}
+
+		bool operator!=(const GraphBase& rhs) const
+		{
+			return !(*this == rhs);
+		}
+
+		/**
+		 * Saves point-in-time snapshot of graph to file (as saveToFile) on background thread
+		 *
+		 * Snapshot is copy of graph taken on calling thread, so graph may be modified as soon as
+		 * this method returns. With CowStorage copy is O(1) and modifications made during save clone only
+		 * what they touch, with any other storage it is synchronous deep copy in O(V + E) time and memory.
+		 * Graph is written to filePath + ".tmp" first, which then replaces filePath, so file is never left half written.
+		 * @param filePath file to which the graph will be saved (if file exists, will be overwritten)
+		 * @return future holding true if save was successful, false otherwise
+		 */
+		std::future<bool> saveToFileAsync(const std::string& filePath) const
+		{
+			Graph<V,E,S> snapshot(static_cast<const Graph<V,E,S>&>(*this));
+
+			return std::async(std::launch::async, [snapshot = std::move(snapshot), filePath]()
+			{
+				return _saveToFileAtomic(snapshot, filePath);
+			});
+		}
+
+		/**
+		 * Starts recording mutations of graph to append-only journal file
+		 *
+		 * addVertex, setVertexValue, removeVertex, addEdge(s), removeEdge and updateEdgeValue are recorded
+		 * (one line each), so persisting small changes costs O(changes). Loading from file, assignment and
+		 * changes through references returned by getEdgeValue are not recorded (compactJournal should follow them).
+		 * Records are buffered - they are written when buffer fills up and on closeJournal, syncJournal
+		 * makes them durable. Crash recovery is loadFromFile(base) followed by replayJournal(journal);
+		 * last record which was not written completely is ignored. Copies of graph do not inherit the journal.
+		 * @param journalPath path to journal file (records are appended if it exists)
+		 * @return true if journal file was opened
+		 */
+		bool openJournal(const std::string& journalPath)
+		{
+			return journal.open(journalPath);
+		}
+
+		/**
+		 * Writes buffered journal records to file and flushes file to disk (fsync), so records
+		 * recorded so far survive crash of process and of system
+		 * @return true if journal is open and all records were stored
+		 */
+		bool syncJournal()
+		{
+			return journal.sync();
+		}
+
+		/**
+		 * Stops recording mutations to journal (buffered records are written)
+		 */
+		void closeJournal()
+		{
+			journal.close();
 		}
 
 		/**
-		* Remove edge
-		* @param from vertex from
-		* @param to vertex to
-		* @return number edges removed - 0, 1 or 2 (only in case of undirected graph)
-		*/
-		size_t removeEdge(size_t from, size_t to)
+		 * Checks if mutations are recorded to journal
+		 * @return true if journal is open and all records were written
+		 */
+		bool hasJournal() const
 		{
-			return vertices.find(from)->second.outgoingEdges.erase(to) +
-				   (directed ? 0 : vertices.find(to)->second.outgoingEdges.erase(from));
+			return journal.good();
 		}
 
 		/**
-		* Test adjacency of 2 vertices
-		* @param from vertex from
-		* @param to vertex to
-		* @return true if vertices are adjacent, false if not or if they are invalid
-		*/
-		bool adjacent(size_t from, size_t to) const
+		 * Applies mutations recorded in journal to graph (replayed mutations are not recorded again)
+		 * Vertices get the same ids as when they were recorded. Replaying journal over snapshot
+		 * which already contains its changes results in the same graph. Only ids of existing vertices
+		 * are guaranteed to match - with SlotStorage order of released ids is not recorded, so later
+		 * addVertex may reuse different released id than it would in the recorded graph. Record adding vertex
+		 * with id above counter of fresh ids (recorded before the first added vertex) is malformed. Journal of graph
+		 * stays open even if replay throws.
+		 * @param journalPath path to journal file
+		 * @return true if whole journal was applied, false if file cannot be opened or contains malformed record
+		 */
+		bool replayJournal(const std::string& journalPath)
 		{
-			bool result = false;
-			auto findfrom = vertices.find(from);
-			if (findfrom != vertices.end())
+			std::ifstream inputFile(journalPath);
+			if(!inputFile.is_open())
 			{
-				if (findfrom->second.outgoingEdges.find(to) != findfrom->second.outgoingEdges.end())
-					result = true;
+				return false;
 			}
-			return result;
-		}
 
-		/**
-		* Find neighbours of vertex
-		* @param vertex
-		* @return vector of ids of neighbours, if invalid vertex - empty
-		*/
-		std::vector<size_t> getNeighbours(size_t vertex) const
-		{
-			std::vector<size_t> result;
-			auto vertex_found = vertices.find(vertex);
-			if (vertex_found != vertices.end())
+			// Journal is detached, so that replayed mutations are not recorded again, and put back even if replay throws
+			struct JournalRestore
 			{
-				for (auto & v : vertex_found->second.outgoingEdges)
+				helper::Journal& journal;
+				helper::Journal detached;
+
+				~JournalRestore()
 				{
-					result.push_back(v.first);
+					journal = std::move(detached);
+				}
+			} restore{ journal, std::move(journal) };
+			bool retValue = true;
+			// Consecutive added edges are inserted at once
+			std::vector<std::tuple<size_t, size_t, E>> batch;
+			auto insertBatch = [&, this]()
+			{
+				auto staged = _stageEdges(batch.begin(), batch.end(), [](const auto& edge)
+				{
+					return std::get<2>(edge);
+				});
+				_insertStagedEdges(staged);
+				batch.clear();
+			};
+
+			std::string line;
+			while(retValue && getline(inputFile, line))
+			{
+				// Record without new line was not completely written
+				if(inputFile.eof())
+				{
+					break;
+				}
+
+				const char* pos = line.data() + 1;
+				const char* end = line.data() + line.size();
+				size_t first, second = 0;
+				char op = line.empty() ? '\0' : line[0];
+				bool hasSecond = op == 'e' || op == 'r' || op == 'u';
+				if(line.size() < 3 || line[1] != ' ' || !helper::parseTextId(pos, end, first) ||
+				        (hasSecond && !helper::parseTextId(pos, end, second)))
+				{
+					retValue = false;
+					break;
+				}
+
+				if(op != 'e' && !batch.empty())
+				{
+					insertBatch();
+				}
+
+				if(op == 'v' || op == 's')
+				{
+					V value = V();
+					// Recorded vertex got its id from addVertex, so id above counter of fresh ids is malformed
+					if(pos == end || (op == 'v' && first > total_id))
+					{
+						retValue = false;
+						break;
+					}
+					helper::parseTextVertexValue(pos + 1, end, value);
+					if(op == 's')
+					{
+						setVertexValue(first, std::move(value));
+					}
+					else
+					{
+						// Recorded vertex was new, so it has no edges
+						removeVertex(first);
+						_addVertexWithId(first, std::move(value));
+					}
+				}
+				else if(op == 'x')
+				{
+					removeVertex(first);
+				}
+				else if(op == 'n')
+				{
+					// Graph loaded from snapshot does not know ids handed out to vertices removed before it was saved
+					total_id = std::max(total_id, first);
+				}
+				else if(op == 'r')
+				{
+					if(adjacent(first, second))
+					{
+						removeEdge(first, second);
+					}
+				}
+				else if(op == 'e' || op == 'u')
+				{
+					E value = E();
+					if(!std::is_same<E, Unweight>::value && (pos == end || !helper::parseTextEdgeValue(pos + 1, end, value)))
+					{
+						retValue = false;
+						break;
+					}
+					if(op == 'e')
+					{
+						batch.emplace_back(first, second, std::move(value));
+					}
+					else
+					{
+						_setEdgeValue(first, second, std::move(value));
+					}
+				}
+				else
+				{
+					retValue = false;
 				}
 			}
-			return result;
-		}
 
-		bool operator==(const GraphBase& rhs) const
-		{
-			return this->directed == rhs.directed && this->vertices == rhs.vertices;
+			if(!batch.empty())
+			{
+				insertBatch();
+			}
+			return retValue;
 		}
 
-		bool operator!=(const GraphBase& rhs) const
+		/**
+		 * Folds journal into base snapshot - graph (which is base with journal applied) is saved to base file
+		 * (through temporary file) and journal is emptied
+		 * @param basePath path to base snapshot file
+		 * @return true if snapshot was saved and journal (if open) was emptied
+		 */
+		bool compactJournal(const std::string& basePath)
 		{
-			return !(*this == rhs);
+			if(!_saveToFileAtomic(static_cast<const Graph<V,E,S>&>(*this), basePath))
+			{
+				return false;
+			}
+			return !journal.isOpen() || journal.truncate();
 		}
 
 #ifdef GRAPH_DEBUG
 		std::string listVertices() const
 		{
 			std::stringstream ss;
-			for (auto & m : vertices)
+			for (auto & m : *vertices)
 			{
-				ss << m.second.id + 1 << "." << m.second.value << " ";
+				ss << m.second->id + 1 << "." << m.second->value << " ";
 			}
 			return ss.str();
 		}
@@ -631,6 +2230,24 @@ namespace Graph
 			stream << listVertices() << std::endl;
 		}
 
+		std::string listMemoryUsage() const
+		{
+			MemoryUsage usage = memoryUsage();
+			std::stringstream ss;
+			ss << "Vertices: " << usage.vertices << " B\n";
+			ss << "Adjacency: " << usage.adjacency << " B\n";
+			ss << "Edge values: " << usage.edgeValues << " B\n";
+			ss << "Vertex values: " << usage.vertexValues << " B\n";
+			ss << "Total: " << usage.total() << " B (" << vertices->size() << " vertices)\n";
+			return ss.str();
+		}
+
+		void listMemoryUsageToStream(std::ostream& stream = std::cout) const
+		{
+			stream << "Memory usage: " << std::endl;
+			stream << listMemoryUsage();
+		}
+
 		size_t getActualId() const
 		{
 			return total_id;
@@ -642,21 +2259,43 @@ namespace Graph
 	/**
 	 * Graph class
 	 */
-	template<typename V, typename E>
-	class Graph : public GraphBase<V,E>
+	template<typename V, typename E, typename S>
+	class Graph : public GraphBase<V,E,S>
 	{
 	private:
 		// As vars derived from GraphBase have dependent names,
 		// usings are utilized here to avoid writing this->... every time
-		using GraphBase<V,E>::vertices;
-		using GraphBase<V,E>::directed;
+		using GraphBase<V,E,S>::vertices;
+		using GraphBase<V,E,S>::directed;
+		using GraphBase<V,E,S>::edgeStore;
+		using typename GraphBase<V,E,S>::vertexHolder;
+		using typename GraphBase<V,E,S>::_EdgeSet;
+
+		/**
+		 * Exports graph to dot format, given edges are coloured
+		 * @param outputStream stream to write to
+		 * @param colored set of edges to be coloured
+		 * @return true if export was sucessful, false otherwise
+		 */
+		bool _exportToDotColored(std::ostream& outputStream, const _EdgeSet& colored) const
+		{
+			return this->_exportToDot(outputStream, [&colored](std::ostream& outputFile, const auto& e, size_t startVertex, size_t endVertex)
+			{
+				outputFile << "[label=\"" << e << "\",weight=\"" << e << "\"";
+				if(!colored.empty() && colored.count(std::make_pair(startVertex, endVertex)))
+				{
+					outputFile << ",color=\"red\"";
+				}
+				outputFile << "]";
+			});
+		}
 	public:
 		/**
 		* Orientation constructor
 		* @param directed true for directed, false undirected
 		*/
 		Graph(bool directed = true)
-			:GraphBase<V,E>(directed)
+			:GraphBase<V,E,S>(directed)
 		{}
 
 		/**
@@ -674,20 +2313,77 @@ namespace Graph
 		*/
 		void addEdge(size_t from, size_t to, E value)
 		{
-			auto is_in_from = vertices.find(from);
-			auto is_in_to = vertices.find(to);
-			if (is_in_from == vertices.end() || is_in_to == vertices.end())
+			// Shared vertex is not cloned when the edge is already there
+			if (vertexHolder::copy_on_write && this->adjacent(from, to))
 			{
 				return;
 			}
 
-			vertices.find(from)->second.outgoingEdges.emplace(to, directed ? std::move(value) : value);
-			if (!directed)
+			auto& mutableVertices = vertices.mutate();
+			auto is_in_from = mutableVertices.find(from);
+			auto is_in_to = mutableVertices.find(to);
+			if (is_in_from == mutableVertices.end() || is_in_to == mutableVertices.end())
+			{
+				return;
+			}
+
+			auto& edges = is_in_from->second.mutate().outgoingEdges;
+			auto hint = edges.lower_bound(to);
+			if (hint != edges.end() && hint->first == to)
 			{
-				vertices.find(to)->second.outgoingEdges.emplace(from, std::move(value));
+				return;
+			}
+
+			this->_journalEdgeValue('e', from, to, value);
+			auto entry = edgeStore.mutate().create(std::move(value));
+			if (directed)
+			{
+				edges.emplace_hint(hint, to, std::move(entry));
+				// Vertex to is modified (cloned when shared by copies) only if its predecessors are tracked
+				if (this->_tracksIncoming())
+				{
+					this->_linkIncoming(from, is_in_to->second.mutate());
+				}
+			}
+			else
+			{
+				auto mirror = edgeStore->mirror(entry);
+				edges.emplace_hint(hint, to, std::move(entry));
+				// For loop the mirror is not inserted (its value is the same one)
+				is_in_to->second.mutate().outgoingEdges.emplace(from, std::move(mirror));
 			}
 		}
 
+		/**
+		* Add batch of edges
+		* Endpoints of every edge are validated once, edges are sorted and merged into adjacency
+		* of each vertex in one pass. Edges with invalid endpoints are skipped and duplicates keep
+		* the first value, so the result is the same as calling addEdge for each edge.
+		* @param begin iterator to first edge - tuple-like {from, to, value}
+		* @param end iterator behind last edge
+		* @return number of inserted edges
+		*/
+		template<typename Iterator>
+		size_t addEdges(Iterator begin, Iterator end)
+		{
+			auto staged = this->_stageEdges(begin, end, [](const auto& edge)
+			{
+				return E(std::get<2>(edge));
+			});
+			return this->_insertStagedEdges(staged);
+		}
+
+		/**
+		* Add batch of edges
+		* @param edges range of tuple-like {from, to, value} edges (e.g. result of getEdgesPositionsAndValues)
+		* @return number of inserted edges
+		*/
+		template<typename Range>
+		size_t addEdges(const Range& edges)
+		{
+			return addEdges(std::begin(edges), std::end(edges));
+		}
+
 		/**
 		* Get value of edge
 		* @param from vertex from
@@ -697,23 +2393,23 @@ namespace Graph
 		*/
 		const E& getEdgeValue(size_t from, size_t to) const
 		{
-			auto is_in_from = vertices.find(from);
-			auto is_in_to = vertices.find(to);
-			if (is_in_from == vertices.end())
+			auto is_in_from = vertices->find(from);
+			auto is_in_to = vertices->find(to);
+			if (is_in_from == vertices->end())
 			{
 				throw std::invalid_argument("\"from\" vertex id not found");
 			}
-			if (is_in_to == vertices.end())
+			if (is_in_to == vertices->end())
 			{
 				throw std::invalid_argument("\"to\" vertex id not found");
 			}
-			if(vertices.find(from)->second.outgoingEdges.find(to) == 
-				vertices.find(from)->second.outgoingEdges.end())
+			auto edge = is_in_from->second->outgoingEdges.find(to);
+			if(edge == is_in_from->second->outgoingEdges.end())
 			{
 				throw std::invalid_argument("edge does not exist");
 			}
 			
-			return vertices.find(from)->second.outgoingEdges.find(to)->second;
+			return edgeStore->value(edge->second);
 		}
 
 		/**
@@ -725,7 +2421,13 @@ namespace Graph
 		*/
 		E& getEdgeValue(size_t from, size_t to)
 		{
-			const Graph<V,E>& constMe = *this;
+			// With copy-on-write storage value must not be shared with copies when reference is handed out
+			E* value = this->_findEdgeValue(from, to);
+			if (value != nullptr)
+			{
+				return *value;
+			}
+			const Graph<V,E,S>& constMe = *this;
 			return const_cast<E&>(constMe.getEdgeValue(from, to));
             //http://stackoverflow.com/questions/123758/how-do-i-remove-code-duplication-between-similar-const-and-non-const-member-func
 		}
@@ -739,25 +2441,7 @@ namespace Graph
 		*/
 		bool updateEdgeValue(size_t from, size_t to, E value)
 		{
-			auto vertex_from = vertices.find(from);
-			if (vertex_from != vertices.end())
-			{
-				auto vertex_to = vertices.find(to);
-				if (vertex_to != vertices.end())
-				{
-					auto edgeto = vertex_from->second.outgoingEdges.find(to);
-					if (edgeto != vertex_from->second.outgoingEdges.end())
-					{
-						vertex_from->second.outgoingEdges.find(to)->second = directed ? std::move(value) : value;
-						if(!directed)
-						{
-							vertex_to->second.outgoingEdges.find(from)->second = std::move(value);
-						}
-						return true;
-					}
-				}
-			}
-			return false;
+			return this->_setEdgeValue(from, to, std::move(value));
 		}
 
 		/**
@@ -769,9 +2453,9 @@ namespace Graph
 		typename std::enable_if_t<!std::is_same<TE, std::string>::value, bool>
 		saveToFile(const std::string& filePath) const
 		{
-			return this->_saveToFile(filePath, [](auto& outputFile, auto& e)
+			return this->_saveToFile(filePath, [](auto& outputFile, auto& value)
 			{
-				outputFile << " " << e.second;
+				outputFile << " " << value;
 			});
 		}
 
@@ -784,9 +2468,9 @@ namespace Graph
 		typename std::enable_if_t<std::is_same<TE, std::string>::value, bool>
 		saveToFile(const std::string& filePath) const
 		{
-			return this->_saveToFile(filePath, [](auto& outputFile, auto& e)
+			return this->_saveToFile(filePath, [](auto& outputFile, auto& value)
 			{
-				outputFile << " " << "\"" << e.second << "\"";
+				outputFile << " " << "\"" << value << "\"";
 			});
 		}
 
@@ -801,11 +2485,11 @@ namespace Graph
 		{
 			static_assert(std::is_default_constructible<E>::value, "Edge type must be default constructible.");
 			
-			return this->_loadFromFile(filePath, true, [&,this](auto& ss, auto& targetId)
+			return this->_loadFromFile(filePath, true, [this](auto& ss, auto& vertex, auto& targetId)
 			{
 				E edgeValue;
 				ss >> edgeValue;
-				vertices.rbegin()->second.outgoingEdges.emplace(targetId, edgeValue);
+				this->_loadEdge(vertex, targetId, std::move(edgeValue));
 			});
 		}
 
@@ -818,7 +2502,7 @@ namespace Graph
 		typename std::enable_if_t<std::is_same<TE, std::string>::value, bool>
 		loadFromFile(const std::string& filePath)
 		{
-			return this->_loadFromFile(filePath, true, [&,this](auto& ss, auto& targetId)
+			return this->_loadFromFile(filePath, true, [this](auto& ss, auto& vertex, auto& targetId)
 			{
 				std::string result;
 				getline(ss, result);
@@ -827,11 +2511,23 @@ namespace Graph
 				if(quotePos != std::string::npos && quotePosEnd != quotePos)
 				{
 					result = result.substr(quotePos + 1, quotePosEnd - quotePos - 1);
-					vertices.rbegin()->second.outgoingEdges.emplace(targetId, result);
+					this->_loadEdge(vertex, targetId, std::move(result));
 				}
 			});
 		}
 
+		/**
+		* Clears current graph content and loads graph from file in custom format (same as loadFromFile),
+		* file is read in large blocks parsed in parallel without streams
+		* @param filePath path to file
+		* @param threads count of parsing threads, 0 = hardware concurrency
+		* @return true if loading was successful, false otherwise (e.g. malformed line)
+		*/
+		bool loadFromFileParallel(const std::string& filePath, size_t threads = 0)
+		{
+			return this->_loadFromFileParallel(filePath, threads);
+		}
+
 		/**
 		 * Exports graph to dot format with ids as vertex names
 		 * @param filePath path to file
@@ -840,76 +2536,58 @@ namespace Graph
 		 */
 		bool exportToDot(const std::string& filePath, const std::vector<size_t>& colorEdgesBetween = std::vector<size_t>()) const
 		{
-			return this->_exportToDot(filePath, [&, this](auto& outputFile, auto& e, auto& startVertex, auto& endVertex)
+			return this->_exportToFile(filePath, [&, this](std::ostream& outputFile)
 			{
-				std::stringstream ss;
-				ss << e;
-
-				auto startVrtxPos = std::find(colorEdgesBetween.begin(), colorEdgesBetween.end(), startVertex);
-				std::string color;
-
-				if(startVrtxPos != colorEdgesBetween.end())
-				{
-					if((startVrtxPos+1 != colorEdgesBetween.end() && *(startVrtxPos+1) == endVertex) ||
-					        (!directed && startVrtxPos != colorEdgesBetween.begin() && *(startVrtxPos-1) == endVertex))
-					{
-						color = ",color=\"red\"";
-					}
-				}
-
-				outputFile << "[label=\"" << ss.str() << "\",weight=\"" << ss.str()  << "\"" << color << "]";
-
-				ss.flush();
+				return exportToDot(outputFile, colorEdgesBetween);
 			});
 		}
 
 		/**
 		 * Exports graph to dot format with ids as vertex names
 		 * @param filePath path to file
-		 * @param colorEdgesBetween vector of edges pairs which will be coloured
+		 * @param colorEdges vector of edges pairs which will be coloured
 		 * @return true if export was sucessful, false otherwise
 		 */
 		bool exportToDot(const std::string& filePath, const std::vector<std::pair<size_t, size_t>>& colorEdges) const
 		{
-			return this->_exportToDot(filePath, [&, this](auto& outputFile, auto& e, auto& startVertex, auto& endVertex)
+			return this->_exportToFile(filePath, [&, this](std::ostream& outputFile)
 			{
-				std::stringstream ss;
-				ss << e;
-
-				bool shouldBeColored = false;
-
-				for(auto& edge : colorEdges)
-				{
-					if((edge.first == startVertex && edge.second == endVertex) ||
-					        (!directed && edge.first == endVertex && edge.second == startVertex))
-					{
-						shouldBeColored = true;
-						break;
-					}
-				}
-
-				std::string color;
-
-				if(shouldBeColored)
-				{
-					color = ",color=\"red\"";
-				}
+				return exportToDot(outputFile, colorEdges);
+			});
+		}
 
-				outputFile << "[label=\"" << ss.str() << "\",weight=\"" << ss.str()  << "\"" << color << "]";
+		/**
+		 * Exports graph to dot format with ids as vertex names
+		 * @param outputStream stream to write to
+		 * @param colorEdgesBetween path of ids of vertices whose between edges will be coloured (each vertex must be contained only once)
+		 * @return true if export was sucessful, false otherwise
+		 */
+		bool exportToDot(std::ostream& outputStream, const std::vector<size_t>& colorEdgesBetween = std::vector<size_t>()) const
+		{
+			return _exportToDotColored(outputStream, this->_pathEdges(colorEdgesBetween));
+		}
 
-				ss.flush();
-			});
+		/**
+		 * Exports graph to dot format with ids as vertex names
+		 * @param outputStream stream to write to
+		 * @param colorEdges vector of edges pairs which will be coloured
+		 * @return true if export was sucessful, false otherwise
+		 */
+		bool exportToDot(std::ostream& outputStream, const std::vector<std::pair<size_t, size_t>>& colorEdges) const
+		{
+			return _exportToDotColored(outputStream, this->_edgeSet(colorEdges));
 		}
 
+
 #ifdef GRAPH_DEBUG
 		std::string listEdges() const
 		{
 			std::stringstream ss;
-			for (auto & m : vertices)
+			for (auto & m : *vertices)
 			{
-				for (auto & n : m.second.outgoingEdges)
+				for (auto & n : m.second->outgoingEdges)
 				{
-					ss << "Edge from " << m.second.value << " to " << vertices.find(n.first)->second.value << " with value " << n.second <<"\n";
+					ss << "Edge from " << m.second->value << " to " << vertices->find(n.first)->second->value << " with value " << edgeStore->value(n.second) <<"\n";
 				}
 			}
 			return ss.str();
@@ -926,19 +2604,40 @@ namespace Graph
 	/**
 	 * Graph class specialization for unweighted graphs
 	 */
-	template<typename V>
-	class Graph<V, Unweight> : public GraphBase<V, Unweight>
+	template<typename V, typename S>
+	class Graph<V, Unweight, S> : public GraphBase<V, Unweight, S>
 	{
 	private:
-		using GraphBase<V,Unweight>::vertices;
-		using GraphBase<V,Unweight>::directed;
+		using GraphBase<V,Unweight,S>::vertices;
+		using GraphBase<V,Unweight,S>::directed;
+		using GraphBase<V,Unweight,S>::edgeStore;
+		using typename GraphBase<V,Unweight,S>::vertexHolder;
+		using typename GraphBase<V,Unweight,S>::_EdgeSet;
+
+		/**
+		 * Exports graph to dot format, given edges are coloured
+		 * @param outputStream stream to write to
+		 * @param colored set of edges to be coloured
+		 * @return true if export was sucessful, false otherwise
+		 */
+		bool _exportToDotColored(std::ostream& outputStream, const _EdgeSet& colored) const
+		{
+			return this->_exportToDot(outputStream, [&colored](std::ostream& outputFile, const auto& e, size_t startVertex, size_t endVertex)
+			{
+				(void)e;
+				if(!colored.empty() && colored.count(std::make_pair(startVertex, endVertex)))
+				{
+					outputFile << "[color=\"red\"]";
+				}
+			});
+		}
 	public:
 		/**
 		* Orientation constructor
 		* @param directed true for directed, false undirected
 		*/
 		Graph(bool directed = true)
-			:GraphBase<V, Unweight>(directed)
+			:GraphBase<V, Unweight, S>(directed)
 		{}
 
 		/**
@@ -955,21 +2654,75 @@ namespace Graph
 		*/
 		void addEdge(size_t from, size_t to)
 		{
-			Unweight u;
-			auto is_in_from = vertices.find(from);
-			auto is_in_to = vertices.find(to);
-			if (is_in_from == vertices.end() || is_in_to == vertices.end())
+			if (vertexHolder::copy_on_write && this->adjacent(from, to))
 			{
 				return;
 			}
 
-			vertices.find(from)->second.outgoingEdges.emplace(to, u);
-			if (!directed)
+			auto& mutableVertices = vertices.mutate();
+			auto is_in_from = mutableVertices.find(from);
+			auto is_in_to = mutableVertices.find(to);
+			if (is_in_from == mutableVertices.end() || is_in_to == mutableVertices.end())
+			{
+				return;
+			}
+
+			auto& edges = is_in_from->second.mutate().outgoingEdges;
+			auto hint = edges.lower_bound(to);
+			if (hint != edges.end() && hint->first == to)
+			{
+				return;
+			}
+
+			this->_journalEdgeValue('e', from, to, Unweight());
+			auto entry = edgeStore.mutate().create(Unweight());
+			if (directed)
+			{
+				edges.emplace_hint(hint, to, entry);
+				// Vertex to is modified (cloned when shared by copies) only if its predecessors are tracked
+				if (this->_tracksIncoming())
+				{
+					this->_linkIncoming(from, is_in_to->second.mutate());
+				}
+			}
+			else
 			{
-				vertices.find(to)->second.outgoingEdges.emplace(from, u);
+				auto mirror = edgeStore->mirror(entry);
+				edges.emplace_hint(hint, to, entry);
+				is_in_to->second.mutate().outgoingEdges.emplace(from, mirror);
 			}
 		}
 
+		/**
+		* Add batch of edges
+		* Endpoints of every edge are validated once, edges are sorted and merged into adjacency
+		* of each vertex in one pass. Edges with invalid endpoints are skipped, so the result is
+		* the same as calling addEdge for each edge.
+		* @param begin iterator to first edge - pair-like {from, to}
+		* @param end iterator behind last edge
+		* @return number of inserted edges
+		*/
+		template<typename Iterator>
+		size_t addEdges(Iterator begin, Iterator end)
+		{
+			auto staged = this->_stageEdges(begin, end, [](const auto&)
+			{
+				return Unweight();
+			});
+			return this->_insertStagedEdges(staged);
+		}
+
+		/**
+		* Add batch of edges
+		* @param edges range of pair-like {from, to} edges (e.g. result of getEdgesPositions)
+		* @return number of inserted edges
+		*/
+		template<typename Range>
+		size_t addEdges(const Range& edges)
+		{
+			return addEdges(std::begin(edges), std::end(edges));
+		}
+
 		/**
 		 * Saves graph to file in custom format
 		 * @param filePath file to which the graph will be saved (if file exists, will be overwritten)
@@ -987,12 +2740,24 @@ namespace Graph
 		*/
 		bool loadFromFile(const std::string& filePath)
 		{
-			return this->_loadFromFile(filePath, false, [&, this](auto&, auto& targetId)
+			return this->_loadFromFile(filePath, false, [this](auto&, auto& vertex, auto& targetId)
 			{
-				vertices.rbegin()->second.outgoingEdges.emplace(targetId, Unweight());
+				this->_loadEdge(vertex, targetId, Unweight());
 			});
 		}
 
+		/**
+		* Clears current graph content and loads graph from file in custom format (same as loadFromFile),
+		* file is read in large blocks parsed in parallel without streams
+		* @param filePath path to file
+		* @param threads count of parsing threads, 0 = hardware concurrency
+		* @return true if loading was successful, false otherwise (e.g. malformed line)
+		*/
+		bool loadFromFileParallel(const std::string& filePath, size_t threads = 0)
+		{
+			return this->_loadFromFileParallel(filePath, threads);
+		}
+
 		/**
 		 * Exports graph to dot format with ids as vertex names
 		 * @param filePath path to file
@@ -1001,66 +2766,58 @@ namespace Graph
 		 */
 		bool exportToDot(const std::string& filePath, const std::vector<size_t>& colorEdgesBetween = std::vector<size_t>()) const
 		{
-			return this->_exportToDot(filePath, [&, this](auto& outputFile, auto&, auto& startVertex, auto& endVertex)
+			return this->_exportToFile(filePath, [&, this](std::ostream& outputFile)
 			{
-				auto startVrtxPos = std::find(colorEdgesBetween.begin(), colorEdgesBetween.end(), startVertex);
-				std::string color;
-
-				if(startVrtxPos != colorEdgesBetween.end())
-				{
-					if((startVrtxPos+1 != colorEdgesBetween.end() && *(startVrtxPos+1) == endVertex) ||
-					        (!directed && startVrtxPos != colorEdgesBetween.begin() && *(startVrtxPos-1) == endVertex))
-					{
-						color = "[color=\"red\"]";
-					}
-				}
-
-				outputFile << color;
+				return exportToDot(outputFile, colorEdgesBetween);
 			});
 		}
 
 		/**
 		 * Exports graph to dot format with ids as vertex names
 		 * @param filePath path to file
-		 * @param colorEdgesBetween vector of edges pairs which will be coloured
+		 * @param colorEdges vector of edges pairs which will be coloured
 		 * @return true if export was sucessful, false otherwise
 		 */
 		bool exportToDot(const std::string& filePath, const std::vector<std::pair<size_t, size_t>>& colorEdges) const
 		{
-			return this->_exportToDot(filePath, [&, this](auto& outputFile, auto&, auto& startVertex, auto& endVertex)
+			return this->_exportToFile(filePath, [&, this](std::ostream& outputFile)
 			{
-				bool shouldBeColored = false;
-
-				for(auto& edge : colorEdges)
-				{
-					if((edge.first == startVertex && edge.second == endVertex) ||
-					        (!directed && edge.first == endVertex && edge.second == startVertex))
-					{
-						shouldBeColored = true;
-						break;
-					}
-				}
-
-				std::string color;
+				return exportToDot(outputFile, colorEdges);
+			});
+		}
 
-				if(shouldBeColored)
-				{
-					color = "[color=\"red\"]";
-				}
+		/**
+		 * Exports graph to dot format with ids as vertex names
+		 * @param outputStream stream to write to
+		 * @param colorEdgesBetween path of ids of vertices whose between edges will be coloured (each vertex must be contained only once)
+		 * @return true if export was sucessful, false otherwise
+		 */
+		bool exportToDot(std::ostream& outputStream, const std::vector<size_t>& colorEdgesBetween = std::vector<size_t>()) const
+		{
+			return _exportToDotColored(outputStream, this->_pathEdges(colorEdgesBetween));
+		}
 
-				outputFile << color;
-			});
+		/**
+		 * Exports graph to dot format with ids as vertex names
+		 * @param outputStream stream to write to
+		 * @param colorEdges vector of edges pairs which will be coloured
+		 * @return true if export was sucessful, false otherwise
+		 */
+		bool exportToDot(std::ostream& outputStream, const std::vector<std::pair<size_t, size_t>>& colorEdges) const
+		{
+			return _exportToDotColored(outputStream, this->_edgeSet(colorEdges));
 		}
 
+
 #ifdef GRAPH_DEBUG
 		std::string listEdges() const
 		{
 			std::stringstream ss;
-			for (auto & m : vertices)
+			for (auto & m : *vertices)
 			{
-				for (auto & n : m.second.outgoingEdges)
+				for (auto & n : m.second->outgoingEdges)
 				{
-					ss << "Edge from " << m.second.value << " to " << vertices.find(n.first)->second.value << "\n";
+					ss << "Edge from " << m.second->value << " to " << vertices->find(n.first)->second->value << "\n";
 				}
 			}
 			return ss.str();
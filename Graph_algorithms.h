@@ -3,16 +3,54 @@
 #include <stack>
 #include <queue>
 #include <map>
+#include <unordered_map>
 #include <set>
 #include <algorithm>
 #include <utility>
 #include <tuple>
 #include <memory>
+#include <vector>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "Graph.h"
+#include "Graph_frozen.h"
 #include "heap.h"
 
 namespace Graph
 {
+	/**
+	 * Tag selecting binary heap with lazy deletion (outdated entries are skipped when popped)
+	 * as priority queue of dijkstraAll, dijkstraDense and prim
+	 */
+	struct LazyHeapQueue {};
+
+	/**
+	 * Tag selecting indexed d-ary heap (IndexedHeap from heap.h) with decrease-key
+	 * as priority queue of dijkstraAll, dijkstraDense and prim
+	 */
+	template<size_t Arity = 4>
+	struct IndexedHeapQueue {};
+
+	/**
+	 * Tag selecting monotone radix heap as priority queue of shortest path searches
+	 * (only for unsigned integral edge values, amortised O(bits of E) per vertex)
+	 */
+	struct RadixHeapQueue {};
+
+	/**
+	 * Tag selecting Dial's bucket queue as priority queue of shortest path searches
+	 * (only for unsigned integral edge values, suits small edge values)
+	 */
+	struct DialQueue {};
+
+	/**
+	 * Tag selecting RadixHeapQueue for unsigned integral edge values and LazyHeapQueue otherwise
+	 */
+	struct AutoQueue {};
+
 	/**
 	* Namespace for additional helper stuff
 	*/
@@ -127,12 +165,12 @@ namespace Graph
 		* @param preorder unary function
 		* @param postorder unary function
 		*/
-		template<typename V, typename E, typename UnaryFunction1, typename UnaryFunction2>
-		void _dfs(Graph<V, E> & graph, size_t starting_vertex, UnaryFunction1 preorder, UnaryFunction2 postorder, std::map<size_t, bool> & discovered)
+		template<typename V, typename E, typename S, typename UnaryFunction1, typename UnaryFunction2>
+		void _dfs(Graph<V, E, S> & graph, size_t starting_vertex, UnaryFunction1 preorder, UnaryFunction2 postorder, std::map<size_t, bool> & discovered)
 		{
 			discovered.find(starting_vertex)->second = true;
 			preorder(graph.getVertexValue(starting_vertex));
-			for (auto & v : graph.getNeighbours(starting_vertex))
+			for (auto v : graph.getNeighboursView(starting_vertex))
 			{
 				if(!discovered.find(v)->second) _dfs(graph, v, preorder, postorder, discovered);
 			}
@@ -145,8 +183,8 @@ namespace Graph
 		*  Get pairs of <id, value> of vertices
 		* @return map, where key = id and value = value of given vertex
 		*/
-		template<typename V, typename E>
-		std::map<size_t, V> getVerticesMap(const GraphBase<V,E>& graph)
+		template<typename V, typename E, typename S>
+		std::map<size_t, V> getVerticesMap(const GraphBase<V,E,S>& graph)
 		{
 			auto ids = graph.getVerticesIds();
 			std::map<size_t, V> result;
@@ -161,8 +199,8 @@ namespace Graph
 		 * Returns map with vertices ids as keys and default constructed element T as value
 		 * @return map, where key = id and value = default constructed template parameter
 		 */
-		template<typename T, typename V, typename E>
-		std::map<size_t, T> getVerticesMap(const GraphBase<V,E>& graph)
+		template<typename T, typename V, typename E, typename S>
+		std::map<size_t, T> getVerticesMap(const GraphBase<V,E,S>& graph)
 		{
 			auto ids = graph.getVerticesIds();
 			std::map<size_t, T> result;
@@ -172,314 +210,2318 @@ namespace Graph
 			}
 			return result;
 		}
-	}
 
-	/**
-	* Depth-first search algorithm
-	* @param graph graph
-	* @param starting_vertex vertex to start search from, must be part of graph
-	* @param preorder unary function
-	* @param postorder unary function
-	*/
-	template<typename V, typename E, typename UnaryFunction1, typename UnaryFunction2>
-	void dfs(Graph<V, E> & graph, size_t starting_vertex, UnaryFunction1 preorder, UnaryFunction2 postorder)
-	{
-		std::map<size_t, bool> discovered;
-		auto vertmap = helper::getVerticesMap(graph);
-		if (vertmap.find(starting_vertex) == vertmap.end())
-		{
-			return;
-		}
-		for (auto & ver : vertmap)
+		/**
+		 * Union-find data structure over dense indices 0..n-1
+		 */
+		class DenseUnionFind
 		{
-			discovered.emplace(ver.first, false);
-		}
-		helper::_dfs(graph, starting_vertex, preorder, postorder, discovered);
-
-		return;
-	}
+		private:
+			std::vector<size_t> parents;
+			std::vector<size_t> sizes;
+		public:
+			DenseUnionFind(size_t count)
+				:parents(count), sizes(count, 1)
+			{
+				std::iota(parents.begin(), parents.end(), 0);
+			}
 
-	/**
-	* Breadth-first search algorithm
-	* @param graph graph
-	* @param starting_vertex vertex to start search from, must be part of graph
-	* @param f unary function
-	* @return distances and paths to discovered vertices(if graph is enweighted, then shortest paths)
-	*/
-	template<typename V, typename E, typename UnaryFunction>
-	std::pair<std::map<size_t, size_t>, std::map<size_t, size_t>>
-	bfs(Graph<V, E> & graph, size_t starting_vertex, UnaryFunction f)
-	{
-		std::map<size_t, size_t> distance;
-		std::map<size_t, size_t> parent;
-		auto vertmap = helper::getVerticesMap(graph);
-		if (vertmap.find(starting_vertex) == vertmap.end())
-		{
-			return {distance, parent};
-		}
-		for (auto & ver : vertmap)
-		{
-			distance.emplace(ver.first, std::numeric_limits<size_t>::max());
-			parent.emplace(ver.first, ver.first);
-		}
-		std::queue<size_t> vertex_queue;
-		vertex_queue.push(starting_vertex);
-		distance.find(starting_vertex)->second = 0;
-		while (!vertex_queue.empty())
-		{
-			size_t v = vertex_queue.front();
-			vertex_queue.pop();
-			f(graph.getVertexValue(v));
-			for (auto & edd : graph.getNeighbours(v))
+			size_t find(size_t item)
 			{
-				if (distance.find(edd)->second == std::numeric_limits<size_t>::max())
+				while(parents[item] != item)
 				{
-					distance.find(edd)->second = distance.find(v)->second + 1;
-					parent.find(edd)->second = v;
-					vertex_queue.push(edd);
+					parents[item] = parents[parents[item]];
+					item = parents[item];
 				}
+				return item;
 			}
-		}
-		return {distance, parent};
-	}
 
-	/**
-	 * Bellman-Ford shortest path algorithm
-	 * @param graph graph to find shortest paths in
-	 * @param startVertex source vertex
-	 * @param infinity infinity value
-	 * @return pair of maps of <distances of each vertex from source vertex (infinity if no path exists) AND predecessors>
-	 */
-	template<typename V, typename E>
-	std::pair<std::map<size_t, E>, std::map<size_t, size_t>>
-	bellmanFord(const Graph<V,E>& graph, size_t startVertex, E infinity = std::numeric_limits<E>::max())
-	{
-		static_assert(std::is_default_constructible<E>::value, "Edge type must be default constructible.");
-		
-		std::map<size_t, E> distance = helper::getVerticesMap<E>(graph);
-		std::map<size_t, size_t> predecessors = helper::getVerticesMap<size_t>(graph);
-		auto graphEdges = graph.getEdgesPositions(true);
+			void unionSets(size_t first, size_t second)
+			{
+				size_t firstRoot = find(first);
+				size_t secondRoot = find(second);
 
-		for(auto& d : distance)
+				if(firstRoot == secondRoot) { return; }
+
+				if(sizes[firstRoot] < sizes[secondRoot])
+				{
+					std::swap(firstRoot, secondRoot);
+				}
+				parents[secondRoot] = firstRoot;
+				sizes[firstRoot] += sizes[secondRoot];
+			}
+		};
+
+		/**
+		 * Compares <distance, index> pairs so that std::priority_queue returns the closest one
+		 */
+		template<typename E>
+		struct CompareDistance
 		{
-			d.second = infinity;
-		}
+			bool operator()(const std::pair<E, size_t>& left, const std::pair<E, size_t>& right) const
+			{
+				return right.first < left.first;
+			}
+		};
 
-		for(auto& p : predecessors)
+		/**
+		 * Compares keys so that heaps from heap.h return the smallest one
+		 */
+		template<typename E>
+		struct CompareKeys
 		{
-			p.second = p.first;
-		}
+			bool operator()(const E& left, const E& right) const
+			{
+				return right < left;
+			}
+		};
 
-		distance.at(startVertex) = E();
+		/**
+		 * Priority queue of dense indices ordered by distance, selected by queue tag
+		 *
+		 * push inserts index or lowers its distance, pop removes and returns <distance, index> of the closest one,
+		 * top returns it without removing.
+		 * Queues may return outdated entries (with distance higher than the current one), searches skip them.
+		 */
+		template<typename Queue, typename E>
+		class SearchQueue;
 
-		for(size_t i = 0; i < graph.getVerticesCount() - 1; ++i)
+		template<typename E>
+		class SearchQueue<LazyHeapQueue, E>
 		{
-			for(auto& edge : graphEdges)
+		private:
+			std::vector<std::pair<E, size_t>> heap;
+
+		public:
+			void reset(size_t)
 			{
-				if(distance.at(edge.first) != infinity &&
-				        distance.at(edge.first) + graph.getEdgeValue(edge.first, edge.second) < distance.at(edge.second))
-				{
-					distance.at(edge.second) = distance.at(edge.first) + graph.getEdgeValue(edge.first, edge.second);
-					predecessors.at(edge.second) = edge.first;
-				}
+				heap.clear();
 			}
-		}
 
-		for(auto& edge : graphEdges)
-		{
-			if(distance.at(edge.first) != infinity &&
-			        distance.at(edge.first) + graph.getEdgeValue(edge.first, edge.second) < distance.at(edge.second))
+			bool empty() const
 			{
-				throw std::invalid_argument("Graph contains cycle of negative weight!");
+				return heap.empty();
 			}
-		}
 
-		return { distance, predecessors };
-	}
+			void push(size_t index, const E& distance)
+			{
+				heap.emplace_back(distance, index);
+				std::push_heap(heap.begin(), heap.end(), CompareDistance<E>());
+			}
 
-	/**
-	 * Bellman-Ford shortest path algorithm
-	 * @param graph graph to find shortest path in
-	 * @param startVertex source vertex
-	 * @param endVertex end vertex
-	 * @param infinity infinity value
-	 * @return length of shortest path
-	 */
-	template<typename V, typename E>
-	E bellmanFordShortestPath(const Graph<V,E>& graph, size_t startVertex, size_t endVertex, E infinity = std::numeric_limits<E>::max())
-	{
-		return bellmanFord(graph, startVertex, infinity).first.at(endVertex);
-	}
+			std::pair<E, size_t> top() const
+			{
+				return heap.front();
+			}
 
-	/**
-	 * Bellman-Ford shortest path algorithm
-	 * @param graph graph to find shortest path in
-	 * @param startVertex source vertex
-	 * @param endVertex end vertex
-	 * @param infinity infinity value
-	 * @return vector of vertices ids of path ordered from start vertex to end
-	 */
-	template<typename V, typename E>
-	std::vector<size_t> bellmanFordPathVertices(const Graph<V,E>& graph, size_t startVertex, size_t endVertex, E infinity = std::numeric_limits<E>::max())
-	{
-		auto destination = bellmanFord(graph, startVertex, infinity);
-		std::vector<size_t> result;
+			std::pair<E, size_t> pop()
+			{
+				std::pop_heap(heap.begin(), heap.end(), CompareDistance<E>());
+				std::pair<E, size_t> top = std::move(heap.back());
+				heap.pop_back();
+				return top;
+			}
+		};
 
-		if(destination.first.at(endVertex) == infinity)
+		template<size_t Arity, typename E>
+		class SearchQueue<IndexedHeapQueue<Arity>, E>
 		{
-			return result;
-		}
+		private:
+			IndexedHeap<E, CompareKeys<E>, Arity> heap;
 
-		size_t currVertex = endVertex;
-		while(currVertex != startVertex)
-		{
-			result.push_back(currVertex);
-			currVertex = destination.second.at(currVertex);
-		}
-		result.push_back(startVertex);
+		public:
+			void reset(size_t count)
+			{
+				heap.clear();
+				heap.resize(count);
+			}
 
-		return std::vector<size_t> { result.rbegin(), result.rend() };
-	}
+			bool empty() const
+			{
+				return heap.empty();
+			}
 
-	template<typename V>
-	std::map<size_t, Unweight> bellmanFord(const Graph<V,Unweight>&, size_t, Unweight = Unweight()) = delete;
+			void push(size_t index, const E& distance)
+			{
+				heap.pushOrUpdate(index, distance);
+			}
 
-	template<typename V>
-	Unweight bellmanFordShortestPath(const Graph<V,Unweight>&, size_t, size_t, Unweight = Unweight()) = delete;
+			std::pair<E, size_t> top() const
+			{
+				return std::pair<E, size_t>(heap.topKey(), heap.top());
+			}
 
-	template<typename V>
-	std::vector<size_t> bellmanFordPathVertices(const Graph<V,Unweight>&, size_t, size_t, Unweight = Unweight()) = delete;
+			std::pair<E, size_t> pop()
+			{
+				std::pair<E, size_t> top(heap.topKey(), heap.top());
+				heap.pop();
+				return top;
+			}
+		};
 
-	/**
-	 * Kruskal algorithm for computing minimum spanning tree (only for undirected weighted graphs)
-	 * @param graph
-	 * @return vector of source/end vertices of MST edges
-	 */
-	template<typename V, typename E>
-	std::vector<std::pair<size_t, size_t>> kruskalMST(const Graph<V, E>& graph)
-	{
-		if(graph.isDirected())
+		/**
+		 * Monotone radix heap, popped distances never decrease, so pushed distance must not be lower than the last popped one
+		 *
+		 * Entry is kept in bucket given by highest bit in which its distance differs from the last popped distance,
+		 * popping from empty bucket 0 moves entries of the first non-empty bucket to lower buckets.
+		 */
+		template<typename E>
+		class SearchQueue<RadixHeapQueue, E>
 		{
-			throw std::invalid_argument("Kruskal algorithm is defined only for undirected graphs.");
-		}
+		private:
+			static_assert(std::is_integral<E>::value && std::is_unsigned<E>::value,
+			              "radix heap requires unsigned integral edge values");
 
-		std::vector<std::pair<size_t, size_t>> result;
-		auto edges = graph.getEdgesPositionsAndValues();
-		std::sort(edges.begin(), edges.end(), [](auto a, auto b)
-		{
-			return std::get<2>(a) < std::get<2>(b);
-		} );
+			std::vector<std::pair<E, size_t>> buckets[std::numeric_limits<E>::digits + 1];
+			E last = E();
+			size_t count = 0;
 
-		helper::UnionFind uf(helper::getVerticesMap(graph));
+			size_t bucketOf(E distance) const
+			{
+				size_t bucket = 0;
+				for (E diff = E(distance ^ last); diff != 0; diff >>= 1)
+				{
+					++bucket;
+				}
+				return bucket;
+			}
 
-		for(auto& edge : edges)
-		{
-			if(uf.find(std::get<0>(edge)) != uf.find(std::get<1>(edge)))
+			// Moves entries with the lowest distance to bucket 0
+			void refill()
 			{
-				result.emplace_back(std::get<0>(edge), std::get<1>(edge));
-				uf.unionSets(std::get<0>(edge), std::get<1>(edge));
+				if (buckets[0].empty())
+				{
+					size_t i = 1;
+					while (buckets[i].empty())
+					{
+						++i;
+					}
+					last = buckets[i][0].first;
+					for (const auto& entry : buckets[i])
+					{
+						last = std::min(last, entry.first);
+					}
+					for (const auto& entry : buckets[i])
+					{
+						buckets[bucketOf(entry.first)].push_back(entry);
+					}
+					buckets[i].clear();
+				}
 			}
-		}
 
-		return result;
-	}
+		public:
+			void reset(size_t)
+			{
+				for (auto& bucket : buckets)
+				{
+					bucket.clear();
+				}
+				last = E();
+				count = 0;
+			}
 
-	template<typename V>
-	std::vector<std::pair<size_t, size_t>> kruskalMST(const Graph<V, Unweight>& graph) = delete;
+			bool empty() const
+			{
+				return count == 0;
+			}
 
-	/**
-	* Dijkstra algorithm
-	* @param graph graph
+			void push(size_t index, const E& distance)
+			{
+				buckets[bucketOf(distance)].emplace_back(distance, index);
+				++count;
+			}
+
+			std::pair<E, size_t> top()
+			{
+				refill();
+				return buckets[0].back();
+			}
+
+			std::pair<E, size_t> pop()
+			{
+				refill();
+				std::pair<E, size_t> top = buckets[0].back();
+				buckets[0].pop_back();
+				--count;
+				return top;
+			}
+		};
+
+		/**
+		 * Dial's bucket queue, popped distances never decrease, so pushed distance must not be lower than the last popped one
+		 *
+		 * Buckets form ring indexed by distance modulo its size, ring grows to power of two larger than
+		 * the highest edge value seen, so each bucket holds entries of single distance.
+		 */
+		template<typename E>
+		class SearchQueue<DialQueue, E>
+		{
+		private:
+			static_assert(std::is_integral<E>::value && std::is_unsigned<E>::value,
+			              "Dial's bucket queue requires unsigned integral edge values");
+
+			std::vector<std::vector<size_t>> ring;
+			E current = E();
+			size_t count = 0;
+
+			void grow(E span)
+			{
+				size_t size = ring.size();
+				while (size <= span)
+				{
+					size *= 2;
+				}
+				std::vector<std::vector<size_t>> larger(size);
+				for (size_t i = 0; i < ring.size(); ++i)
+				{
+					// Distance of bucket is the one in range [current, current + old size) with this remainder
+					E distance = E(current + E((i - size_t(current)) & (ring.size() - 1)));
+					larger[size_t(distance) & (size - 1)] = std::move(ring[i]);
+				}
+				ring.swap(larger);
+			}
+
+		public:
+			SearchQueue()
+				:ring(64)
+			{
+			}
+
+			void reset(size_t)
+			{
+				for (auto& bucket : ring)
+				{
+					bucket.clear();
+				}
+				current = E();
+				count = 0;
+			}
+
+			bool empty() const
+			{
+				return count == 0;
+			}
+
+			void push(size_t index, const E& distance)
+			{
+				if (E(distance - current) >= ring.size())
+				{
+					grow(E(distance - current));
+				}
+				ring[size_t(distance) & (ring.size() - 1)].push_back(index);
+				++count;
+			}
+
+			std::pair<E, size_t> top()
+			{
+				while (ring[size_t(current) & (ring.size() - 1)].empty())
+				{
+					++current;
+				}
+				return std::pair<E, size_t>(current, ring[size_t(current) & (ring.size() - 1)].back());
+			}
+
+			std::pair<E, size_t> pop()
+			{
+				while (ring[size_t(current) & (ring.size() - 1)].empty())
+				{
+					++current;
+				}
+				auto& bucket = ring[size_t(current) & (ring.size() - 1)];
+				std::pair<E, size_t> top(current, bucket.back());
+				bucket.pop_back();
+				--count;
+				return top;
+			}
+		};
+
+		template<typename E>
+		class SearchQueue<AutoQueue, E>
+			: public SearchQueue<typename std::conditional<std::is_integral<E>::value && std::is_unsigned<E>::value,
+			                                              RadixHeapQueue, LazyHeapQueue>::type, E>
+		{
+		};
+
+		/**
+		 * Monotone queues require that no pushed key is lower than the last popped one,
+		 * which holds for shortest path searches, but not for Prim's algorithm
+		 */
+		template<typename Queue, typename E>
+		struct isMonotoneQueue : std::false_type {};
+
+		template<typename E>
+		struct isMonotoneQueue<RadixHeapQueue, E> : std::true_type {};
+
+		template<typename E>
+		struct isMonotoneQueue<DialQueue, E> : std::true_type {};
+
+		template<typename E>
+		struct isMonotoneQueue<AutoQueue, E> : std::integral_constant<bool, std::is_integral<E>::value && std::is_unsigned<E>::value> {};
+
+		/**
+		 * Maps ids of vertices to dense indices, so that arrays sized by count of vertices can replace maps
+		 *
+		 * Table indexed by id is used while it has at most 4 entries per vertex, sorted ids are binary
+		 * searched otherwise, so memory does not depend on the largest id.
+		 */
+		class DenseIds
+		{
+		private:
+			const std::vector<size_t>& ids;
+			std::vector<size_t> table;
+
+		public:
+			/**
+			 * @param ids ids of vertices sorted ascending (as given by getVerticesIds), must outlive mapping
+			 */
+			explicit DenseIds(const std::vector<size_t>& ids)
+				:ids(ids)
+			{
+				if(!ids.empty() && ids.back() / 4 < ids.size())
+				{
+					table.resize(ids.back() + 1);
+					for(size_t i = 0; i < ids.size(); ++i)
+					{
+						table[ids[i]] = i;
+					}
+				}
+			}
+
+			/**
+			 * Get dense index of vertex
+			 * @param id id of vertex which is part of graph
+			 * @return index of id in ids
+			 */
+			size_t operator()(size_t id) const
+			{
+				return table.empty() ? size_t(std::lower_bound(ids.begin(), ids.end(), id) - ids.begin()) : table[id];
+			}
+		};
+
+		/**
+		 * Reconstructs path from predecessors of vertices reached by search (source has no predecessor)
+		 * @param predecessors map of predecessors
+		 * @param target end vertex of path
+		 * @return vertices on path from source to target
+		 */
+		template<typename Map>
+		std::vector<size_t> pathTo(const Map& predecessors, size_t target)
+		{
+			std::vector<size_t> result(1, target);
+			for (auto found = predecessors.find(target); found != predecessors.end(); found = predecessors.find(found->second))
+			{
+				result.push_back(found->second);
+			}
+			std::reverse(result.begin(), result.end());
+			return result;
+		}
+
+		/**
+		 * Reusable barrier blocking threads until all of them arrive
+		 */
+		class Barrier
+		{
+		private:
+			std::mutex mutex;
+			std::condition_variable arrived;
+			size_t count;
+			size_t waiting = 0;
+			size_t generation = 0;
+
+		public:
+			explicit Barrier(size_t count)
+				:count(count)
+			{
+			}
+
+			void wait()
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				size_t current = generation;
+				if (++waiting == count)
+				{
+					waiting = 0;
+					++generation;
+					arrived.notify_all();
+				}
+				else
+				{
+					arrived.wait(lock, [&]() { return current != generation; });
+				}
+			}
+		};
+
+		/**
+		 * Converts array indexed by dense indices of frozen graph to map indexed by vertices ids
+		 * @param graph frozen graph
+		 * @param values array of values
+		 * @return map, where key = id and value = value at dense index of id
+		 */
+		template<typename T, typename V, typename E>
+		std::map<size_t, T> toIdMap(const FrozenGraph<V,E>& graph, const std::vector<T>& values)
+		{
+			std::map<size_t, T> result;
+			for(size_t i = 0; i < values.size(); ++i)
+			{
+				result.emplace_hint(result.end(), graph.idAt(i), values[i]);
+			}
+			return result;
+		}
+
+		/**
+		 * Converts array of dense indices of frozen graph to map of vertices ids
+		 * @param graph frozen graph
+		 * @param indices array of dense indices
+		 * @return map, where key = id and value = id at dense index stored in array
+		 */
+		template<typename V, typename E>
+		std::map<size_t, size_t> toIdMapOfIds(const FrozenGraph<V,E>& graph, const std::vector<size_t>& indices)
+		{
+			std::map<size_t, size_t> result;
+			for(size_t i = 0; i < indices.size(); ++i)
+			{
+				result.emplace_hint(result.end(), graph.idAt(i), graph.idAt(indices[i]));
+			}
+			return result;
+		}
+	}
+
+	/**
+	* Depth-first search algorithm
+	* @param graph graph
+	* @param starting_vertex vertex to start search from, must be part of graph
+	* @param preorder unary function
+	* @param postorder unary function
+	*/
+	template<typename V, typename E, typename S, typename UnaryFunction1, typename UnaryFunction2>
+	void dfs(Graph<V, E, S> & graph, size_t starting_vertex, UnaryFunction1 preorder, UnaryFunction2 postorder)
+	{
+		std::map<size_t, bool> discovered;
+		auto vertmap = helper::getVerticesMap(graph);
+		if (vertmap.find(starting_vertex) == vertmap.end())
+		{
+			return;
+		}
+		for (auto & ver : vertmap)
+		{
+			discovered.emplace(ver.first, false);
+		}
+		helper::_dfs(graph, starting_vertex, preorder, postorder, discovered);
+
+		return;
+	}
+
+	/**
+	* Breadth-first search algorithm
+	* @param graph graph
+	* @param starting_vertex vertex to start search from, must be part of graph
+	* @param f unary function
+	* @return distances and paths to discovered vertices(if graph is enweighted, then shortest paths)
+	*/
+	template<typename V, typename E, typename S, typename UnaryFunction>
+	std::pair<std::map<size_t, size_t>, std::map<size_t, size_t>>
+	bfs(Graph<V, E, S> & graph, size_t starting_vertex, UnaryFunction f)
+	{
+		std::map<size_t, size_t> distance;
+		std::map<size_t, size_t> parent;
+		auto vertmap = helper::getVerticesMap(graph);
+		if (vertmap.find(starting_vertex) == vertmap.end())
+		{
+			return {distance, parent};
+		}
+		for (auto & ver : vertmap)
+		{
+			distance.emplace(ver.first, std::numeric_limits<size_t>::max());
+			parent.emplace(ver.first, ver.first);
+		}
+		std::queue<size_t> vertex_queue;
+		vertex_queue.push(starting_vertex);
+		distance.find(starting_vertex)->second = 0;
+		while (!vertex_queue.empty())
+		{
+			size_t v = vertex_queue.front();
+			vertex_queue.pop();
+			f(graph.getVertexValue(v));
+			for (auto edd : graph.getNeighboursView(v))
+			{
+				if (distance.find(edd)->second == std::numeric_limits<size_t>::max())
+				{
+					distance.find(edd)->second = distance.find(v)->second + 1;
+					parent.find(edd)->second = v;
+					vertex_queue.push(edd);
+				}
+			}
+		}
+		return {distance, parent};
+	}
+
+	/**
+	 * Bellman-Ford shortest path algorithm
+	 * @param graph graph to find shortest paths in
+	 * @param startVertex source vertex
+	 * @param infinity infinity value
+	 * @return pair of maps of <distances of each vertex from source vertex (infinity if no path exists) AND predecessors>
+	 */
+	template<typename V, typename E, typename S>
+	std::pair<std::map<size_t, E>, std::map<size_t, size_t>>
+	bellmanFord(const Graph<V,E,S>& graph, size_t startVertex, E infinity = std::numeric_limits<E>::max())
+	{
+		static_assert(std::is_default_constructible<E>::value, "Edge type must be default constructible.");
+		
+		std::map<size_t, E> distance = helper::getVerticesMap<E>(graph);
+		std::map<size_t, size_t> predecessors = helper::getVerticesMap<size_t>(graph);
+		auto graphEdges = graph.getEdgesPositionsAndValues(true);
+
+		for(auto& d : distance)
+		{
+			d.second = infinity;
+		}
+
+		for(auto& p : predecessors)
+		{
+			p.second = p.first;
+		}
+
+		distance.at(startVertex) = E();
+
+		for(size_t i = 0; i < graph.getVerticesCount() - 1; ++i)
+		{
+			for(auto& edge : graphEdges)
+			{
+				if(distance.at(std::get<0>(edge)) != infinity &&
+				        distance.at(std::get<0>(edge)) + std::get<2>(edge) < distance.at(std::get<1>(edge)))
+				{
+					distance.at(std::get<1>(edge)) = distance.at(std::get<0>(edge)) + std::get<2>(edge);
+					predecessors.at(std::get<1>(edge)) = std::get<0>(edge);
+				}
+			}
+		}
+
+		for(auto& edge : graphEdges)
+		{
+			if(distance.at(std::get<0>(edge)) != infinity &&
+			        distance.at(std::get<0>(edge)) + std::get<2>(edge) < distance.at(std::get<1>(edge)))
+			{
+				throw std::invalid_argument("Graph contains cycle of negative weight!");
+			}
+		}
+
+		return { distance, predecessors };
+	}
+
+	/**
+	 * Bellman-Ford shortest path algorithm
+	 * @param graph graph to find shortest path in
+	 * @param startVertex source vertex
+	 * @param endVertex end vertex
+	 * @param infinity infinity value
+	 * @return length of shortest path
+	 */
+	template<typename V, typename E, typename S>
+	E bellmanFordShortestPath(const Graph<V,E,S>& graph, size_t startVertex, size_t endVertex, E infinity = std::numeric_limits<E>::max())
+	{
+		return bellmanFord(graph, startVertex, infinity).first.at(endVertex);
+	}
+
+	/**
+	 * Bellman-Ford shortest path algorithm
+	 * @param graph graph to find shortest path in
+	 * @param startVertex source vertex
+	 * @param endVertex end vertex
+	 * @param infinity infinity value
+	 * @return vector of vertices ids of path ordered from start vertex to end
+	 */
+	template<typename V, typename E, typename S>
+	std::vector<size_t> bellmanFordPathVertices(const Graph<V,E,S>& graph, size_t startVertex, size_t endVertex, E infinity = std::numeric_limits<E>::max())
+	{
+		auto destination = bellmanFord(graph, startVertex, infinity);
+		std::vector<size_t> result;
+
+		if(destination.first.at(endVertex) == infinity)
+		{
+			return result;
+		}
+
+		size_t currVertex = endVertex;
+		while(currVertex != startVertex)
+		{
+			result.push_back(currVertex);
+			currVertex = destination.second.at(currVertex);
+		}
+		result.push_back(startVertex);
+
+		return std::vector<size_t> { result.rbegin(), result.rend() };
+	}
+
+	template<typename V, typename S>
+	std::map<size_t, Unweight> bellmanFord(const Graph<V,Unweight,S>&, size_t, Unweight = Unweight()) = delete;
+
+	template<typename V, typename S>
+	Unweight bellmanFordShortestPath(const Graph<V,Unweight,S>&, size_t, size_t, Unweight = Unweight()) = delete;
+
+	template<typename V, typename S>
+	std::vector<size_t> bellmanFordPathVertices(const Graph<V,Unweight,S>&, size_t, size_t, Unweight = Unweight()) = delete;
+
+	/**
+	 * Kruskal algorithm for computing minimum spanning tree (only for undirected weighted graphs)
+	 * @param graph
+	 * @return vector of source/end vertices of MST edges
+	 */
+	template<typename V, typename E, typename S>
+	std::vector<std::pair<size_t, size_t>> kruskalMST(const Graph<V, E, S>& graph)
+	{
+		if(graph.isDirected())
+		{
+			throw std::invalid_argument("Kruskal algorithm is defined only for undirected graphs.");
+		}
+
+		std::vector<std::pair<size_t, size_t>> result;
+		auto edges = graph.getEdgesPositionsAndValues();
+		std::sort(edges.begin(), edges.end(), [](auto a, auto b)
+		{
+			return std::get<2>(a) < std::get<2>(b);
+		} );
+
+		helper::UnionFind uf(helper::getVerticesMap(graph));
+
+		for(auto& edge : edges)
+		{
+			if(uf.find(std::get<0>(edge)) != uf.find(std::get<1>(edge)))
+			{
+				result.emplace_back(std::get<0>(edge), std::get<1>(edge));
+				uf.unionSets(std::get<0>(edge), std::get<1>(edge));
+			}
+		}
+
+		return result;
+	}
+
+	template<typename V, typename S>
+	std::vector<std::pair<size_t, size_t>> kruskalMST(const Graph<V, Unweight, S>& graph) = delete;
+
+	/**
+	* Dijkstra algorithm
+	* @param graph graph
+	* @param source source vertex
+	* @param infinity max value of E
+	* @return map of distances and predecessors for shortest paths
+	*/
+	template<typename V, typename E, typename S>
+	std::pair<std::map<size_t, E>, std::map<size_t, size_t>>
+	dijkstraAll(const Graph<V, E, S>& graph, size_t source, E infinity = std::numeric_limits<E>::max())
+	{
+		static_assert(std::is_default_constructible<E>::value, "Edge type must be default constructible.");
+		
+		auto vertices = helper::getVerticesMap(graph);
+		if (vertices.find(source) == vertices.end())
+		{
+			throw std::invalid_argument("source vertex id not found");
+		}
+		Heap<std::pair<size_t,E>, helper::CompareSecond<E>> vertex_queue;
+		std::map<size_t, typename Heap<std::pair<size_t, E>, helper::CompareSecond<E>>::Handle> id_handle_map;
+		std::map<size_t, E> distance = helper::getVerticesMap<E>(graph);
+		std::map<size_t, size_t> predecessors = helper::getVerticesMap<size_t>(graph);
+
+		for (auto & d : distance)
+		{
+			d.second = infinity;
+		}
+
+		for (auto & p : predecessors)
+		{
+			p.second = p.first;
+		}
+		
+		distance.at(source) = E();
+
+		for (auto & v : vertices)
+		{
+			auto h = vertex_queue.insert(std::make_pair(v.first, distance.at(v.first)));
+			id_handle_map.emplace(v.first, h);
+		}
+
+		while (!vertex_queue.empty())
+		{
+			size_t u = vertex_queue.top().first;
+			E du = vertex_queue.top().second;
+			vertex_queue.pop();
+			if (du == infinity)
+			{
+				// Remaining vertices are unreachable
+				break;
+			}
+			for (auto edge : graph.getEdgesFromView(u))
+			{
+				size_t w = edge.first;
+				E alt = du + edge.second;
+				auto wDistance = distance.find(w);
+				if (alt < wDistance->second)
+				{
+					wDistance->second = alt;
+					predecessors.at(w) = u;
+					vertex_queue.update(id_handle_map.at(w), std::make_pair(w, alt));
+				}
+			}
+		}
+		return {distance, predecessors};
+	}
+
+	/**
+	* Dijkstra algorithm with priority queue selected by tag
+	* @param graph graph
+	* @param source source vertex
+	* @param infinity max value of E
+	* @param queue tag of priority queue (LazyHeapQueue, IndexedHeapQueue<Arity>, RadixHeapQueue, DialQueue or AutoQueue)
+	* @throws invalid_argument exception if source is not part of graph
+	* @return map of distances and predecessors for shortest paths
+	*/
+	template<typename V, typename E, typename S, typename Queue>
+	std::pair<std::map<size_t, E>, std::map<size_t, size_t>>
+	dijkstraAll(const Graph<V, E, S>& graph, size_t source, E infinity, Queue)
+	{
+		static_assert(std::is_default_constructible<E>::value, "Edge type must be default constructible.");
+
+		if (!graph.hasVertex(source))
+		{
+			throw std::invalid_argument("source vertex id not found");
+		}
+		// Arrays indexed by dense indices of vertices replace maps during search
+		auto ids = graph.getVerticesIds();
+		helper::DenseIds index(ids);
+		std::vector<E> distance(ids.size(), infinity);
+		std::vector<size_t> predecessors(ids);
+
+		helper::SearchQueue<Queue, E> vertex_queue;
+		vertex_queue.reset(ids.size());
+		distance[index(source)] = E();
+		vertex_queue.push(index(source), E());
+
+		while (!vertex_queue.empty())
+		{
+			auto top = vertex_queue.pop();
+			size_t u = top.second;
+			if (distance[u] < top.first)
+			{
+				continue;
+			}
+			for (auto edge : graph.getEdgesFromView(ids[u]))
+			{
+				size_t w = index(edge.first);
+				E alt = top.first + edge.second;
+				if (alt < distance[w])
+				{
+					distance[w] = alt;
+					predecessors[w] = ids[u];
+					vertex_queue.push(w, alt);
+				}
+			}
+		}
+
+		std::map<size_t, E> distanceMap;
+		std::map<size_t, size_t> predecessorsMap;
+		for (size_t i = 0; i < ids.size(); ++i)
+		{
+			distanceMap.emplace_hint(distanceMap.end(), ids[i], distance[i]);
+			predecessorsMap.emplace_hint(predecessorsMap.end(), ids[i], predecessors[i]);
+		}
+		return { distanceMap, predecessorsMap };
+	}
+
+	/**
+	* Dijkstra algorithm from source to target, search stops once target is settled
+	*
+	* Vertices are queued when they are reached, so only vertices closer than target are expanded.
+	* @param graph graph
+	* @param source source vertex
+	* @param target target vertex
+	* @param infinity max value of E
+	* @throws invalid_argument exception if source or target is not part of graph
+	* @return distance and shortest path (infinity and only target if target is not reachable)
+	*/
+	template<typename V, typename E, typename S>
+	std::pair<E, std::vector<size_t>>
+	dijkstra(const Graph<V, E, S>& graph, size_t source, size_t target, E infinity = std::numeric_limits<E>::max())
+	{
+		static_assert(std::is_default_constructible<E>::value, "Edge type must be default constructible.");
+
+		if (!graph.hasVertex(source))
+		{
+			throw std::invalid_argument("source vertex id not found");
+		}
+		if (!graph.hasVertex(target))
+		{
+			throw std::invalid_argument("target vertex id not found");
+		}
+
+		std::unordered_map<size_t, E> distance;
+		std::unordered_map<size_t, size_t> predecessors;
+		std::priority_queue<std::pair<E, size_t>, std::vector<std::pair<E, size_t>>, helper::CompareDistance<E>> vertex_queue;
+		distance.emplace(source, E());
+		vertex_queue.emplace(E(), source);
+
+		while (!vertex_queue.empty())
+		{
+			E du = vertex_queue.top().first;
+			size_t u = vertex_queue.top().second;
+			vertex_queue.pop();
+			if (distance.at(u) < du)
+			{
+				continue;
+			}
+			if (u == target)
+			{
+				return { du, helper::pathTo(predecessors, target) };
+			}
+			for (auto edge : graph.getEdgesFromView(u))
+			{
+				E alt = du + edge.second;
+				auto found = distance.find(edge.first);
+				if (found == distance.end() || alt < found->second)
+				{
+					distance[edge.first] = alt;
+					predecessors[edge.first] = u;
+					vertex_queue.emplace(alt, edge.first);
+				}
+			}
+		}
+		return { infinity, std::vector<size_t>(1, target) };
+	}
+
+	/**
+	* Bidirectional Dijkstra algorithm from source to target
+	*
+	* Forward search from source and backward search (along incoming edges) from target are expanded
+	* alternately, the one with closer queued vertex first. Search stops once sum of distances of queued
+	* vertices of both searches reaches the shortest path found through vertex reached by both of them.
+	* Directed graph needs incoming index (setIncomingIndex), without it search falls back to dijkstra.
+	* @param graph graph
+	* @param source source vertex
+	* @param target target vertex
+	* @param infinity max value of E
+	* @throws invalid_argument exception if source or target is not part of graph
+	* @return distance and shortest path (infinity and only target if target is not reachable)
+	*/
+	template<typename V, typename E, typename S>
+	std::pair<E, std::vector<size_t>>
+	dijkstraBidirectional(const Graph<V, E, S>& graph, size_t source, size_t target, E infinity = std::numeric_limits<E>::max())
+	{
+		static_assert(std::is_default_constructible<E>::value, "Edge type must be default constructible.");
+
+		if (graph.isDirected() && !graph.hasIncomingIndex())
+		{
+			return dijkstra(graph, source, target, infinity);
+		}
+		if (!graph.hasVertex(source))
+		{
+			throw std::invalid_argument("source vertex id not found");
+		}
+		if (!graph.hasVertex(target))
+		{
+			throw std::invalid_argument("target vertex id not found");
+		}
+
+		struct Side
+		{
+			std::unordered_map<size_t, E> distance;
+			std::unordered_map<size_t, size_t> predecessors;
+			std::priority_queue<std::pair<E, size_t>, std::vector<std::pair<E, size_t>>, helper::CompareDistance<E>> vertex_queue;
+
+			// Drops outdated entries, so top of queue is distance of vertex to be settled
+			bool skipOutdated()
+			{
+				while (!vertex_queue.empty() && distance.at(vertex_queue.top().second) < vertex_queue.top().first)
+				{
+					vertex_queue.pop();
+				}
+				return !vertex_queue.empty();
+			}
+		};
+		Side forward, backward;
+		forward.distance.emplace(source, E());
+		forward.vertex_queue.emplace(E(), source);
+		backward.distance.emplace(target, E());
+		backward.vertex_queue.emplace(E(), target);
+
+		E best = infinity;
+		size_t meeting = source;
+		if (source == target)
+		{
+			best = E();
+		}
+
+		auto relax = [&](Side& side, const Side& other, size_t u, E du, size_t w, const E& value)
+		{
+			E alt = du + value;
+			auto found = side.distance.find(w);
+			if (found == side.distance.end() || alt < found->second)
+			{
+				side.distance[w] = alt;
+				side.predecessors[w] = u;
+				side.vertex_queue.emplace(alt, w);
+				auto reached = other.distance.find(w);
+				if (reached != other.distance.end() && alt + reached->second < best)
+				{
+					best = alt + reached->second;
+					meeting = w;
+				}
+			}
+		};
+
+		while (forward.skipOutdated() && backward.skipOutdated())
+		{
+			E topForward = forward.vertex_queue.top().first;
+			E topBackward = backward.vertex_queue.top().first;
+			if (best != infinity && !(topForward + topBackward < best))
+			{
+				break;
+			}
+			if (!(topBackward < topForward))
+			{
+				size_t u = forward.vertex_queue.top().second;
+				forward.vertex_queue.pop();
+				for (auto edge : graph.getEdgesFromView(u))
+				{
+					relax(forward, backward, u, topForward, edge.first, edge.second);
+				}
+			}
+			else
+			{
+				size_t u = backward.vertex_queue.top().second;
+				backward.vertex_queue.pop();
+				if (graph.isDirected())
+				{
+					for (auto edge : graph.getIncomingEdgesView(u))
+					{
+						relax(backward, forward, u, topBackward, edge.first, edge.second);
+					}
+				}
+				else
+				{
+					for (auto edge : graph.getEdgesFromView(u))
+					{
+						relax(backward, forward, u, topBackward, edge.first, edge.second);
+					}
+				}
+			}
+		}
+
+		if (best == infinity)
+		{
+			return { infinity, std::vector<size_t>(1, target) };
+		}
+		std::vector<size_t> result = helper::pathTo(forward.predecessors, meeting);
+		for (auto next = backward.predecessors.find(meeting); next != backward.predecessors.end();
+		        next = backward.predecessors.find(next->second))
+		{
+			result.push_back(next->second);
+		}
+		return { best, result };
+	}
+
+	/**
+	* A* search from source to target guided by heuristic estimate of remaining distance
+	*
+	* Vertices are expanded in order of distance from source plus estimate of distance to target,
+	* so admissible heuristic (never overestimating) pulls the search towards target. Vertices are
+	* reopened when shorter path to them is found, so heuristic does not have to be consistent.
+	* Estimate of every vertex is computed once, when vertex is reached.
+	* @param graph graph
+	* @param source source vertex
+	* @param target target vertex
+	* @param heuristic callable heuristic(vertex id, value of vertex) returning admissible estimate (E) of distance to target
+	* @param infinity max value of E
+	* @throws invalid_argument exception if source or target is not part of graph
+	* @return distance and shortest path (infinity and only target if target is not reachable)
+	*/
+	template<typename V, typename E, typename S, typename Heuristic>
+	std::pair<E, std::vector<size_t>>
+	aStar(const Graph<V, E, S>& graph, size_t source, size_t target, Heuristic heuristic, E infinity = std::numeric_limits<E>::max())
+	{
+		static_assert(std::is_default_constructible<E>::value, "Edge type must be default constructible.");
+
+		if (!graph.hasVertex(source))
+		{
+			throw std::invalid_argument("source vertex id not found");
+		}
+		if (!graph.hasVertex(target))
+		{
+			throw std::invalid_argument("target vertex id not found");
+		}
+
+		// <distance from source, estimate of distance to target> of reached vertices
+		std::unordered_map<size_t, std::pair<E, E>> scores;
+		std::unordered_map<size_t, size_t> predecessors;
+		// pairs of <distance + estimate, vertex>
+		std::priority_queue<std::pair<E, size_t>, std::vector<std::pair<E, size_t>>, helper::CompareDistance<E>> vertex_queue;
+		E estimate = heuristic(source, graph.getVertexValue(source));
+		scores.emplace(source, std::make_pair(E(), estimate));
+		vertex_queue.emplace(estimate, source);
+
+		while (!vertex_queue.empty())
+		{
+			E priority = vertex_queue.top().first;
+			size_t u = vertex_queue.top().second;
+			vertex_queue.pop();
+			const auto score = scores.at(u);
+			if (score.first + score.second < priority)
+			{
+				continue;
+			}
+			if (u == target)
+			{
+				return { score.first, helper::pathTo(predecessors, target) };
+			}
+			for (auto edge : graph.getEdgesFromView(u))
+			{
+				E alt = score.first + edge.second;
+				auto found = scores.find(edge.first);
+				if (found == scores.end())
+				{
+					found = scores.emplace(edge.first, std::make_pair(alt, heuristic(edge.first, graph.getVertexValue(edge.first)))).first;
+				}
+				else if (alt < found->second.first)
+				{
+					found->second.first = alt;
+				}
+				else
+				{
+					continue;
+				}
+				predecessors[edge.first] = u;
+				vertex_queue.emplace(alt + found->second.second, edge.first);
+			}
+		}
+		return { infinity, std::vector<size_t>(1, target) };
+	}
+
+	/**
+	* Prim's algorithm for computing minimum spanning tree (only for connected undirected weighted graphs)
+	* @param graph
+	* @param source vertex
+	* @return set of source/end vertices of MST edges
+	*/
+	template<typename V, typename E, typename S>
+	std::set<std::pair<size_t, size_t>> prim(const Graph<V, E, S>& graph, size_t source)
+	{
+		if (graph.isDirected())
+		{
+			throw std::invalid_argument("graph must be undirected");
+		}
+
+		std::set<std::pair<size_t, size_t>> result;
+
+		std::set<size_t> vertices;
+		vertices.insert(source);
+		size_t v = source;
+		//std::set<std::tuple<size_t, size_t, E>> edges;
+		std::priority_queue<std::tuple<size_t, size_t, E>, std::vector<std::tuple<size_t, size_t, E>>, helper::CompareThird<E>> edges;
+		while (vertices.size() < graph.getVerticesCount())
+		{
+			for (auto w : graph.getEdgesFromView(v))
+			{
+				if (vertices.find(w.first) == vertices.end()) edges.emplace(v, w.first, w.second);
+			}
+			//auto edge = (*std::min_element(edges.begin(), edges.end(), helper::CompareThird<E>()));
+			auto edge = edges.top();
+			if (result.find({ std::get<1>(edge), std::get<0>(edge) }) == result.end()) result.insert({ std::get<0>(edge), std::get<1>(edge) });
+			vertices.insert(std::get<1>(edge));
+			edges.pop();
+			v = std::get<1>(edge);
+		}
+
+		return result;
+	}
+
+	/**
+	* Prim's algorithm for computing minimum spanning tree (only for connected undirected weighted graphs)
+	* @param graph
+	* @return set of source/end vertices of MST edges
+	*/
+	template<typename V, typename E, typename S>
+	std::set<std::pair<size_t, size_t>> prim(const Graph<V, E, S>& graph)
+	{
+		auto graphvertices = helper::getVerticesMap(graph);
+		size_t source = (*(graphvertices.begin())).first;
+		return prim(graph, source);
+	}
+
+	/**
+	* Prim's algorithm with priority queue selected by tag (only for undirected weighted graphs)
+	*
+	* Every vertex is kept in queue with the lightest edge connecting it to the tree.
+	* @param graph
+	* @param source vertex
+	* @param queue tag of priority queue (LazyHeapQueue or IndexedHeapQueue<Arity>)
+	* @throws invalid_argument exception if graph is directed or source is not part of graph
+	* @return set of source/end vertices of MST edges (of component containing source)
+	*/
+	template<typename V, typename E, typename S, typename Queue>
+	std::set<std::pair<size_t, size_t>> prim(const Graph<V, E, S>& graph, size_t source, Queue)
+	{
+		static_assert(!helper::isMonotoneQueue<Queue, E>::value, "Prim's algorithm requires LazyHeapQueue or IndexedHeapQueue");
+
+		if (graph.isDirected())
+		{
+			throw std::invalid_argument("graph must be undirected");
+		}
+		if (!graph.hasVertex(source))
+		{
+			throw std::invalid_argument("source vertex id not found");
+		}
+
+		std::set<std::pair<size_t, size_t>> result;
+		auto ids = graph.getVerticesIds();
+		helper::DenseIds index(ids);
+		std::vector<E> lightest(ids.size());
+		std::vector<size_t> parent(ids.size());
+		std::vector<bool> reached(ids.size(), false);
+		std::vector<bool> inTree(ids.size(), false);
+
+		helper::SearchQueue<Queue, E> vertex_queue;
+		vertex_queue.reset(ids.size());
+		size_t start = index(source);
+		reached[start] = true;
+		parent[start] = start;
+		vertex_queue.push(start, E());
+
+		while (!vertex_queue.empty())
+		{
+			size_t u = vertex_queue.pop().second;
+			if (inTree[u])
+			{
+				continue;
+			}
+			inTree[u] = true;
+			if (u != start)
+			{
+				result.emplace(ids[parent[u]], ids[u]);
+			}
+			for (auto edge : graph.getEdgesFromView(ids[u]))
+			{
+				size_t w = index(edge.first);
+				if (!inTree[w] && (!reached[w] || edge.second < lightest[w]))
+				{
+					reached[w] = true;
+					lightest[w] = edge.second;
+					parent[w] = u;
+					vertex_queue.push(w, edge.second);
+				}
+			}
+		}
+		return result;
+	}
+
+	template<typename V, typename S>
+	std::vector<std::pair<size_t, size_t>> prim(const Graph<V, Unweight, S>& graph) = delete;
+
+	template<typename V, typename S>
+	std::vector<std::pair<size_t, size_t>> prim(const Graph<V, Unweight, S>& graph, size_t source) = delete;
+
+	/**
+	 * Edmonds-Karp algorithm
+	 * @param graph graph
+	 * @param source source vertex
+	 * @param sink sink vertex
+	 * @return maximum flow, graph with edges values equal to their flow
+	 */
+	template<typename V, typename E, typename S>
+	std::pair<E, Graph<V,E,S>> edmondsKarpMaxFlow(Graph<V, E, S> graph, size_t source, size_t sink)
+	{
+		static_assert(std::is_default_constructible<E>::value, "Edge type must be default constructible.");
+		
+		// Capacity graph
+		auto edges = graph.getEdgesPositions();
+
+		for(auto& e : edges)
+		{
+			if(!graph.adjacent(e.second,e.first))
+			{
+				graph.addEdge(e.second, e.first, E());
+			}
+		}
+
+		// Flow graph
+		Graph<V,E,S> graphFlow = graph;
+
+		for(auto& e : edges)
+		{
+			graphFlow.updateEdgeValue(e.first, e.second, E());
+			graphFlow.updateEdgeValue(e.second, e.first, E());
+		}
+
+		E maxFlow {};
+
+		while(true)
+		{
+			std::queue<size_t> q;
+			q.push(source);
+			// key = destination vertex; value = source vertex of edge going to key
+			std::map<size_t, size_t> pred;
+
+			while(!q.empty())
+			{
+				size_t curr = q.front();
+				q.pop();
+				for(auto e : graph.getEdgesFromView(curr))
+				{
+					if(pred.find(e.first) == pred.end() && e.first != source &&
+					        e.second > graphFlow.getEdgeValue(curr, e.first))
+					{
+						pred.emplace(e.first, curr);
+						q.push(e.first);
+					}
+				}
+			}
+
+			if(pred.find(sink) == pred.end())
+			{
+				break;
+			}
+
+			E df = std::numeric_limits<E>::max();
+
+			for(auto e = sink; e != source; e = pred.at(e))
+			{
+				df = std::min(df, graph.getEdgeValue(pred.at(e), e) - graphFlow.getEdgeValue(pred.at(e), e));
+			}
+
+			for(auto e = sink; e != source; e = pred.at(e))
+			{
+				graphFlow.updateEdgeValue(pred.at(e), e,
+				                          graphFlow.getEdgeValue(pred.at(e), e) + df);
+				graphFlow.updateEdgeValue(e, pred.at(e),
+				                          graphFlow.getEdgeValue(e, pred.at(e)) - df);
+			}
+
+			maxFlow += df;
+		}
+
+		return { maxFlow, graphFlow };
+	}
+
+	template<typename V, typename S>
+	std::pair<Unweight, Graph<V,Unweight,S>> edmondsKarpMaxFlow(Graph<V, Unweight, S> graph, size_t source, size_t sink) = delete;
+
+	/**
+	* Depth-first search algorithm on frozen graph
+	* @param graph frozen graph
+	* @param starting_vertex vertex to start search from, must be part of graph
+	* @param preorder unary function
+	* @param postorder unary function
+	*/
+	template<typename V, typename E, typename UnaryFunction1, typename UnaryFunction2>
+	void dfs(const FrozenGraph<V, E>& graph, size_t starting_vertex, UnaryFunction1 preorder, UnaryFunction2 postorder)
+	{
+		size_t start = graph.indexOf(starting_vertex);
+		if (start == FrozenGraph<V, E>::npos)
+		{
+			return;
+		}
+
+		std::vector<bool> discovered(graph.getVerticesCount(), false);
+		// pairs of <vertex, position of next edge to explore>
+		std::vector<std::pair<size_t, size_t>> stack;
+		discovered[start] = true;
+		preorder(graph.valueAt(start));
+		stack.emplace_back(start, graph.edgesBegin(start));
+
+		while (!stack.empty())
+		{
+			auto& top = stack.back();
+			if (top.second == graph.edgesEnd(top.first))
+			{
+				postorder(graph.valueAt(top.first));
+				stack.pop_back();
+				continue;
+			}
+
+			size_t w = graph.targetAt(top.second++);
+			if (!discovered[w])
+			{
+				discovered[w] = true;
+				preorder(graph.valueAt(w));
+				stack.emplace_back(w, graph.edgesBegin(w));
+			}
+		}
+	}
+
+	/**
+	* Breadth-first search algorithm on frozen graph
+	* @param graph frozen graph
+	* @param starting_vertex vertex to start search from, must be part of graph
+	* @param f unary function
+	* @return distances and paths to discovered vertices(if graph is enweighted, then shortest paths)
+	*/
+	template<typename V, typename E, typename UnaryFunction>
+	std::pair<std::map<size_t, size_t>, std::map<size_t, size_t>>
+	bfs(const FrozenGraph<V, E>& graph, size_t starting_vertex, UnaryFunction f)
+	{
+		size_t start = graph.indexOf(starting_vertex);
+		if (start == FrozenGraph<V, E>::npos)
+		{
+			return {};
+		}
+
+		const size_t n = graph.getVerticesCount();
+		std::vector<size_t> distance(n, std::numeric_limits<size_t>::max());
+		std::vector<size_t> parent(n);
+		std::iota(parent.begin(), parent.end(), 0);
+
+		// Every vertex is queued at most once, so plain vector with read position is enough
+		std::vector<size_t> vertex_queue;
+		vertex_queue.reserve(n);
+		vertex_queue.push_back(start);
+		distance[start] = 0;
+
+		for (size_t head = 0; head < vertex_queue.size(); ++head)
+		{
+			size_t v = vertex_queue[head];
+			f(graph.valueAt(v));
+			for (size_t e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e)
+			{
+				size_t w = graph.targetAt(e);
+				if (distance[w] == std::numeric_limits<size_t>::max())
+				{
+					distance[w] = distance[v] + 1;
+					parent[w] = v;
+					vertex_queue.push_back(w);
+				}
+			}
+		}
+		return { helper::toIdMap(graph, distance), helper::toIdMapOfIds(graph, parent) };
+	}
+
+	/**
+	* Breadth-first search on frozen graph processing each level in ascending order of dense indices
+	*
+	* Adjacency of every level is read in order of edge positions, so graph loaded by loadBinary
+	* is read from file mostly sequentially. Distances are the same as of bfs, f is called level by level.
+	* @param graph frozen graph
+	* @param starting_vertex vertex to start search from, must be part of graph
+	* @param f unary function
+	* @return distances and paths to discovered vertices
+	*/
+	template<typename V, typename E, typename UnaryFunction>
+	std::pair<std::map<size_t, size_t>, std::map<size_t, size_t>>
+	bfsByLevels(const FrozenGraph<V, E>& graph, size_t starting_vertex, UnaryFunction f)
+	{
+		size_t start = graph.indexOf(starting_vertex);
+		if (start == FrozenGraph<V, E>::npos)
+		{
+			return {};
+		}
+
+		const size_t n = graph.getVerticesCount();
+		std::vector<size_t> distance(n, std::numeric_limits<size_t>::max());
+		std::vector<size_t> parent(n);
+		std::iota(parent.begin(), parent.end(), 0);
+
+		std::vector<size_t> frontier(1, start);
+		std::vector<size_t> next;
+		distance[start] = 0;
+
+		while (!frontier.empty())
+		{
+			std::sort(frontier.begin(), frontier.end());
+			for (size_t v : frontier)
+			{
+				f(graph.valueAt(v));
+				for (size_t e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e)
+				{
+					size_t w = graph.targetAt(e);
+					if (distance[w] == std::numeric_limits<size_t>::max())
+					{
+						distance[w] = distance[v] + 1;
+						parent[w] = v;
+						next.push_back(w);
+					}
+				}
+			}
+			frontier.swap(next);
+			next.clear();
+		}
+		return { helper::toIdMap(graph, distance), helper::toIdMapOfIds(graph, parent) };
+	}
+
+	/**
+	 * Bellman-Ford shortest path algorithm on frozen graph
+	 * @param graph frozen graph to find shortest paths in
+	 * @param startVertex source vertex
+	 * @param infinity infinity value
+	 * @return pair of maps of <distances of each vertex from source vertex (infinity if no path exists) AND predecessors>
+	 */
+	template<typename V, typename E>
+	std::pair<std::map<size_t, E>, std::map<size_t, size_t>>
+	bellmanFord(const FrozenGraph<V,E>& graph, size_t startVertex, E infinity = std::numeric_limits<E>::max())
+	{
+		static_assert(std::is_default_constructible<E>::value, "Edge type must be default constructible.");
+
+		size_t start = graph.indexOf(startVertex);
+		if(start == FrozenGraph<V, E>::npos)
+		{
+			throw std::invalid_argument("source vertex id not found");
+		}
+
+		const size_t n = graph.getVerticesCount();
+		std::vector<E> distance(n, infinity);
+		std::vector<size_t> predecessors(n);
+		std::iota(predecessors.begin(), predecessors.end(), 0);
+		distance[start] = E();
+
+		// Relaxing can stop sooner once a whole pass does not change anything
+		bool changed = true;
+		for(size_t i = 0; i + 1 < n && changed; ++i)
+		{
+			changed = false;
+			for(size_t u = 0; u < n; ++u)
+			{
+				if(distance[u] == infinity)
+				{
+					continue;
+				}
+				for(size_t e = graph.edgesBegin(u); e < graph.edgesEnd(u); ++e)
+				{
+					size_t w = graph.targetAt(e);
+					if(distance[u] + graph.weightAt(e) < distance[w])
+					{
+						distance[w] = distance[u] + graph.weightAt(e);
+						predecessors[w] = u;
+						changed = true;
+					}
+				}
+			}
+		}
+
+		for(size_t u = 0; u < n && changed; ++u)
+		{
+			if(distance[u] == infinity)
+			{
+				continue;
+			}
+			for(size_t e = graph.edgesBegin(u); e < graph.edgesEnd(u); ++e)
+			{
+				if(distance[u] + graph.weightAt(e) < distance[graph.targetAt(e)])
+				{
+					throw std::invalid_argument("Graph contains cycle of negative weight!");
+				}
+			}
+		}
+
+		return { helper::toIdMap(graph, distance), helper::toIdMapOfIds(graph, predecessors) };
+	}
+
+	template<typename V>
+	std::map<size_t, Unweight> bellmanFord(const FrozenGraph<V,Unweight>&, size_t, Unweight = Unweight()) = delete;
+
+	/**
+	 * Kruskal algorithm for computing minimum spanning tree on frozen graph (only for undirected weighted graphs)
+	 * @param graph frozen graph
+	 * @return vector of source/end vertices of MST edges
+	 */
+	template<typename V, typename E>
+	std::vector<std::pair<size_t, size_t>> kruskalMST(const FrozenGraph<V, E>& graph)
+	{
+		if(graph.isDirected())
+		{
+			throw std::invalid_argument("Kruskal algorithm is defined only for undirected graphs.");
+		}
+
+		// Each undirected edge is stored twice, only the copy leading to greater index is taken
+		std::vector<size_t> edges;
+		std::vector<size_t> sources;
+		edges.reserve(graph.getEdgesCount() / 2 + 1);
+		sources.resize(graph.getEdgesCount());
+		for(size_t u = 0; u < graph.getVerticesCount(); ++u)
+		{
+			for(size_t e = graph.edgesBegin(u); e < graph.edgesEnd(u); ++e)
+			{
+				sources[e] = u;
+				if(u <= graph.targetAt(e))
+				{
+					edges.push_back(e);
+				}
+			}
+		}
+
+		std::sort(edges.begin(), edges.end(), [&graph](size_t a, size_t b)
+		{
+			return graph.weightAt(a) < graph.weightAt(b);
+		});
+
+		std::vector<std::pair<size_t, size_t>> result;
+		helper::DenseUnionFind uf(graph.getVerticesCount());
+
+		for(size_t e : edges)
+		{
+			if(uf.find(sources[e]) != uf.find(graph.targetAt(e)))
+			{
+				result.emplace_back(graph.idAt(sources[e]), graph.idAt(graph.targetAt(e)));
+				uf.unionSets(sources[e], graph.targetAt(e));
+			}
+		}
+
+		return result;
+	}
+
+	template<typename V>
+	std::vector<std::pair<size_t, size_t>> kruskalMST(const FrozenGraph<V, Unweight>& graph) = delete;
+
+	/**
+	 * Result of single source shortest paths search indexed by dense indices of frozen graph
+	 */
+	template<typename E>
+	struct ShortestPaths
+	{
+		// Distance of each vertex from source (infinity if vertex was not reached)
+		std::vector<E> distance;
+		// Dense index of predecessor on shortest path (vertex itself for source and unreached vertices)
+		std::vector<size_t> predecessor;
+
+		/**
+		 * Get shortest path from source
+		 * @param target dense index of end vertex
+		 * @return dense indices of vertices on path from source to target (only target if it was not reached)
+		 */
+		std::vector<size_t> path(size_t target) const
+		{
+			std::vector<size_t> result(1, target);
+			while (predecessor[target] != target)
+			{
+				target = predecessor[target];
+				result.push_back(target);
+			}
+			std::reverse(result.begin(), result.end());
+			return result;
+		}
+	};
+
+	/**
+	 * Reusable Dijkstra search on frozen graph working with dense indices
+	 *
+	 * Arrays of distances and predecessors are allocated once and only entries reached by previous run
+	 * are reset, so repeated searches on large graph cost only the part of graph they reach.
+	 * Neighbours and weights of edges are read together from CSR arrays.
+	 * Priority queue is selected by tag Queue (LazyHeapQueue, IndexedHeapQueue<Arity>, RadixHeapQueue, DialQueue or AutoQueue).
+	 */
+	template<typename V, typename E, typename Queue = AutoQueue>
+	class DijkstraSearch
+	{
+	private:
+		const FrozenGraph<V, E>* graph;
+		E infinity;
+		ShortestPaths<E> result;
+		std::vector<size_t> reached;
+		helper::SearchQueue<Queue, E> queue;
+
+	public:
+		/**
+		 * Creates search for graph (graph has to outlive the search)
+		 * @param graph frozen graph
+		 * @param infinity max value of E
+		 */
+		explicit DijkstraSearch(const FrozenGraph<V, E>& graph, E infinity = std::numeric_limits<E>::max())
+			:graph(&graph), infinity(infinity)
+		{
+			static_assert(std::is_default_constructible<E>::value, "Edge type must be default constructible.");
+
+			const size_t n = graph.getVerticesCount();
+			result.distance.assign(n, infinity);
+			result.predecessor.resize(n);
+			std::iota(result.predecessor.begin(), result.predecessor.end(), 0);
+		}
+
+		/**
+		 * Finds shortest paths from source to all vertices or until target is settled
+		 * @param source dense index of source vertex
+		 * @param target dense index of vertex at which search stops (distances of vertices farther than
+		 *        target are not final), npos to search whole graph
+		 * @throws invalid_argument exception if index is out of range
+		 * @return distances and predecessors, valid until next run
+		 */
+		const ShortestPaths<E>& run(size_t source, size_t target = FrozenGraph<V, E>::npos)
+		{
+			if (source >= result.distance.size())
+			{
+				throw std::invalid_argument("source vertex index out of range");
+			}
+
+			for (size_t v : reached)
+			{
+				result.distance[v] = infinity;
+				result.predecessor[v] = v;
+			}
+			reached.clear();
+
+			result.distance[source] = E();
+			reached.push_back(source);
+			queue.reset(result.distance.size());
+			queue.push(source, E());
+
+			while (!queue.empty())
+			{
+				auto top = queue.pop();
+				E d = top.first;
+				size_t u = top.second;
+				// Outdated entry of lazy queue
+				if (result.distance[u] < d)
+				{
+					continue;
+				}
+				if (u == target)
+				{
+					break;
+				}
+
+				const size_t last = graph->edgesEnd(u);
+				for (size_t e = graph->edgesBegin(u); e < last; ++e)
+				{
+					size_t w = graph->targetAt(e);
+					E alt = d + graph->weightAt(e);
+					if (alt < result.distance[w])
+					{
+						if (result.distance[w] == infinity)
+						{
+							reached.push_back(w);
+						}
+						result.distance[w] = alt;
+						result.predecessor[w] = u;
+						queue.push(w, alt);
+					}
+				}
+			}
+			return result;
+		}
+
+		/**
+		 * Get result of last run
+		 * @return distances and predecessors
+		 */
+		const ShortestPaths<E>& paths() const
+		{
+			return result;
+		}
+
+		/**
+		 * Get dense indices of vertices reached by last run (in order they were reached)
+		 * @return reached vertices
+		 */
+		const std::vector<size_t>& reachedVertices() const
+		{
+			return reached;
+		}
+	};
+
+	/**
+	* Dijkstra algorithm on frozen graph returning arrays indexed by dense indices
+	* @param graph frozen graph
+	* @param source source vertex
+	* @param infinity max value of E
+	* @param queue tag of priority queue (LazyHeapQueue, IndexedHeapQueue<Arity>, RadixHeapQueue, DialQueue or AutoQueue)
+	* @throws invalid_argument exception if source is not part of graph
+	* @return distances and predecessors (use DijkstraSearch for repeated searches on the same graph)
+	*/
+	template<typename V, typename E, typename Queue = AutoQueue>
+	ShortestPaths<E> dijkstraDense(const FrozenGraph<V, E>& graph, size_t source, E infinity = std::numeric_limits<E>::max(),
+	                               Queue = Queue())
+	{
+		size_t start = graph.indexOf(source);
+		if (start == FrozenGraph<V, E>::npos)
+		{
+			throw std::invalid_argument("source vertex id not found");
+		}
+		DijkstraSearch<V, E, Queue> search(graph, infinity);
+		search.run(start);
+		return search.paths();
+	}
+
+	/**
+	* Dijkstra algorithm on frozen graph
+	* @param graph frozen graph
+	* @param source source vertex
+	* @param infinity max value of E
+	* @param queue tag of priority queue (LazyHeapQueue, IndexedHeapQueue<Arity>, RadixHeapQueue, DialQueue or AutoQueue)
+	* @return map of distances and predecessors for shortest paths
+	*/
+	template<typename V, typename E, typename Queue = AutoQueue>
+	std::pair<std::map<size_t, E>, std::map<size_t, size_t>>
+	dijkstraAll(const FrozenGraph<V, E>& graph, size_t source, E infinity = std::numeric_limits<E>::max(),
+	            Queue = Queue())
+	{
+		auto paths = dijkstraDense(graph, source, infinity, Queue());
+		return { helper::toIdMap(graph, paths.distance), helper::toIdMapOfIds(graph, paths.predecessor) };
+	}
+
+	/**
+	* Dijkstra algorithm on frozen graph from source to target, search stops once target is settled
+	* @param graph frozen graph
+	* @param source source vertex
+	* @param target target vertex
+	* @param infinity max value of E
+	* @param queue tag of priority queue (LazyHeapQueue, IndexedHeapQueue<Arity>, RadixHeapQueue, DialQueue or AutoQueue)
+	* @throws invalid_argument exception if source or target is not part of graph
+	* @return distance and shortest path (infinity and only target if target is not reachable),
+	*         use DijkstraSearch::run(source, target) for repeated searches on the same graph
+	*/
+	template<typename V, typename E, typename Queue = AutoQueue>
+	std::pair<E, std::vector<size_t>>
+	dijkstra(const FrozenGraph<V, E>& graph, size_t source, size_t target, E infinity = std::numeric_limits<E>::max(),
+	         Queue = Queue())
+	{
+		size_t start = graph.indexOf(source);
+		size_t end = graph.indexOf(target);
+		if (start == FrozenGraph<V, E>::npos)
+		{
+			throw std::invalid_argument("source vertex id not found");
+		}
+		if (end == FrozenGraph<V, E>::npos)
+		{
+			throw std::invalid_argument("target vertex id not found");
+		}
+
+		DijkstraSearch<V, E, Queue> search(graph, infinity);
+		const auto& paths = search.run(start, end);
+		std::vector<size_t> result;
+		for (size_t v : paths.path(end))
+		{
+			result.push_back(graph.idAt(v));
+		}
+		return { paths.distance[end], result };
+	}
+
+	/**
+	 * Reusable bidirectional Dijkstra search on frozen graph
+	 *
+	 * Forward search from source and backward search (on transposed graph) from target are expanded
+	 * alternately, the one with closer queued vertex first. Search stops once sum of distances of queued
+	 * vertices of both searches reaches the shortest path found through vertex reached by both of them.
+	 * Transposed graph of directed graph is built once by constructor and arrays are reset only where
+	 * previous query reached, so every query costs only the vertices explored around its endpoints.
+	 */
+	template<typename V, typename E, typename Queue = AutoQueue>
+	class BidirectionalDijkstra
+	{
+	private:
+		struct Side
+		{
+			const FrozenGraph<V, E>* graph;
+			std::vector<E> distance;
+			std::vector<size_t> predecessor;
+			std::vector<size_t> reached;
+			helper::SearchQueue<Queue, E> queue;
+		};
+
+		const FrozenGraph<V, E>* graph;
+		std::unique_ptr<FrozenGraph<V, E>> transposed;
+		E infinity;
+		Side forward;
+		Side backward;
+
+		void start(Side& side, size_t source)
+		{
+			for (size_t v : side.reached)
+			{
+				side.distance[v] = infinity;
+				side.predecessor[v] = v;
+			}
+			side.reached.assign(1, source);
+			side.distance[source] = E();
+			side.queue.reset(side.distance.size());
+			side.queue.push(source, E());
+		}
+
+		// Drops outdated entries, so top of queue is distance of vertex to be settled
+		static bool skipOutdated(Side& side)
+		{
+			while (!side.queue.empty() && side.distance[side.queue.top().second] < side.queue.top().first)
+			{
+				side.queue.pop();
+			}
+			return !side.queue.empty();
+		}
+
+	public:
+		/**
+		 * Creates search for graph (graph has to outlive the search)
+		 * @param graph frozen graph
+		 * @param infinity max value of E
+		 */
+		explicit BidirectionalDijkstra(const FrozenGraph<V, E>& graph, E infinity = std::numeric_limits<E>::max())
+			:graph(&graph), infinity(infinity)
+		{
+			static_assert(std::is_default_constructible<E>::value, "Edge type must be default constructible.");
+
+			if (graph.isDirected())
+			{
+				transposed.reset(new FrozenGraph<V, E>(transpose(graph)));
+			}
+			forward.graph = &graph;
+			backward.graph = transposed ? transposed.get() : &graph;
+			for (Side* side : { &forward, &backward })
+			{
+				side->distance.assign(graph.getVerticesCount(), infinity);
+				side->predecessor.resize(graph.getVerticesCount());
+				std::iota(side->predecessor.begin(), side->predecessor.end(), 0);
+			}
+		}
+
+		/**
+		 * Finds shortest path from source to target
+		 * @param source source vertex
+		 * @param target target vertex
+		 * @throws invalid_argument exception if source or target is not part of graph
+		 * @return distance and shortest path (infinity and only target if target is not reachable)
+		 */
+		std::pair<E, std::vector<size_t>> query(size_t source, size_t target)
+		{
+			size_t first = graph->indexOf(source);
+			size_t last = graph->indexOf(target);
+			if (first == FrozenGraph<V, E>::npos)
+			{
+				throw std::invalid_argument("source vertex id not found");
+			}
+			if (last == FrozenGraph<V, E>::npos)
+			{
+				throw std::invalid_argument("target vertex id not found");
+			}
+
+			start(forward, first);
+			start(backward, last);
+			E best = first == last ? E() : infinity;
+			size_t meeting = first;
+
+			while (skipOutdated(forward) && skipOutdated(backward))
+			{
+				E topForward = forward.queue.top().first;
+				E topBackward = backward.queue.top().first;
+				if (best != infinity && !(topForward + topBackward < best))
+				{
+					break;
+				}
+				Side& side = topBackward < topForward ? backward : forward;
+				const Side& other = topBackward < topForward ? forward : backward;
+
+				auto top = side.queue.pop();
+				size_t u = top.second;
+				const size_t end = side.graph->edgesEnd(u);
+				for (size_t e = side.graph->edgesBegin(u); e < end; ++e)
+				{
+					size_t w = side.graph->targetAt(e);
+					E alt = top.first + side.graph->weightAt(e);
+					if (alt < side.distance[w])
+					{
+						if (side.distance[w] == infinity)
+						{
+							side.reached.push_back(w);
+						}
+						side.distance[w] = alt;
+						side.predecessor[w] = u;
+						side.queue.push(w, alt);
+						if (other.distance[w] != infinity && alt + other.distance[w] < best)
+						{
+							best = alt + other.distance[w];
+							meeting = w;
+						}
+					}
+				}
+			}
+
+			if (best == infinity)
+			{
+				return { infinity, std::vector<size_t>(1, target) };
+			}
+			std::vector<size_t> result;
+			for (size_t v = meeting; ; v = forward.predecessor[v])
+			{
+				result.push_back(graph->idAt(v));
+				if (v == first)
+				{
+					break;
+				}
+			}
+			std::reverse(result.begin(), result.end());
+			for (size_t v = meeting; v != last; )
+			{
+				v = backward.predecessor[v];
+				result.push_back(graph->idAt(v));
+			}
+			return { best, result };
+		}
+	};
+
+	/**
+	* Bidirectional Dijkstra algorithm on frozen graph from source to target
+	* (directed graph is transposed on every call, use BidirectionalDijkstra for repeated queries)
+	* @param graph frozen graph
 	* @param source source vertex
+	* @param target target vertex
 	* @param infinity max value of E
-	* @return map of distances and predecessors for shortest paths
+	* @throws invalid_argument exception if source or target is not part of graph
+	* @return distance and shortest path (infinity and only target if target is not reachable)
 	*/
 	template<typename V, typename E>
-	std::pair<std::map<size_t, E>, std::map<size_t, size_t>>
-	dijkstraAll(const Graph<V, E>& graph, size_t source, E infinity)
+	std::pair<E, std::vector<size_t>>
+	dijkstraBidirectional(const FrozenGraph<V, E>& graph, size_t source, size_t target, E infinity = std::numeric_limits<E>::max())
+	{
+		BidirectionalDijkstra<V, E> search(graph, infinity);
+		return search.query(source, target);
+	}
+
+	/**
+	* A* search on frozen graph from source to target guided by heuristic estimate of remaining distance, see aStar
+	* @param graph frozen graph
+	* @param source source vertex
+	* @param target target vertex
+	* @param heuristic callable heuristic(vertex id, value of vertex) returning admissible estimate (E) of distance to target
+	* @param infinity max value of E
+	* @param queue tag of priority queue (LazyHeapQueue or IndexedHeapQueue<Arity>, priorities are not monotone)
+	* @throws invalid_argument exception if source or target is not part of graph
+	* @return distance and shortest path (infinity and only target if target is not reachable)
+	*/
+	template<typename V, typename E, typename Heuristic, typename Queue = LazyHeapQueue>
+	std::pair<E, std::vector<size_t>>
+	aStar(const FrozenGraph<V, E>& graph, size_t source, size_t target, Heuristic heuristic,
+	      E infinity = std::numeric_limits<E>::max(), Queue = Queue())
 	{
 		static_assert(std::is_default_constructible<E>::value, "Edge type must be default constructible.");
-		
-		auto vertices = helper::getVerticesMap(graph);
-		if (vertices.find(source) == vertices.end())
+		static_assert(!helper::isMonotoneQueue<Queue, E>::value, "A* search requires LazyHeapQueue or IndexedHeapQueue");
+
+		size_t start = graph.indexOf(source);
+		size_t end = graph.indexOf(target);
+		if (start == FrozenGraph<V, E>::npos)
 		{
 			throw std::invalid_argument("source vertex id not found");
 		}
-		Heap<std::pair<size_t,E>, helper::CompareSecond<E>> vertex_queue;
-		std::map<size_t, typename Heap<std::pair<size_t, E>, helper::CompareSecond<E>>::Handle> id_handle_map;
-		std::map<size_t, E> distance = helper::getVerticesMap<E>(graph);
-		std::map<size_t, size_t> predecessors = helper::getVerticesMap<size_t>(graph);
-		auto graphEdges = graph.getEdgesPositions();
+		if (end == FrozenGraph<V, E>::npos)
+		{
+			throw std::invalid_argument("target vertex id not found");
+		}
 
-		for (auto & d : distance)
+		const size_t n = graph.getVerticesCount();
+		ShortestPaths<E> paths;
+		paths.distance.assign(n, infinity);
+		paths.predecessor.resize(n);
+		std::iota(paths.predecessor.begin(), paths.predecessor.end(), 0);
+		// Estimates of reached vertices
+		std::vector<E> estimate(n);
+
+		helper::SearchQueue<Queue, E> vertex_queue;
+		vertex_queue.reset(n);
+		paths.distance[start] = E();
+		estimate[start] = heuristic(source, graph.valueAt(start));
+		vertex_queue.push(start, estimate[start]);
+
+		while (!vertex_queue.empty())
 		{
-			d.second = infinity;
+			auto top = vertex_queue.pop();
+			size_t u = top.second;
+			const E d = paths.distance[u];
+			// Outdated entry of lazy queue
+			if (d + estimate[u] < top.first)
+			{
+				continue;
+			}
+			if (u == end)
+			{
+				break;
+			}
+			const size_t last = graph.edgesEnd(u);
+			for (size_t e = graph.edgesBegin(u); e < last; ++e)
+			{
+				size_t w = graph.targetAt(e);
+				E alt = d + graph.weightAt(e);
+				if (alt < paths.distance[w])
+				{
+					if (paths.distance[w] == infinity)
+					{
+						estimate[w] = heuristic(graph.idAt(w), graph.valueAt(w));
+					}
+					paths.distance[w] = alt;
+					paths.predecessor[w] = u;
+					vertex_queue.push(w, alt + estimate[w]);
+				}
+			}
 		}
 
-		for (auto & p : predecessors)
+		std::vector<size_t> result;
+		for (size_t v : paths.path(end))
 		{
-			p.second = p.first;
+			result.push_back(graph.idAt(v));
 		}
-		
-		distance.at(source) = E();
+		return { paths.distance[end], result };
+	}
 
-		for (auto & v : vertices)
+	/**
+	* Parallel delta-stepping single source shortest paths on frozen graph (only for non-negative arithmetic edge values)
+	*
+	* Vertices are kept in buckets of width delta by their tentative distance. Vertices of the lowest
+	* non-empty bucket are expanded in parallel: light edges (value <= delta) repeatedly until the bucket
+	* stays empty, then heavy edges once. Every thread owns vertices (by dense index modulo count of threads)
+	* together with their buckets, relaxation requests are routed to the owner of target vertex, which applies
+	* them and buckets improved vertices, so there is no serial step between phases. Buckets of each owner
+	* form circular array, as queued vertices lie at most max edge value / delta buckets above the current one.
+	* Ties are resolved by the lowest predecessor, so result does not depend on count of threads.
+	* Distances are the same as of dijkstraAll, predecessors form tree of shortest paths (the same as of
+	* dijkstraAll if shortest paths are unique).
+	* @param graph frozen graph
+	* @param source source vertex
+	* @param delta width of bucket, E() selects average edge value
+	* @param threads count of threads, 0 selects count of hardware threads
+	* @param infinity max value of E
+	* @throws invalid_argument exception if source is not part of graph or graph has negative edge
+	* @return distances and predecessors indexed by dense indices
+	*/
+	template<typename V, typename E>
+	ShortestPaths<E> deltaSteppingDense(const FrozenGraph<V, E>& graph, size_t source, E delta = E(), size_t threads = 0,
+	                                    E infinity = std::numeric_limits<E>::max())
+	{
+		static_assert(std::is_arithmetic<E>::value, "Edge type must be arithmetic.");
+
+		size_t start = graph.indexOf(source);
+		if (start == FrozenGraph<V, E>::npos)
 		{
-			auto h = vertex_queue.insert(std::make_pair(v.first, distance.at(v.first)));
-			id_handle_map.emplace(v.first, h);
+			throw std::invalid_argument("source vertex id not found");
 		}
 
-		while (!vertex_queue.empty())
+		const size_t n = graph.getVerticesCount();
+		const size_t m = graph.getEdgesCount();
+		double total = 0;
+		E maxWeight = E();
+		for (size_t e = 0; e < m; ++e)
 		{
-			size_t u = vertex_queue.top().first;
-			vertex_queue.pop();
-			for (auto & w : graph.getNeighbours(u))
+			if (graph.weightAt(e) < E())
+			{
+				throw std::invalid_argument("graph contains negative edge");
+			}
+			total += double(graph.weightAt(e));
+			maxWeight = std::max(maxWeight, graph.weightAt(e));
+		}
+		if (!(E() < delta))
+		{
+			delta = m > 0 ? E(total / double(m)) : E(1);
+			if (!(E() < delta))
+			{
+				delta = E(1);
+			}
+		}
+		if (threads == 0)
+		{
+			threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+		}
+
+		ShortestPaths<E> result;
+		result.distance.assign(n, infinity);
+		result.predecessor.resize(n);
+		std::iota(result.predecessor.begin(), result.predecessor.end(), 0);
+		auto& distance = result.distance;
+		auto& predecessor = result.predecessor;
+
+		struct Request
+		{
+			size_t target;
+			size_t from;
+			E distance;
+		};
+		struct Owned
+		{
+			std::vector<std::vector<size_t>> buckets;
+			std::vector<size_t> frontier;
+			// Vertices expanded in current bucket, their heavy edges are relaxed once the bucket stays empty
+			std::vector<size_t> expanded;
+		};
+		const size_t npos = std::numeric_limits<size_t>::max();
+		const size_t window = size_t(maxWeight / delta) + 2;
+		std::vector<Owned> owned(threads);
+		for (auto& own : owned)
+		{
+			own.buckets.resize(window);
+		}
+		// requests[s][t] are requests generated by thread s for vertices owned by thread t
+		std::vector<std::vector<std::vector<Request>>> requests(threads, std::vector<std::vector<Request>>(threads));
+		// Sizes of frontiers and lowest non-empty buckets reported by threads, double buffered,
+		// as thread may report next step while others still read the current one
+		std::vector<size_t> frontierSizes(2 * threads);
+		std::vector<size_t> nextBuckets(2 * threads);
+		// Last step in which vertex was put to frontier or improved and last bucket in which it was expanded,
+		// each vertex is accessed only by its owner
+		std::vector<size_t> queuedStep(n, npos);
+		std::vector<size_t> improvedStep(n, npos);
+		std::vector<size_t> expandedBucket(n, npos);
+
+		auto bucketOf = [&](E d) { return size_t(d / delta); };
+
+		distance[start] = E();
+		owned[start % threads].buckets[0].push_back(start);
+
+		helper::Barrier barrier(threads);
+		auto worker = [&](size_t t)
+		{
+			Owned& own = owned[t];
+			size_t current = 0;
+			size_t step = 0;
+			bool heavy = false;
+			while (true)
 			{
-				E alt = (distance.at(u) != infinity)? (distance.at(u) + graph.getEdgeValue(u, w)) : infinity;
-				if (alt < distance.at(w))
+				// Owned part of frontier - vertices of current bucket (which may be outdated or repeated),
+				// after the bucket stays empty vertices expanded in it
+				own.frontier.clear();
+				if (heavy)
 				{
-					distance.at(w) = alt;
-					predecessors.at(w) = u;
-					vertex_queue.update(id_handle_map.at(w), std::make_pair(w, alt));
+					own.frontier.swap(own.expanded);
+				}
+				else
+				{
+					auto& bucket = own.buckets[current % window];
+					for (size_t v : bucket)
+					{
+						if (bucketOf(distance[v]) == current && queuedStep[v] != step)
+						{
+							queuedStep[v] = step;
+							own.frontier.push_back(v);
+							if (expandedBucket[v] != current)
+							{
+								expandedBucket[v] = current;
+								own.expanded.push_back(v);
+							}
+						}
+					}
+					bucket.clear();
+				}
+				size_t next = npos;
+				for (size_t i = 1; i < window && next == npos; ++i)
+				{
+					if (!own.buckets[(current + i) % window].empty())
+					{
+						next = current + i;
+					}
+				}
+				const size_t reported = (step % 2) * threads;
+				frontierSizes[reported + t] = own.frontier.size();
+				nextBuckets[reported + t] = next;
+				++step;
+				barrier.wait();
+
+				size_t frontierSize = 0;
+				for (size_t s = 0; s < threads; ++s)
+				{
+					frontierSize += frontierSizes[reported + s];
+					next = std::min(next, nextBuckets[reported + s]);
+				}
+				if (frontierSize == 0)
+				{
+					if (!heavy)
+					{
+						heavy = true;
+						continue;
+					}
+					if (next == npos)
+					{
+						return;
+					}
+					heavy = false;
+					current = next;
+					continue;
+				}
+
+				// Requests are generated from owned part of frontier, distances are only read in this phase
+				for (size_t u : own.frontier)
+				{
+					E du = distance[u];
+					for (size_t e = graph.edgesBegin(u); e < graph.edgesEnd(u); ++e)
+					{
+						const E& weight = graph.weightAt(e);
+						if ((delta < weight) != heavy)
+						{
+							continue;
+						}
+						size_t w = graph.targetAt(e);
+						E alt = du + weight;
+						if (alt < distance[w])
+						{
+							requests[t][w % threads].push_back(Request{ w, u, alt });
+						}
+					}
+				}
+				barrier.wait();
+
+				// Owned vertices are updated by single thread, improved ones are put to its buckets
+				for (size_t s = 0; s < threads; ++s)
+				{
+					for (const Request& request : requests[s][t])
+					{
+						size_t w = request.target;
+						if (request.distance < distance[w])
+						{
+							distance[w] = request.distance;
+							predecessor[w] = request.from;
+							improvedStep[w] = step;
+							own.buckets[bucketOf(request.distance) % window].push_back(w);
+						}
+						else if (request.distance == distance[w] && improvedStep[w] == step && request.from < predecessor[w])
+						{
+							predecessor[w] = request.from;
+						}
+					}
+					requests[s][t].clear();
 				}
 			}
+		};
+
+		std::vector<std::thread> pool;
+		for (size_t t = 1; t < threads; ++t)
+		{
+			pool.emplace_back(worker, t);
 		}
-		return {distance, predecessors};
+		worker(0);
+		for (auto& thread : pool)
+		{
+			thread.join();
+		}
+		return result;
 	}
 
 	/**
-	* Dijkstra algorithm
-	* @param graph graph
+	* Parallel delta-stepping single source shortest paths on frozen graph, see deltaSteppingDense
+	* @param graph frozen graph
 	* @param source source vertex
-	* @param target target vertex
+	* @param delta width of bucket, E() selects average edge value
+	* @param threads count of threads, 0 selects count of hardware threads
 	* @param infinity max value of E
-	* @return distance and shortest path
+	* @return map of distances and predecessors for shortest paths
 	*/
 	template<typename V, typename E>
-	std::pair<E, std::vector<size_t>>
-	dijkstra(const Graph<V, E>& graph, size_t source, size_t target, E infinity = std::numeric_limits<E>::max())
+	std::pair<std::map<size_t, E>, std::map<size_t, size_t>>
+	deltaStepping(const FrozenGraph<V, E>& graph, size_t source, E delta = E(), size_t threads = 0,
+	              E infinity = std::numeric_limits<E>::max())
 	{
-		auto dAll = dijkstraAll(graph, source, infinity);
-		std::vector<size_t> result;
-		size_t u = target;
-		while (dAll.second.at(u) != u)
-		{
-			result.push_back(u);
-			u = dAll.second.at(u);
-		}
-		result.push_back(u);
-		std::reverse(result.begin(), result.end());
-		return { dAll.first.at(target), result };
+		auto paths = deltaSteppingDense(graph, source, delta, threads, infinity);
+		return { helper::toIdMap(graph, paths.distance), helper::toIdMapOfIds(graph, paths.predecessor) };
 	}
 
 	/**
-	* Prim's algorithm for computing minimum spanning tree (only for connected undirected weighted graphs)
-	* @param graph
+	* Parallel delta-stepping single source shortest paths, runs on frozen snapshot of graph, see deltaSteppingDense
+	* @param graph graph
+	* @param source source vertex
+	* @param delta width of bucket, E() selects average edge value
+	* @param threads count of threads, 0 selects count of hardware threads
+	* @param infinity max value of E
+	* @return map of distances and predecessors for shortest paths
+	*/
+	template<typename V, typename E, typename S>
+	std::pair<std::map<size_t, E>, std::map<size_t, size_t>>
+	deltaStepping(const Graph<V, E, S>& graph, size_t source, E delta = E(), size_t threads = 0,
+	              E infinity = std::numeric_limits<E>::max())
+	{
+		return deltaStepping(freeze(graph), source, delta, threads, infinity);
+	}
+
+	/**
+	* Prim's algorithm for computing minimum spanning tree on frozen graph (only for undirected weighted graphs)
+	* @param graph frozen graph
 	* @param source vertex
-	* @return set of source/end vertices of MST edges
+	* @return set of source/end vertices of MST edges (of component containing source)
 	*/
 	template<typename V, typename E>
-	std::set<std::pair<size_t, size_t>> prim(const Graph<V, E>& graph, size_t source)
+	std::set<std::pair<size_t, size_t>> prim(const FrozenGraph<V, E>& graph, size_t source)
 	{
 		if (graph.isDirected())
 		{
@@ -487,132 +2529,279 @@ namespace Graph
 		}
 
 		std::set<std::pair<size_t, size_t>> result;
+		size_t start = graph.indexOf(source);
+		if (start == FrozenGraph<V, E>::npos)
+		{
+			throw std::invalid_argument("source vertex id not found");
+		}
 
-		std::set<size_t> vertices;
-		vertices.insert(source);
-		size_t v = source;
-		//std::set<std::tuple<size_t, size_t, E>> edges;
-		std::priority_queue<std::tuple<size_t, size_t, E>, std::vector<std::tuple<size_t, size_t, E>>, helper::CompareThird<E>> edges;
-		while (vertices.size() < graph.getVerticesCount())
+		std::vector<bool> inTree(graph.getVerticesCount(), false);
+		// pairs of <edge value, edge position>, sources of edges are kept separately
+		std::priority_queue<std::pair<E, size_t>, std::vector<std::pair<E, size_t>>, helper::CompareDistance<E>> edges;
+		std::vector<size_t> sources(graph.getEdgesCount());
+
+		auto addVertex = [&](size_t v)
 		{
-			auto vedges = graph.getEdgesFrom(v);
-			for (auto & w : vedges)
+			inTree[v] = true;
+			for (size_t e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e)
 			{
-				if (vertices.find(w.first) == vertices.end()) edges.emplace(v, w.first, w.second);
+				if (!inTree[graph.targetAt(e)])
+				{
+					sources[e] = v;
+					edges.emplace(graph.weightAt(e), e);
+				}
 			}
-			//auto edge = (*std::min_element(edges.begin(), edges.end(), helper::CompareThird<E>()));
-			auto edge = edges.top();
-			if (result.find({ std::get<1>(edge), std::get<0>(edge) }) == result.end()) result.insert({ std::get<0>(edge), std::get<1>(edge) });
-			vertices.insert(std::get<1>(edge));
+		};
+
+		addVertex(start);
+		while (!edges.empty())
+		{
+			size_t e = edges.top().second;
 			edges.pop();
-			v = std::get<1>(edge);
+			size_t w = graph.targetAt(e);
+			if (inTree[w])
+			{
+				continue;
+			}
+			result.emplace(graph.idAt(sources[e]), graph.idAt(w));
+			addVertex(w);
 		}
 
 		return result;
 	}
 
 	/**
-	* Prim's algorithm for computing minimum spanning tree (only for connected undirected weighted graphs)
-	* @param graph
+	* Prim's algorithm for computing minimum spanning tree on frozen graph (only for undirected weighted graphs)
+	* @param graph frozen graph
 	* @return set of source/end vertices of MST edges
 	*/
 	template<typename V, typename E>
-	std::set<std::pair<size_t, size_t>> prim(const Graph<V, E>& graph)
+	std::set<std::pair<size_t, size_t>> prim(const FrozenGraph<V, E>& graph)
 	{
-		auto graphvertices = helper::getVerticesMap(graph);
-		size_t source = (*(graphvertices.begin())).first;
-		return prim(graph, source);
+		if (graph.getVerticesCount() == 0)
+		{
+			return {};
+		}
+		return prim(graph, graph.idAt(0));
+	}
+
+	/**
+	* Prim's algorithm on frozen graph with priority queue selected by tag (only for undirected weighted graphs)
+	*
+	* Every vertex is kept in queue with the lightest edge connecting it to the tree.
+	* @param graph frozen graph
+	* @param source vertex
+	* @param queue tag of priority queue (LazyHeapQueue or IndexedHeapQueue<Arity>)
+	* @throws invalid_argument exception if graph is directed or source is not part of graph
+	* @return set of source/end vertices of MST edges (of component containing source)
+	*/
+	template<typename V, typename E, typename Queue>
+	std::set<std::pair<size_t, size_t>> prim(const FrozenGraph<V, E>& graph, size_t source, Queue)
+	{
+		static_assert(!helper::isMonotoneQueue<Queue, E>::value, "Prim's algorithm requires LazyHeapQueue or IndexedHeapQueue");
+
+		if (graph.isDirected())
+		{
+			throw std::invalid_argument("graph must be undirected");
+		}
+		size_t start = graph.indexOf(source);
+		if (start == FrozenGraph<V, E>::npos)
+		{
+			throw std::invalid_argument("source vertex id not found");
+		}
+
+		std::set<std::pair<size_t, size_t>> result;
+		const size_t n = graph.getVerticesCount();
+		std::vector<E> lightest(n);
+		std::vector<size_t> parent(n);
+		std::vector<bool> reached(n, false);
+		std::vector<bool> inTree(n, false);
+
+		helper::SearchQueue<Queue, E> vertex_queue;
+		vertex_queue.reset(n);
+		reached[start] = true;
+		parent[start] = start;
+		vertex_queue.push(start, E());
+
+		while (!vertex_queue.empty())
+		{
+			size_t u = vertex_queue.pop().second;
+			if (inTree[u])
+			{
+				continue;
+			}
+			inTree[u] = true;
+			if (u != start)
+			{
+				result.emplace(graph.idAt(parent[u]), graph.idAt(u));
+			}
+			for (size_t e = graph.edgesBegin(u); e < graph.edgesEnd(u); ++e)
+			{
+				size_t w = graph.targetAt(e);
+				if (!inTree[w] && (!reached[w] || graph.weightAt(e) < lightest[w]))
+				{
+					reached[w] = true;
+					lightest[w] = graph.weightAt(e);
+					parent[w] = u;
+					vertex_queue.push(w, graph.weightAt(e));
+				}
+			}
+		}
+		return result;
 	}
 
 	template<typename V>
-	std::vector<std::pair<size_t, size_t>> prim(const Graph<V, Unweight>& graph) = delete;
+	std::vector<std::pair<size_t, size_t>> prim(const FrozenGraph<V, Unweight>& graph) = delete;
 
 	template<typename V>
-	std::vector<std::pair<size_t, size_t>> prim(const Graph<V, Unweight>& graph, size_t source) = delete;
+	std::vector<std::pair<size_t, size_t>> prim(const FrozenGraph<V, Unweight>& graph, size_t source) = delete;
 
 	/**
-	 * Edmonds-Karp algorithm
-	 * @param graph graph
+	 * Edmonds-Karp algorithm on frozen graph
+	 * @param graph frozen graph
 	 * @param source source vertex
 	 * @param sink sink vertex
-	 * @return maximum flow, graph with edges values equal to their flow
+	 * @return maximum flow, graph (with added reverse edges) with edges values equal to their flow
 	 */
 	template<typename V, typename E>
-	std::pair<E, Graph<V,E>> edmondsKarpMaxFlow(Graph<V, E> graph, size_t source, size_t sink)
+	std::pair<E, FrozenGraph<V,E>> edmondsKarpMaxFlow(const FrozenGraph<V, E>& graph, size_t source, size_t sink)
 	{
 		static_assert(std::is_default_constructible<E>::value, "Edge type must be default constructible.");
-		
-		// Capacity graph
-		auto edges = graph.getEdgesPositions();
 
-		for(auto& e : edges)
+		const size_t n = graph.getVerticesCount();
+		size_t sourceIndex = graph.indexOf(source);
+		size_t sinkIndex = graph.indexOf(sink);
+		if (sourceIndex == FrozenGraph<V, E>::npos || sinkIndex == FrozenGraph<V, E>::npos)
 		{
-			if(!graph.adjacent(e.second,e.first))
+			throw std::invalid_argument("vertex id not found");
+		}
+
+		// Capacity graph - original edges plus reverse edges of zero capacity
+		std::vector<size_t> inOffsets(n + 1, 0);
+		for (size_t e = 0; e < graph.getEdgesCount(); ++e)
+		{
+			++inOffsets[graph.targetAt(e) + 1];
+		}
+		std::partial_sum(inOffsets.begin(), inOffsets.end(), inOffsets.begin());
+		std::vector<size_t> inSources(graph.getEdgesCount());
+		{
+			std::vector<size_t> fill(inOffsets.begin(), inOffsets.end() - 1);
+			for (size_t u = 0; u < n; ++u)
 			{
-				graph.addEdge(e.second, e.first, E());
+				for (size_t e = graph.edgesBegin(u); e < graph.edgesEnd(u); ++e)
+				{
+					inSources[fill[graph.targetAt(e)]++] = u;
+				}
 			}
 		}
 
-		// Flow graph
-		Graph<V,E> graphFlow = graph;
+		std::vector<size_t> offsets;
+		std::vector<size_t> targets;
+		std::vector<E> capacity;
+		offsets.reserve(n + 1);
+		targets.reserve(2 * graph.getEdgesCount());
+		capacity.reserve(2 * graph.getEdgesCount());
+		offsets.push_back(0);
 
-		for(auto& e : edges)
+		for (size_t u = 0; u < n; ++u)
 		{
-			graphFlow.updateEdgeValue(e.first, e.second, E());
-			graphFlow.updateEdgeValue(e.second, e.first, E());
+			// Both ranges are sorted, so they can be merged
+			size_t e = graph.edgesBegin(u);
+			size_t r = inOffsets[u];
+			while (e < graph.edgesEnd(u) || r < inOffsets[u + 1])
+			{
+				if (r == inOffsets[u + 1] || (e < graph.edgesEnd(u) && graph.targetAt(e) <= inSources[r]))
+				{
+					if (r < inOffsets[u + 1] && graph.targetAt(e) == inSources[r])
+					{
+						++r;
+					}
+					targets.push_back(graph.targetAt(e));
+					capacity.push_back(graph.weightAt(e));
+					++e;
+				}
+				else
+				{
+					targets.push_back(inSources[r]);
+					capacity.push_back(E());
+					++r;
+				}
+			}
+			offsets.push_back(targets.size());
+		}
+
+		std::vector<size_t> reverse(targets.size());
+		for (size_t u = 0; u < n; ++u)
+		{
+			for (size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+			{
+				auto first = targets.begin() + offsets[targets[e]];
+				auto last = targets.begin() + offsets[targets[e] + 1];
+				reverse[e] = size_t(std::lower_bound(first, last, u) - targets.begin());
+			}
 		}
 
+		// Flow graph
+		std::vector<E> flow(targets.size(), E());
 		E maxFlow {};
+		std::vector<size_t> predEdge(n);
+		std::vector<bool> reached(n);
+		std::vector<size_t> q;
+		q.reserve(n);
 
-		while(true)
+		while (true)
 		{
-			std::queue<size_t> q;
-			q.push(source);
-			// key = destination vertex; value = source vertex of edge going to key
-			std::map<size_t, size_t> pred;
+			std::fill(reached.begin(), reached.end(), false);
+			q.clear();
+			q.push_back(sourceIndex);
+			reached[sourceIndex] = true;
 
-			while(!q.empty())
+			for (size_t head = 0; head < q.size() && !reached[sinkIndex]; ++head)
 			{
-				size_t curr = q.front();
-				q.pop();
-				auto outEdges = graph.getEdgesFrom(curr);
-				for(auto& e : outEdges)
+				size_t curr = q[head];
+				for (size_t e = offsets[curr]; e < offsets[curr + 1]; ++e)
 				{
-					if(pred.find(e.first) == pred.end() && e.first != source &&
-					        graph.getEdgeValue(curr, e.first) > graphFlow.getEdgeValue(curr, e.first))
+					if (!reached[targets[e]] && capacity[e] > flow[e])
 					{
-						pred.emplace(e.first, curr);
-						q.push(e.first);
+						reached[targets[e]] = true;
+						predEdge[targets[e]] = e;
+						q.push_back(targets[e]);
 					}
 				}
 			}
 
-			if(pred.find(sink) == pred.end())
+			if (!reached[sinkIndex])
 			{
 				break;
 			}
 
 			E df = std::numeric_limits<E>::max();
 
-			for(auto e = sink; e != source; e = pred.at(e))
+			for (size_t v = sinkIndex; v != sourceIndex; v = targets[reverse[predEdge[v]]])
 			{
-				df = std::min(df, graph.getEdgeValue(pred.at(e), e) - graphFlow.getEdgeValue(pred.at(e), e));
+				df = std::min(df, capacity[predEdge[v]] - flow[predEdge[v]]);
 			}
 
-			for(auto e = sink; e != source; e = pred.at(e))
+			for (size_t v = sinkIndex; v != sourceIndex; v = targets[reverse[predEdge[v]]])
 			{
-				graphFlow.updateEdgeValue(pred.at(e), e,
-				                          graphFlow.getEdgeValue(pred.at(e), e) + df);
-				graphFlow.updateEdgeValue(e, pred.at(e),
-				                          graphFlow.getEdgeValue(e, pred.at(e)) - df);
+				flow[predEdge[v]] += df;
+				flow[reverse[predEdge[v]]] -= df;
 			}
 
 			maxFlow += df;
 		}
 
-		return { maxFlow, graphFlow };
+		std::vector<V> values;
+		values.reserve(n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			values.push_back(graph.valueAt(i));
+		}
+
+		return { maxFlow, FrozenGraph<V,E>(graph.isDirected(), graph.getVerticesIds(), std::move(values),
+		                                   std::move(offsets), std::move(targets), std::move(flow)) };
 	}
 
 	template<typename V>
-	std::pair<Unweight, Graph<V,Unweight>> edmondsKarpMaxFlow(Graph<V, Unweight> graph, size_t source, size_t sink) = delete;
+	std::pair<Unweight, FrozenGraph<V,Unweight>> edmondsKarpMaxFlow(const FrozenGraph<V, Unweight>& graph, size_t source, size_t sink) = delete;
 }
\ No newline at end of file
@@ -0,0 +1,522 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include "Graph.h"
+#include "Graph_frozen.h"
+#include "Graph_algorithms.h"
+
+namespace Graph
+{
+	/**
+	 * Strategy of landmark selection
+	 */
+	enum class LandmarkSelection
+	{
+		// Every next landmark is the vertex farthest (in count of edges) from already selected ones
+		Farthest,
+		// Vertices with the most edges
+		Degree
+	};
+
+	/**
+	 * Landmark (ALT) distance oracle
+	 *
+	 * Stores distances between k landmarks and all vertices (k values per vertex and direction, adjacent
+	 * in memory). By triangle inequality d(L, t) - d(L, s) and d(s, L) - d(t, L) are lower bounds of
+	 * distance from s to t and d(s, L) + d(L, t) is its upper bound, both are read from tables without search.
+	 * Lower bounds guide A* search of LandmarkSearch. Only for non-negative edge values.
+	 */
+	template<typename E>
+	class LandmarkIndex
+	{
+	private:
+		bool directed;
+		E infinity;
+		std::vector<size_t> ids;
+		// Dense indices of landmarks
+		std::vector<size_t> landmarks;
+		// fromLandmark[v * k + i] is distance from landmark i to v
+		std::vector<E> fromLandmark;
+		// toLandmark[v * k + i] is distance from v to landmark i (empty for undirected graph)
+		std::vector<E> toLandmark;
+
+		template<typename V>
+		void build(const FrozenGraph<V, E>& graph, size_t count, LandmarkSelection selection, size_t threads);
+
+		const E* distancesTo(size_t index) const
+		{
+			return directed ? toLandmark.data() + index * landmarks.size() : fromLandmark.data() + index * landmarks.size();
+		}
+
+		size_t checkedIndex(size_t vertex, const char* message) const
+		{
+			auto it = std::lower_bound(ids.begin(), ids.end(), vertex);
+			if(it == ids.end() || *it != vertex)
+			{
+				throw std::invalid_argument(message);
+			}
+			return size_t(it - ids.begin());
+		}
+
+	public:
+		/**
+		 * Selects landmarks and computes their distance tables
+		 * @param graph frozen graph
+		 * @param count count of landmarks (k), lowered to count of vertices
+		 * @param selection strategy of landmark selection
+		 * @param threads count of threads computing distance tables, 0 selects count of hardware threads
+		 * @param infinity max value of E
+		 * @throws invalid_argument exception if graph contains negative edge
+		 */
+		template<typename V>
+		LandmarkIndex(const FrozenGraph<V, E>& graph, size_t count, LandmarkSelection selection = LandmarkSelection::Farthest,
+		              size_t threads = 0, E infinity = std::numeric_limits<E>::max())
+			:directed(graph.isDirected()), infinity(infinity)
+		{
+			build(graph, count, selection, threads);
+		}
+
+		/**
+		 * Selects landmarks and computes their distance tables on frozen snapshot of graph
+		 * @param graph graph
+		 * @param count count of landmarks (k), lowered to count of vertices
+		 * @param selection strategy of landmark selection
+		 * @param threads count of threads computing distance tables, 0 selects count of hardware threads
+		 * @param infinity max value of E
+		 * @throws invalid_argument exception if graph contains negative edge
+		 */
+		template<typename V, typename S>
+		LandmarkIndex(const GraphBase<V, E, S>& graph, size_t count, LandmarkSelection selection = LandmarkSelection::Farthest,
+		              size_t threads = 0, E infinity = std::numeric_limits<E>::max())
+			:directed(graph.isDirected()), infinity(infinity)
+		{
+			build(freeze(graph), count, selection, threads);
+		}
+
+		/**
+		 * Get ids of landmarks
+		 * @return vector of ids
+		 */
+		std::vector<size_t> getLandmarks() const
+		{
+			std::vector<size_t> result;
+			for(size_t landmark : landmarks)
+			{
+				result.push_back(ids[landmark]);
+			}
+			return result;
+		}
+
+		/**
+		 * Get lower bound of distance between vertices
+		 * @param from dense index of source vertex
+		 * @param to dense index of target vertex
+		 * @return lower bound, infinity if tables prove that target is not reachable
+		 */
+		E lowerBoundAt(size_t from, size_t to) const
+		{
+			const size_t k = landmarks.size();
+			const E* fromS = fromLandmark.data() + from * k;
+			const E* fromT = fromLandmark.data() + to * k;
+			const E* toS = distancesTo(from);
+			const E* toT = distancesTo(to);
+			E bound = E();
+			for(size_t i = 0; i < k; ++i)
+			{
+				// Landmark reaching source reaches everything reachable from it, the same holds for target reversed
+				if(fromS[i] != infinity)
+				{
+					if(fromT[i] == infinity)
+					{
+						return infinity;
+					}
+					if(fromS[i] < fromT[i])
+					{
+						bound = std::max<E>(bound, fromT[i] - fromS[i]);
+					}
+				}
+				if(toT[i] != infinity)
+				{
+					if(toS[i] == infinity)
+					{
+						return infinity;
+					}
+					if(toT[i] < toS[i])
+					{
+						bound = std::max<E>(bound, toS[i] - toT[i]);
+					}
+				}
+			}
+			return bound;
+		}
+
+		/**
+		 * Get upper bound of distance between vertices (length of path through the best landmark)
+		 * @param from dense index of source vertex
+		 * @param to dense index of target vertex
+		 * @return upper bound, infinity if no landmark lies on path between vertices
+		 */
+		E upperBoundAt(size_t from, size_t to) const
+		{
+			if(from == to)
+			{
+				return E();
+			}
+			const size_t k = landmarks.size();
+			const E* toS = distancesTo(from);
+			const E* fromT = fromLandmark.data() + to * k;
+			E bound = infinity;
+			for(size_t i = 0; i < k; ++i)
+			{
+				if(toS[i] != infinity && fromT[i] != infinity)
+				{
+					bound = std::min<E>(bound, toS[i] + fromT[i]);
+				}
+			}
+			return bound;
+		}
+
+		/**
+		 * Get lower bound of distance between vertices without search
+		 * @param source source vertex
+		 * @param target target vertex
+		 * @throws invalid_argument exception if source or target is not part of graph
+		 * @return lower bound, infinity if tables prove that target is not reachable
+		 */
+		E lowerBound(size_t source, size_t target) const
+		{
+			return lowerBoundAt(checkedIndex(source, "source vertex id not found"), checkedIndex(target, "target vertex id not found"));
+		}
+
+		/**
+		 * Get upper bound of distance between vertices without search
+		 * @param source source vertex
+		 * @param target target vertex
+		 * @throws invalid_argument exception if source or target is not part of graph
+		 * @return upper bound, infinity if no landmark lies on path between vertices
+		 */
+		E upperBound(size_t source, size_t target) const
+		{
+			return upperBoundAt(checkedIndex(source, "source vertex id not found"), checkedIndex(target, "target vertex id not found"));
+		}
+
+		/**
+		 * Get count of vertices of indexed graph
+		 * @return count of vertices
+		 */
+		size_t getVerticesCount() const
+		{
+			return ids.size();
+		}
+
+		/**
+		 * Get ids of vertices of indexed graph
+		 * @return ids sorted ascending, position of id is its dense index
+		 */
+		const std::vector<size_t>& getVerticesIds() const
+		{
+			return ids;
+		}
+
+		/**
+		 * Get memory used by distance tables
+		 * @return size in bytes
+		 */
+		size_t getTablesSize() const
+		{
+			return (fromLandmark.size() + toLandmark.size()) * sizeof(E);
+		}
+	};
+
+	template<typename E>
+	template<typename V>
+	void LandmarkIndex<E>::build(const FrozenGraph<V, E>& graph, size_t count, LandmarkSelection selection, size_t threads)
+	{
+		const size_t n = graph.getVerticesCount();
+		for(size_t e = 0; e < graph.getEdgesCount(); ++e)
+		{
+			if(graph.weightAt(e) < E())
+			{
+				throw std::invalid_argument("landmarks require non-negative edges");
+			}
+		}
+		ids.assign(graph.getVerticesIds().begin(), graph.getVerticesIds().end());
+		count = std::min(count, n);
+		if(threads == 0)
+		{
+			threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+		}
+		threads = std::max<size_t>(std::min(threads, count), 1);
+
+		const size_t k = count;
+
+		if(selection == LandmarkSelection::Degree)
+		{
+			std::vector<size_t> order(n);
+			std::iota(order.begin(), order.end(), 0);
+			std::partial_sort(order.begin(), order.begin() + k, order.end(), [&](size_t a, size_t b)
+			{
+				return graph.edgesEnd(b) - graph.edgesBegin(b) < graph.edgesEnd(a) - graph.edgesBegin(a);
+			});
+			landmarks.assign(order.begin(), order.begin() + k);
+		}
+		else if(k > 0)
+		{
+			// Landmarks are selected by breadth-first searches, which are much cheaper than searches
+			// computing distance tables, so that all of these run in parallel afterwards
+			const size_t unreached = std::numeric_limits<size_t>::max();
+			std::vector<size_t> hops(n);
+			std::vector<size_t> frontier;
+			frontier.reserve(n);
+			auto search = [&](size_t source)
+			{
+				std::fill(hops.begin(), hops.end(), unreached);
+				frontier.assign(1, source);
+				hops[source] = 0;
+				for(size_t head = 0; head < frontier.size(); ++head)
+				{
+					size_t v = frontier[head];
+					for(size_t e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e)
+					{
+						size_t w = graph.targetAt(e);
+						if(hops[w] == unreached)
+						{
+							hops[w] = hops[v] + 1;
+							frontier.push_back(w);
+						}
+					}
+				}
+			};
+
+			// Farthest vertex from the first one starts the selection
+			search(0);
+			size_t next = frontier.back();
+			std::vector<size_t> nearest(n, unreached);
+			std::vector<bool> selected(n, false);
+			while(landmarks.size() < k)
+			{
+				landmarks.push_back(next);
+				selected[next] = true;
+				search(next);
+				// Vertices not reached by any landmark are the farthest
+				next = n;
+				for(size_t v = 0; v < n; ++v)
+				{
+					nearest[v] = std::min(nearest[v], hops[v]);
+					if(!selected[v] && (next == n || nearest[next] < nearest[v]))
+					{
+						next = v;
+					}
+				}
+			}
+		}
+
+		// Searches are distributed over threads, each keeps distances of its landmark in its own column.
+		// Tables interleave landmarks of each vertex, so they are filled only after join, threads writing
+		// every k-th entry of them would share cache lines
+		std::unique_ptr<FrozenGraph<V, E>> transposed;
+		if(directed)
+		{
+			transposed.reset(new FrozenGraph<V, E>(transpose(graph)));
+		}
+		const size_t tasks = k + (directed ? k : 0);
+		std::vector<std::vector<E>> columns(tasks);
+		std::atomic<size_t> nextTask(0);
+		auto worker = [&]()
+		{
+			DijkstraSearch<V, E> forward(graph, infinity);
+			std::unique_ptr<DijkstraSearch<V, E>> backward;
+			for(size_t task = nextTask++; task < tasks; task = nextTask++)
+			{
+				if(task < k)
+				{
+					columns[task] = forward.run(landmarks[task]).distance;
+				}
+				else
+				{
+					if(!backward)
+					{
+						backward.reset(new DijkstraSearch<V, E>(*transposed, infinity));
+					}
+					columns[task] = backward->run(landmarks[task - k]).distance;
+				}
+			}
+		};
+
+		std::vector<std::thread> pool;
+		for(size_t t = 1; t < threads; ++t)
+		{
+			pool.emplace_back(worker);
+		}
+		worker();
+		for(auto& thread : pool)
+		{
+			thread.join();
+		}
+
+		auto store = [&](std::vector<E>& table, size_t landmark, std::vector<E>& column)
+		{
+			for(size_t v = 0; v < n; ++v)
+			{
+				table[v * k + landmark] = column[v];
+			}
+			std::vector<E>().swap(column);
+		};
+		fromLandmark.assign(n * k, infinity);
+		if(directed)
+		{
+			toLandmark.assign(n * k, infinity);
+		}
+		for(size_t landmark = 0; landmark < k; ++landmark)
+		{
+			store(fromLandmark, landmark, columns[landmark]);
+			if(directed)
+			{
+				store(toLandmark, landmark, columns[k + landmark]);
+			}
+		}
+	}
+
+	/**
+	 * Reusable landmark-guided A* search on frozen graph
+	 *
+	 * Lower bound of distance to target from LandmarkIndex is consistent, so every vertex is settled once.
+	 * Vertices which tables prove unable to reach target are not queued at all.
+	 * Arrays are reset only where previous query reached.
+	 */
+	template<typename V, typename E, typename Queue = LazyHeapQueue>
+	class LandmarkSearch
+	{
+	private:
+		const FrozenGraph<V, E>* graph;
+		const LandmarkIndex<E>* index;
+		E infinity;
+		ShortestPaths<E> paths;
+		std::vector<E> estimate;
+		std::vector<size_t> reached;
+		helper::SearchQueue<Queue, E> queue;
+
+	public:
+		/**
+		 * Creates search for graph and its index (both have to outlive the search, every thread needs its own search)
+		 * @param graph frozen graph
+		 * @param index landmark index built for graph
+		 * @param infinity max value of E
+		 * @throws invalid_argument exception if index was built for graph with different vertices
+		 */
+		LandmarkSearch(const FrozenGraph<V, E>& graph, const LandmarkIndex<E>& index, E infinity = std::numeric_limits<E>::max())
+			:graph(&graph), index(&index), infinity(infinity)
+		{
+			static_assert(!helper::isMonotoneQueue<Queue, E>::value, "A* search requires LazyHeapQueue or IndexedHeapQueue");
+
+			const auto& ids = graph.getVerticesIds();
+			if(index.getVerticesIds().size() != ids.size() || !std::equal(ids.begin(), ids.end(), index.getVerticesIds().begin()))
+			{
+				throw std::invalid_argument("landmark index does not match graph");
+			}
+			const size_t n = graph.getVerticesCount();
+			paths.distance.assign(n, infinity);
+			paths.predecessor.resize(n);
+			std::iota(paths.predecessor.begin(), paths.predecessor.end(), 0);
+			estimate.resize(n);
+		}
+
+		/**
+		 * Finds shortest path from source to target
+		 * @param source source vertex
+		 * @param target target vertex
+		 * @throws invalid_argument exception if source or target is not part of graph
+		 * @return distance and shortest path (infinity and only target if target is not reachable)
+		 */
+		std::pair<E, std::vector<size_t>> query(size_t source, size_t target)
+		{
+			size_t start = graph->indexOf(source);
+			size_t end = graph->indexOf(target);
+			if(start == FrozenGraph<V, E>::npos)
+			{
+				throw std::invalid_argument("source vertex id not found");
+			}
+			if(end == FrozenGraph<V, E>::npos)
+			{
+				throw std::invalid_argument("target vertex id not found");
+			}
+
+			for(size_t v : reached)
+			{
+				paths.distance[v] = infinity;
+				paths.predecessor[v] = v;
+			}
+			reached.clear();
+			queue.reset(paths.distance.size());
+
+			estimate[start] = index->lowerBoundAt(start, end);
+			if(estimate[start] != infinity)
+			{
+				paths.distance[start] = E();
+				reached.push_back(start);
+				queue.push(start, estimate[start]);
+			}
+
+			while(!queue.empty())
+			{
+				auto top = queue.pop();
+				size_t u = top.second;
+				const E d = paths.distance[u];
+				// Outdated entry of lazy queue
+				if(d + estimate[u] < top.first)
+				{
+					continue;
+				}
+				if(u == end)
+				{
+					break;
+				}
+				const size_t last = graph->edgesEnd(u);
+				for(size_t e = graph->edgesBegin(u); e < last; ++e)
+				{
+					size_t w = graph->targetAt(e);
+					E alt = d + graph->weightAt(e);
+					if(alt < paths.distance[w])
+					{
+						if(paths.distance[w] == infinity)
+						{
+							estimate[w] = index->lowerBoundAt(w, end);
+							if(estimate[w] == infinity)
+							{
+								continue;
+							}
+							reached.push_back(w);
+						}
+						paths.distance[w] = alt;
+						paths.predecessor[w] = u;
+						queue.push(w, alt + estimate[w]);
+					}
+				}
+			}
+
+			std::vector<size_t> result;
+			for(size_t v : paths.path(end))
+			{
+				result.push_back(graph->idAt(v));
+			}
+			return { paths.distance[end], result };
+		}
+
+		/**
+		 * Get dense indices of vertices reached by last query
+		 * @return reached vertices
+		 */
+		const std::vector<size_t>& reachedVertices() const
+		{
+			return reached;
+		}
+	};
+}
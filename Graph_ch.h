@@ -0,0 +1,1067 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <tuple>
+#include <algorithm>
+#include <stdexcept>
+#include "Graph.h"
+#include "Graph_frozen.h"
+#include "Graph_algorithms.h"
+#include "Graph_io.h"
+
+namespace Graph
+{
+	/**
+	 * Contraction hierarchy of graph for fast point-to-point shortest path queries
+	 *
+	 * Vertices are contracted one by one in order of importance (rank). Contraction of vertex inserts
+	 * shortcut between its remaining neighbours wherever the path through it may be the only shortest one.
+	 * Every shortest path then has equivalent path going upwards in ranks from source and downwards to
+	 * target, so queries (ContractionHierarchyQuery) search only upward arcs from both ends.
+	 * Upward arcs are stored in CSR arrays at their lower ranked source, downward arcs at their lower
+	 * ranked target (together with their source). Shortcut keeps dense index of vertex it bypasses,
+	 * so paths can be unpacked to original edges. Index is immutable and can be saved to file
+	 * (saveContractionHierarchy) and loaded memory mapped (loadContractionHierarchy).
+	 */
+	template<typename E>
+	class ContractionHierarchy
+	{
+	private:
+		bool directed;
+		Column<size_t> ids;
+		Column<size_t> ranks;
+		Column<size_t> upOffsets;
+		Column<size_t> upTargets;
+		Column<E> upWeights;
+		Column<size_t> upMiddles;
+		Column<size_t> downOffsets;
+		Column<size_t> downSources;
+		Column<E> downWeights;
+		Column<size_t> downMiddles;
+
+		template<typename V>
+		void build(const FrozenGraph<V, E>& graph, size_t witnessLimit);
+
+	public:
+		/**
+		 * Value of middle vertex of arcs which are original edges, returned also for ids not in index
+		 */
+		static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+		/**
+		 * Preprocesses graph (only for non-negative edge values)
+		 * @param graph graph
+		 * @param witnessLimit max count of vertices settled by each search for path avoiding contracted vertex,
+		 *        lower limit speeds up preprocessing, but may insert unnecessary shortcuts
+		 * @throws invalid_argument exception if graph contains negative edge
+		 */
+		template<typename V, typename S>
+		explicit ContractionHierarchy(const GraphBase<V, E, S>& graph, size_t witnessLimit = 500)
+			:directed(graph.isDirected())
+		{
+			build(freeze(graph), witnessLimit);
+		}
+
+		/**
+		 * Preprocesses frozen graph (only for non-negative edge values)
+		 * @param graph frozen graph
+		 * @param witnessLimit max count of vertices settled by each search for path avoiding contracted vertex
+		 * @throws invalid_argument exception if graph contains negative edge
+		 */
+		template<typename V>
+		explicit ContractionHierarchy(const FrozenGraph<V, E>& graph, size_t witnessLimit = 500)
+			:directed(graph.isDirected())
+		{
+			build(graph, witnessLimit);
+		}
+
+		/**
+		 * Creates index directly from its arrays (owned vectors or views of external memory)
+		 * @throws invalid_argument exception if sizes of arrays do not match
+		 */
+		ContractionHierarchy(bool directed, Column<size_t> ids, Column<size_t> ranks,
+		                     Column<size_t> upOffsets, Column<size_t> upTargets, Column<E> upWeights, Column<size_t> upMiddles,
+		                     Column<size_t> downOffsets, Column<size_t> downSources, Column<E> downWeights, Column<size_t> downMiddles)
+			:directed(directed), ids(std::move(ids)), ranks(std::move(ranks)),
+			 upOffsets(std::move(upOffsets)), upTargets(std::move(upTargets)), upWeights(std::move(upWeights)),
+			 upMiddles(std::move(upMiddles)), downOffsets(std::move(downOffsets)), downSources(std::move(downSources)),
+			 downWeights(std::move(downWeights)), downMiddles(std::move(downMiddles))
+		{
+			const size_t n = this->ids.size();
+			if(this->ranks.size() != n || this->upOffsets.size() != n + 1 || this->downOffsets.size() != n + 1 ||
+			        this->upTargets.size() != this->upOffsets.back() || this->upWeights.size() != this->upTargets.size() ||
+			        this->upMiddles.size() != this->upTargets.size() || this->downSources.size() != this->downOffsets.back() ||
+			        this->downWeights.size() != this->downSources.size() || this->downMiddles.size() != this->downSources.size())
+			{
+				throw std::invalid_argument("contraction hierarchy arrays sizes do not match.");
+			}
+		}
+
+		/**
+		 * Checks if indexed graph is directed
+		 * @return true if directed, false otherwise
+		 */
+		bool isDirected() const
+		{
+			return directed;
+		}
+
+		/**
+		 * Get count of vertices in index
+		 * @return count of vertices
+		 */
+		size_t getVerticesCount() const
+		{
+			return ids.size();
+		}
+
+		/**
+		 * Get count of stored arcs (original edges and shortcuts, upward and downward)
+		 * @return count of arcs
+		 */
+		size_t getArcsCount() const
+		{
+			return upTargets.size() + downSources.size();
+		}
+
+		/**
+		 * Get dense index of vertex
+		 * @param vertex id of vertex
+		 * @return dense index, npos if vertex is not in index
+		 */
+		size_t indexOf(size_t vertex) const
+		{
+			auto it = std::lower_bound(ids.begin(), ids.end(), vertex);
+			return (it != ids.end() && *it == vertex) ? size_t(it - ids.begin()) : npos;
+		}
+
+		/**
+		 * Get id of vertex at dense index
+		 * @param index dense index
+		 * @return id of vertex
+		 */
+		size_t idAt(size_t index) const
+		{
+			return ids[index];
+		}
+
+		/**
+		 * Get position of vertex in contraction order (0 for the first contracted)
+		 * @param index dense index
+		 * @return rank of vertex
+		 */
+		size_t rankAt(size_t index) const
+		{
+			return ranks[index];
+		}
+
+		size_t upBegin(size_t index) const
+		{
+			return upOffsets[index];
+		}
+
+		size_t upEnd(size_t index) const
+		{
+			return upOffsets[index + 1];
+		}
+
+		size_t upTargetAt(size_t arc) const
+		{
+			return upTargets[arc];
+		}
+
+		const E& upWeightAt(size_t arc) const
+		{
+			return upWeights[arc];
+		}
+
+		size_t upMiddleAt(size_t arc) const
+		{
+			return upMiddles[arc];
+		}
+
+		size_t downBegin(size_t index) const
+		{
+			return downOffsets[index];
+		}
+
+		size_t downEnd(size_t index) const
+		{
+			return downOffsets[index + 1];
+		}
+
+		size_t downSourceAt(size_t arc) const
+		{
+			return downSources[arc];
+		}
+
+		const E& downWeightAt(size_t arc) const
+		{
+			return downWeights[arc];
+		}
+
+		size_t downMiddleAt(size_t arc) const
+		{
+			return downMiddles[arc];
+		}
+
+		/**
+		 * Get position of upward arc
+		 * @param from dense index of source (lower ranked) vertex
+		 * @param to dense index of target vertex
+		 * @return arc position, npos if arc does not exist
+		 */
+		size_t findUpArc(size_t from, size_t to) const
+		{
+			auto first = upTargets.begin() + upOffsets[from];
+			auto last = upTargets.begin() + upOffsets[from + 1];
+			auto it = std::lower_bound(first, last, to);
+			return (it != last && *it == to) ? size_t(it - upTargets.begin()) : npos;
+		}
+
+		/**
+		 * Get position of downward arc
+		 * @param from dense index of source vertex
+		 * @param to dense index of target (lower ranked) vertex
+		 * @return arc position, npos if arc does not exist
+		 */
+		size_t findDownArc(size_t from, size_t to) const
+		{
+			auto first = downSources.begin() + downOffsets[to];
+			auto last = downSources.begin() + downOffsets[to + 1];
+			auto it = std::lower_bound(first, last, from);
+			return (it != last && *it == from) ? size_t(it - downSources.begin()) : npos;
+		}
+
+		/**
+		 * Appends original path of arc (without its source) to path
+		 * @param from dense index of source of arc
+		 * @param to dense index of target of arc
+		 * @param middle dense index of vertex bypassed by arc, npos for original edge
+		 * @param path ids of vertices
+		 */
+		void unpackArc(size_t from, size_t to, size_t middle, std::vector<size_t>& path) const
+		{
+			// Both halves of shortcut are arcs of bypassed vertex, which was contracted before their ends
+			std::vector<std::tuple<size_t, size_t, size_t>> stack;
+			stack.emplace_back(from, to, middle);
+			while(!stack.empty())
+			{
+				std::tie(from, to, middle) = stack.back();
+				stack.pop_back();
+				if(middle == npos)
+				{
+					path.push_back(ids[to]);
+					continue;
+				}
+				stack.emplace_back(middle, to, upMiddles[findUpArc(middle, to)]);
+				stack.emplace_back(from, middle, downMiddles[findDownArc(from, middle)]);
+			}
+		}
+
+		const Column<size_t>& getVerticesIds() const
+		{
+			return ids;
+		}
+
+		const Column<size_t>& getRanks() const
+		{
+			return ranks;
+		}
+
+		const Column<size_t>& getUpOffsets() const
+		{
+			return upOffsets;
+		}
+
+		const Column<size_t>& getUpTargets() const
+		{
+			return upTargets;
+		}
+
+		const Column<E>& getUpWeights() const
+		{
+			return upWeights;
+		}
+
+		const Column<size_t>& getUpMiddles() const
+		{
+			return upMiddles;
+		}
+
+		const Column<size_t>& getDownOffsets() const
+		{
+			return downOffsets;
+		}
+
+		const Column<size_t>& getDownSources() const
+		{
+			return downSources;
+		}
+
+		const Column<E>& getDownWeights() const
+		{
+			return downWeights;
+		}
+
+		const Column<size_t>& getDownMiddles() const
+		{
+			return downMiddles;
+		}
+	};
+
+	template<typename E>
+	constexpr size_t ContractionHierarchy<E>::npos;
+
+	namespace helper
+	{
+		/**
+		 * Contracts vertices of graph kept in adjacency lists
+		 */
+		template<typename E>
+		class Contraction
+		{
+		public:
+			struct Arc
+			{
+				size_t vertex;
+				E weight;
+				size_t middle;
+			};
+
+			// Arcs between not yet contracted vertices, lists of contracted vertex keep its arcs to higher ranks
+			std::vector<std::vector<Arc>> outgoing;
+			std::vector<std::vector<Arc>> incoming;
+			std::vector<size_t> rank;
+
+		private:
+			size_t witnessLimit;
+			std::vector<bool> contracted;
+			// Count of contracted neighbours, keeps contraction spread uniformly over graph
+			std::vector<size_t> deleted;
+			std::vector<E> distance;
+			std::vector<size_t> touched;
+			// Out-neighbours of contracted vertex, witness search stops once all of them are settled
+			std::vector<bool> target;
+			// Binary heap of witness search, kept to reuse its memory
+			std::vector<std::pair<E, size_t>> heap;
+			std::vector<std::tuple<size_t, size_t, E>> shortcuts;
+
+			/**
+			 * Dijkstra search from source avoiding skipped vertex, stopped after all targets, maxDistance
+			 * or witnessLimit settled vertices
+			 */
+			void witnessSearch(size_t source, size_t skipped, E maxDistance, size_t targets)
+			{
+				const E infinity = std::numeric_limits<E>::max();
+				for(size_t v : touched)
+				{
+					distance[v] = infinity;
+				}
+				touched.assign(1, source);
+				distance[source] = E();
+
+				const CompareDistance<E> compare;
+				heap.assign(1, std::make_pair(E(), source));
+				size_t settled = 0;
+				while(!heap.empty())
+				{
+					std::pop_heap(heap.begin(), heap.end(), compare);
+					E d = heap.back().first;
+					size_t u = heap.back().second;
+					heap.pop_back();
+					if(distance[u] < d)
+					{
+						continue;
+					}
+					if(maxDistance < d || ++settled > witnessLimit || (target[u] && --targets == 0))
+					{
+						break;
+					}
+					for(const Arc& arc : outgoing[u])
+					{
+						if(arc.vertex == skipped)
+						{
+							continue;
+						}
+						E alt = d + arc.weight;
+						if(alt < distance[arc.vertex])
+						{
+							if(distance[arc.vertex] == infinity)
+							{
+								touched.push_back(arc.vertex);
+							}
+							distance[arc.vertex] = alt;
+							heap.emplace_back(alt, arc.vertex);
+							std::push_heap(heap.begin(), heap.end(), compare);
+						}
+					}
+				}
+			}
+
+			/**
+			 * Finds shortcuts needed by contraction of vertex (stored in shortcuts)
+			 */
+			void findShortcuts(size_t v)
+			{
+				shortcuts.clear();
+				if(outgoing[v].empty())
+				{
+					return;
+				}
+				E maxOut = E();
+				for(const Arc& out : outgoing[v])
+				{
+					maxOut = std::max(maxOut, out.weight);
+					target[out.vertex] = true;
+				}
+				for(const Arc& in : incoming[v])
+				{
+					witnessSearch(in.vertex, v, in.weight + maxOut, outgoing[v].size());
+					for(const Arc& out : outgoing[v])
+					{
+						E through = in.weight + out.weight;
+						if(out.vertex != in.vertex && through < distance[out.vertex])
+						{
+							shortcuts.emplace_back(in.vertex, out.vertex, through);
+						}
+					}
+				}
+				for(const Arc& out : outgoing[v])
+				{
+					target[out.vertex] = false;
+				}
+			}
+
+			long long priority(size_t v)
+			{
+				findShortcuts(v);
+				return 2 * ((long long)shortcuts.size() - (long long)(outgoing[v].size() + incoming[v].size())) + (long long)deleted[v];
+			}
+
+			static void eraseArc(std::vector<Arc>& arcs, size_t vertex)
+			{
+				arcs.erase(std::remove_if(arcs.begin(), arcs.end(), [vertex](const Arc& arc) { return arc.vertex == vertex; }), arcs.end());
+			}
+
+			static bool lowerArc(std::vector<Arc>& arcs, size_t vertex, E weight, size_t middle)
+			{
+				for(Arc& arc : arcs)
+				{
+					if(arc.vertex == vertex)
+					{
+						if(!(weight < arc.weight))
+						{
+							return false;
+						}
+						arc.weight = weight;
+						arc.middle = middle;
+						return true;
+					}
+				}
+				arcs.push_back({ vertex, weight, middle });
+				return true;
+			}
+
+			/**
+			 * Contracts vertex using shortcuts found by its priority, which must be the last one computed
+			 */
+			void contract(size_t v)
+			{
+				contracted[v] = true;
+				for(const Arc& out : outgoing[v])
+				{
+					eraseArc(incoming[out.vertex], v);
+					++deleted[out.vertex];
+				}
+				for(const Arc& in : incoming[v])
+				{
+					eraseArc(outgoing[in.vertex], v);
+					++deleted[in.vertex];
+				}
+				for(const auto& shortcut : shortcuts)
+				{
+					if(lowerArc(outgoing[std::get<0>(shortcut)], std::get<1>(shortcut), std::get<2>(shortcut), v))
+					{
+						lowerArc(incoming[std::get<1>(shortcut)], std::get<0>(shortcut), std::get<2>(shortcut), v);
+					}
+				}
+			}
+
+		public:
+			Contraction(size_t verticesCount, size_t witnessLimit)
+				:outgoing(verticesCount), incoming(verticesCount), rank(verticesCount), witnessLimit(witnessLimit),
+				 contracted(verticesCount, false), deleted(verticesCount, 0),
+				 distance(verticesCount, std::numeric_limits<E>::max()), target(verticesCount, false)
+			{
+			}
+
+			/**
+			 * Contracts all vertices, the one with the lowest priority (shortcuts added - arcs removed
+			 * + contracted neighbours) first, priorities are updated lazily when vertex is selected
+			 * and shortcuts found by the update are reused when it is contracted
+			 */
+			void run()
+			{
+				const size_t n = outgoing.size();
+				std::priority_queue<std::pair<long long, size_t>, std::vector<std::pair<long long, size_t>>,
+				        std::greater<std::pair<long long, size_t>>> order;
+				for(size_t v = 0; v < n; ++v)
+				{
+					order.emplace(priority(v), v);
+				}
+
+				size_t next = 0;
+				while(!order.empty())
+				{
+					size_t v = order.top().second;
+					order.pop();
+					if(contracted[v])
+					{
+						continue;
+					}
+					long long current = priority(v);
+					if(!order.empty() && order.top().first < current)
+					{
+						order.emplace(current, v);
+						continue;
+					}
+					contract(v);
+					rank[v] = next++;
+				}
+			}
+		};
+	}
+
+	template<typename E>
+	template<typename V>
+	void ContractionHierarchy<E>::build(const FrozenGraph<V, E>& graph, size_t witnessLimit)
+	{
+		static_assert(std::is_default_constructible<E>::value, "Edge type must be default constructible.");
+		using Arc = typename helper::Contraction<E>::Arc;
+
+		const size_t n = graph.getVerticesCount();
+		helper::Contraction<E> contraction(n, witnessLimit);
+		for(size_t v = 0; v < n; ++v)
+		{
+			for(size_t e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e)
+			{
+				if(graph.weightAt(e) < E())
+				{
+					throw std::invalid_argument("contraction hierarchy requires non-negative edges");
+				}
+				size_t w = graph.targetAt(e);
+				if(w != v)
+				{
+					contraction.outgoing[v].push_back({ w, graph.weightAt(e), npos });
+					contraction.incoming[w].push_back({ v, graph.weightAt(e), npos });
+				}
+			}
+		}
+		contraction.run();
+
+		std::vector<size_t> offsets(1, 0);
+		std::vector<size_t> vertices;
+		std::vector<E> weights;
+		std::vector<size_t> middles;
+		auto toColumns = [&](std::vector<std::vector<Arc>>& arcs)
+		{
+			offsets.assign(1, 0);
+			vertices.clear();
+			weights.clear();
+			middles.clear();
+			for(auto& list : arcs)
+			{
+				std::sort(list.begin(), list.end(), [](const Arc& a, const Arc& b) { return a.vertex < b.vertex; });
+				for(const Arc& arc : list)
+				{
+					vertices.push_back(arc.vertex);
+					weights.push_back(arc.weight);
+					middles.push_back(arc.middle);
+				}
+				offsets.push_back(vertices.size());
+				std::vector<Arc>().swap(list);
+			}
+		};
+
+		toColumns(contraction.outgoing);
+		upOffsets = std::move(offsets);
+		upTargets = std::move(vertices);
+		upWeights = std::move(weights);
+		upMiddles = std::move(middles);
+		toColumns(contraction.incoming);
+		downOffsets = std::move(offsets);
+		downSources = std::move(vertices);
+		downWeights = std::move(weights);
+		downMiddles = std::move(middles);
+
+		ids = std::vector<size_t>(graph.getVerticesIds().begin(), graph.getVerticesIds().end());
+		ranks = std::move(contraction.rank);
+	}
+
+	/**
+	 * Reusable bidirectional upward search in contraction hierarchy
+	 *
+	 * Forward search from source follows upward arcs, backward search from target follows downward arcs
+	 * in reverse. Each search stops once its closest queued vertex is not closer than the best path
+	 * found through vertex reached by both, vertices reachable shorter from higher ranked ones are
+	 * not expanded (stall on demand). Arrays are reset only where previous query reached.
+	 */
+	template<typename E, typename Queue = AutoQueue>
+	class ContractionHierarchyQuery
+	{
+	private:
+		struct Side
+		{
+			std::vector<E> distance;
+			// Parent vertex and position of arc leading from it
+			std::vector<std::pair<size_t, size_t>> parent;
+			std::vector<size_t> reached;
+			helper::SearchQueue<Queue, E> queue;
+		};
+
+		const ContractionHierarchy<E>* index;
+		E infinity;
+		Side forward;
+		Side backward;
+		size_t meeting;
+
+		void start(Side& side, size_t source)
+		{
+			for(size_t v : side.reached)
+			{
+				side.distance[v] = infinity;
+			}
+			side.reached.assign(1, source);
+			side.distance[source] = E();
+			side.queue.reset(side.distance.size());
+			side.queue.push(source, E());
+		}
+
+		// Drops outdated entries, returns if closest queued vertex can still improve best path
+		bool active(Side& side, E best)
+		{
+			while(!side.queue.empty() && side.distance[side.queue.top().second] < side.queue.top().first)
+			{
+				side.queue.pop();
+			}
+			return !side.queue.empty() && side.queue.top().first < best;
+		}
+
+		/**
+		 * Stall on demand: vertex reached through higher ranked vertex by shorter path than its distance
+		 * is not on shortest path found by this search and is not expanded
+		 */
+		template<typename Neighbour, typename Weight>
+		bool stalled(const Side& side, E distance, size_t begin, size_t end, Neighbour neighbour, Weight weight) const
+		{
+			for(size_t arc = begin; arc < end; ++arc)
+			{
+				E through = side.distance[(index->*neighbour)(arc)];
+				if(through != infinity && through + (index->*weight)(arc) < distance)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		E search(size_t first, size_t last)
+		{
+			start(forward, first);
+			start(backward, last);
+			E best = first == last ? E() : infinity;
+			meeting = first;
+
+			auto relax = [&](Side& side, const Side& other, size_t u, size_t arc, size_t w, E alt)
+			{
+				if(alt < side.distance[w])
+				{
+					if(side.distance[w] == infinity)
+					{
+						side.reached.push_back(w);
+					}
+					side.distance[w] = alt;
+					side.parent[w] = { u, arc };
+					side.queue.push(w, alt);
+					if(other.distance[w] != infinity && alt + other.distance[w] < best)
+					{
+						best = alt + other.distance[w];
+						meeting = w;
+					}
+				}
+			};
+
+			while(true)
+			{
+				bool forwardActive = active(forward, best);
+				bool backwardActive = active(backward, best);
+				if(!forwardActive && !backwardActive)
+				{
+					break;
+				}
+				if(forwardActive && (!backwardActive || !(backward.queue.top().first < forward.queue.top().first)))
+				{
+					auto top = forward.queue.pop();
+					size_t u = top.second;
+					if(stalled(forward, top.first, index->downBegin(u), index->downEnd(u), &ContractionHierarchy<E>::downSourceAt,
+					           &ContractionHierarchy<E>::downWeightAt))
+					{
+						continue;
+					}
+					for(size_t arc = index->upBegin(u); arc < index->upEnd(u); ++arc)
+					{
+						relax(forward, backward, u, arc, index->upTargetAt(arc), top.first + index->upWeightAt(arc));
+					}
+				}
+				else
+				{
+					auto top = backward.queue.pop();
+					size_t u = top.second;
+					if(stalled(backward, top.first, index->upBegin(u), index->upEnd(u), &ContractionHierarchy<E>::upTargetAt,
+					           &ContractionHierarchy<E>::upWeightAt))
+					{
+						continue;
+					}
+					for(size_t arc = index->downBegin(u); arc < index->downEnd(u); ++arc)
+					{
+						relax(backward, forward, u, arc, index->downSourceAt(arc), top.first + index->downWeightAt(arc));
+					}
+				}
+			}
+			return best;
+		}
+
+		static void checkIds(size_t first, size_t last)
+		{
+			if(first == ContractionHierarchy<E>::npos)
+			{
+				throw std::invalid_argument("source vertex id not found");
+			}
+			if(last == ContractionHierarchy<E>::npos)
+			{
+				throw std::invalid_argument("target vertex id not found");
+			}
+		}
+
+	public:
+		/**
+		 * Creates query for index (index has to outlive the query, every thread needs its own query)
+		 * @param index contraction hierarchy
+		 * @param infinity max value of E
+		 */
+		explicit ContractionHierarchyQuery(const ContractionHierarchy<E>& index, E infinity = std::numeric_limits<E>::max())
+			:index(&index), infinity(infinity), meeting(0)
+		{
+			for(Side* side : { &forward, &backward })
+			{
+				side->distance.assign(index.getVerticesCount(), infinity);
+				side->parent.resize(index.getVerticesCount());
+			}
+		}
+
+		/**
+		 * Finds distance from source to target
+		 * @param source source vertex
+		 * @param target target vertex
+		 * @throws invalid_argument exception if source or target is not part of graph
+		 * @return distance, infinity if target is not reachable
+		 */
+		E distance(size_t source, size_t target)
+		{
+			size_t first = index->indexOf(source);
+			size_t last = index->indexOf(target);
+			checkIds(first, last);
+			return search(first, last);
+		}
+
+		/**
+		 * Finds shortest path from source to target, shortcuts are unpacked to original edges
+		 * @param source source vertex
+		 * @param target target vertex
+		 * @throws invalid_argument exception if source or target is not part of graph
+		 * @return distance and shortest path (infinity and only target if target is not reachable)
+		 */
+		std::pair<E, std::vector<size_t>> query(size_t source, size_t target)
+		{
+			size_t first = index->indexOf(source);
+			size_t last = index->indexOf(target);
+			checkIds(first, last);
+			E best = search(first, last);
+			if(best == infinity)
+			{
+				return { infinity, std::vector<size_t>(1, target) };
+			}
+
+			// Upward part of path is collected from meeting vertex back to source
+			std::vector<std::pair<size_t, size_t>> upward;
+			for(size_t v = meeting; v != first; v = forward.parent[v].first)
+			{
+				upward.push_back(forward.parent[v]);
+			}
+			std::vector<size_t> path(1, source);
+			for(auto it = upward.rbegin(); it != upward.rend(); ++it)
+			{
+				size_t arc = it->second;
+				index->unpackArc(it->first, index->upTargetAt(arc), index->upMiddleAt(arc), path);
+			}
+			for(size_t v = meeting; v != last; v = backward.parent[v].first)
+			{
+				size_t arc = backward.parent[v].second;
+				index->unpackArc(v, backward.parent[v].first, index->downMiddleAt(arc), path);
+			}
+			return { best, path };
+		}
+	};
+
+	/**
+	 * Contraction hierarchy file format
+	 *
+	 * File starts with ContractionHeader followed by sections (each aligned to 8 bytes) in order of
+	 * offsets in header: ids and ranks of vertices, upward arcs (offsets, targets, values, middles)
+	 * and downward arcs (offsets, sources, values, middles). Numbers are stored as in binary graph format.
+	 */
+	namespace helper
+	{
+		constexpr char contractionMagic[8] = { 'G', 'R', 'A', 'P', 'H', 'C', 'H', 'I' };
+		constexpr uint32_t contractionVersion = 1;
+
+		struct ContractionHeader
+		{
+			char magic[8];
+			uint32_t version;
+			uint32_t endianTag;
+			uint32_t flags;
+			uint32_t edgeValueSize;
+			uint64_t verticesCount;
+			uint64_t upCount;
+			uint64_t downCount;
+			uint64_t sections[10];
+			uint64_t fileSize;
+		};
+	}
+
+	namespace helper
+	{
+		/**
+		 * Checks offsets and arc ends of one direction of contraction hierarchy
+		 * @throws invalid_argument exception if some array is corrupted
+		 */
+		template<typename E>
+		void validateArcs(const Column<size_t>& offsets, const Column<size_t>& vertices, const Column<size_t>& middles, size_t n)
+		{
+			if(offsets[0] != 0)
+			{
+				throw std::invalid_argument("contraction hierarchy offsets are corrupted");
+			}
+			for(size_t i = 1; i < offsets.size(); ++i)
+			{
+				if(offsets[i - 1] > offsets[i])
+				{
+					throw std::invalid_argument("contraction hierarchy offsets are corrupted");
+				}
+			}
+			for(size_t arc = 0; arc < vertices.size(); ++arc)
+			{
+				if(vertices[arc] >= n || (middles[arc] != ContractionHierarchy<E>::npos && middles[arc] >= n))
+				{
+					throw std::invalid_argument("contraction hierarchy arc end out of range");
+				}
+			}
+		}
+
+		/**
+		 * Checks that contraction hierarchy read from file can be queried: ids are strictly increasing,
+		 * offsets do not decrease, arc ends and ranks are dense indices and both halves of every shortcut
+		 * exist and bypass vertex ranked below its ends (so unpacking of paths terminates)
+		 * @throws invalid_argument exception if some array is corrupted
+		 */
+		template<typename E>
+		void validateHierarchy(const ContractionHierarchy<E>& index)
+		{
+			const size_t n = index.getVerticesCount();
+			const size_t npos = ContractionHierarchy<E>::npos;
+			const auto& ids = index.getVerticesIds();
+			for(size_t i = 0; i < n; ++i)
+			{
+				if((i > 0 && ids[i - 1] >= ids[i]) || index.rankAt(i) >= n)
+				{
+					throw std::invalid_argument("contraction hierarchy vertices are corrupted");
+				}
+			}
+			validateArcs<E>(index.getUpOffsets(), index.getUpTargets(), index.getUpMiddles(), n);
+			validateArcs<E>(index.getDownOffsets(), index.getDownSources(), index.getDownMiddles(), n);
+
+			auto validShortcut = [&](size_t from, size_t to, size_t middle)
+			{
+				return middle == npos || (index.rankAt(middle) < index.rankAt(from) && index.rankAt(middle) < index.rankAt(to) &&
+				                          index.findUpArc(middle, to) != npos && index.findDownArc(from, middle) != npos);
+			};
+			for(size_t v = 0; v < n; ++v)
+			{
+				for(size_t arc = index.upBegin(v); arc < index.upEnd(v); ++arc)
+				{
+					if(!validShortcut(v, index.upTargetAt(arc), index.upMiddleAt(arc)))
+					{
+						throw std::invalid_argument("contraction hierarchy shortcut is corrupted");
+					}
+				}
+				for(size_t arc = index.downBegin(v); arc < index.downEnd(v); ++arc)
+				{
+					if(!validShortcut(index.downSourceAt(arc), v, index.downMiddleAt(arc)))
+					{
+						throw std::invalid_argument("contraction hierarchy shortcut is corrupted");
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * Saves contraction hierarchy to file (loadable by loadContractionHierarchy)
+	 * @param index contraction hierarchy
+	 * @param filePath path to file
+	 * @return true if save was successful, false otherwise
+	 */
+	template<typename E>
+	bool saveContractionHierarchy(const ContractionHierarchy<E>& index, const std::string& filePath)
+	{
+		using namespace helper;
+		static_assert(isRawValue<E>::value, "contraction hierarchy file supports only trivially copyable edge values");
+
+		std::ofstream outputFile(filePath, std::ios::binary | std::ios::trunc);
+		if(!outputFile.is_open())
+		{
+			return false;
+		}
+
+		ContractionHeader header = {};
+		std::memcpy(header.magic, contractionMagic, sizeof(header.magic));
+		header.version = contractionVersion;
+		header.endianTag = binaryEndianTag;
+		header.flags = index.isDirected() ? binaryDirectedFlag : 0;
+		header.edgeValueSize = uint32_t(sizeof(E));
+		header.verticesCount = index.getVerticesCount();
+		header.upCount = index.getUpTargets().size();
+		header.downCount = index.getDownSources().size();
+
+		// Header is written twice, section offsets are known only after sections are written
+		uint64_t position = 0;
+		writeBytes(outputFile, position, &header, sizeof(header));
+		const Column<size_t>* sizes[] = { &index.getVerticesIds(), &index.getRanks(), &index.getUpOffsets(),
+		                                  &index.getUpTargets(), nullptr, &index.getUpMiddles(),
+		                                  &index.getDownOffsets(), &index.getDownSources(), nullptr, &index.getDownMiddles()
+		                                };
+		for(size_t i = 0; i < 10; ++i)
+		{
+			writePadding(outputFile, position);
+			header.sections[i] = position;
+			if(sizes[i])
+			{
+				writeSizes(outputFile, position, *sizes[i]);
+			}
+			else
+			{
+				writeValues(outputFile, position, i < 5 ? index.getUpWeights() : index.getDownWeights());
+			}
+		}
+		writePadding(outputFile, position);
+		header.fileSize = position;
+
+		outputFile.seekp(0);
+		outputFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		outputFile.close();
+		return !outputFile.fail();
+	}
+
+	/**
+	 * Loads contraction hierarchy saved by saveContractionHierarchy
+	 *
+	 * File is memory mapped and arrays are used in place, the mapping is released with last copy of the index.
+	 * Ids, ranks, offsets and arcs are validated by one pass over them, unless the file is trusted,
+	 * in which case only header and bounds of sections are validated.
+	 * @param filePath path to file
+	 * @param trusted true to skip validation of arrays (file was written by saveContractionHierarchy)
+	 * @throws invalid_argument exception if file cannot be mapped, is not a contraction hierarchy, its arrays
+	 *         are corrupted or was saved with different edge type or on architecture with different byte order
+	 * @return contraction hierarchy viewing file
+	 */
+	template<typename E>
+	ContractionHierarchy<E> loadContractionHierarchy(const std::string& filePath, bool trusted = false)
+	{
+		using namespace helper;
+		static_assert(isRawValue<E>::value, "contraction hierarchy file supports only trivially copyable edge values");
+
+		auto file = std::make_shared<const MappedFile>(filePath);
+
+		ContractionHeader header;
+		if(file->size() < sizeof(header))
+		{
+			throw std::invalid_argument("file is not a contraction hierarchy");
+		}
+		std::memcpy(&header, file->data(), sizeof(header));
+
+		if(std::memcmp(header.magic, contractionMagic, sizeof(header.magic)) != 0)
+		{
+			throw std::invalid_argument("file is not a contraction hierarchy");
+		}
+		if(header.endianTag != binaryEndianTag)
+		{
+			throw std::invalid_argument("contraction hierarchy was saved with different byte order");
+		}
+		if(header.version != contractionVersion)
+		{
+			throw std::invalid_argument("unsupported contraction hierarchy version");
+		}
+		if(header.edgeValueSize != sizeof(E))
+		{
+			throw std::invalid_argument("contraction hierarchy was saved with different edge type");
+		}
+		if(header.fileSize != file->size() || header.verticesCount >= file->size() ||
+		        header.upCount > file->size() || header.downCount > file->size())
+		{
+			throw std::invalid_argument("contraction hierarchy file is truncated");
+		}
+
+		const uint64_t n = header.verticesCount;
+		ContractionHierarchy<E> index((header.flags & binaryDirectedFlag) != 0,
+		                              readSizes(file, header.sections[0], n),
+		                              readSizes(file, header.sections[1], n),
+		                              readSizes(file, header.sections[2], n + 1),
+		                              readSizes(file, header.sections[3], header.upCount),
+		                              readValues<E>(file, header.sections[4], header.upCount),
+		                              readSizes(file, header.sections[5], header.upCount),
+		                              readSizes(file, header.sections[6], n + 1),
+		                              readSizes(file, header.sections[7], header.downCount),
+		                              readValues<E>(file, header.sections[8], header.downCount),
+		                              readSizes(file, header.sections[9], header.downCount));
+		if(!trusted)
+		{
+			validateHierarchy(index);
+		}
+		return index;
+	}
+
+	/**
+	 * Shortest path in contraction hierarchy from source to target
+	 * (use ContractionHierarchyQuery for repeated queries)
+	 * @param index contraction hierarchy
+	 * @param source source vertex
+	 * @param target target vertex
+	 * @param infinity max value of E
+	 * @throws invalid_argument exception if source or target is not part of graph
+	 * @return distance and shortest path (infinity and only target if target is not reachable)
+	 */
+	template<typename E>
+	std::pair<E, std::vector<size_t>>
+	dijkstra(const ContractionHierarchy<E>& index, size_t source, size_t target, E infinity = std::numeric_limits<E>::max())
+	{
+		ContractionHierarchyQuery<E> query(index, infinity);
+		return query.query(source, target);
+	}
+}
@@ -0,0 +1,526 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <memory>
+#include "Graph.h"
+
+namespace Graph
+{
+	/**
+	 * Read-only array used as column of FrozenGraph
+	 *
+	 * Either owns its elements in vector or views elements stored elsewhere
+	 * (e.g. in memory mapped file), which are kept alive by shared owner.
+	 */
+	template<typename T>
+	class Column
+	{
+	private:
+		std::vector<T> owned;
+		std::shared_ptr<const void> keepAlive;
+		const T* first;
+		size_t count;
+
+	public:
+		Column()
+			:first(nullptr), count(0)
+		{
+		}
+
+		/**
+		 * Creates column owning given elements
+		 * @param data elements of column
+		 */
+		Column(std::vector<T> data)
+			:owned(std::move(data)), first(owned.data()), count(owned.size())
+		{
+		}
+
+		/**
+		 * Creates column viewing external elements
+		 * @param data pointer to first element
+		 * @param count count of elements
+		 * @param keepAlive owner of memory, which is released with last column viewing it
+		 */
+		Column(const T* data, size_t count, std::shared_ptr<const void> keepAlive)
+			:keepAlive(std::move(keepAlive)), first(data), count(count)
+		{
+		}
+
+		Column(const Column& other)
+			:owned(other.owned), keepAlive(other.keepAlive),
+			 first(other.keepAlive ? other.first : owned.data()), count(other.count)
+		{
+		}
+
+		Column(Column&& other) noexcept
+			:owned(std::move(other.owned)), keepAlive(std::move(other.keepAlive)),
+			 first(keepAlive ? other.first : owned.data()), count(other.count)
+		{
+			other.first = nullptr;
+			other.count = 0;
+		}
+
+		Column& operator=(Column other) noexcept
+		{
+			owned = std::move(other.owned);
+			keepAlive = std::move(other.keepAlive);
+			first = keepAlive ? other.first : owned.data();
+			count = other.count;
+			return *this;
+		}
+
+		/**
+		 * Checks if column views external memory instead of owning its elements
+		 * @return true if column is a view
+		 */
+		bool isView() const
+		{
+			return keepAlive != nullptr;
+		}
+
+		size_t size() const
+		{
+			return count;
+		}
+
+		bool empty() const
+		{
+			return count == 0;
+		}
+
+		const T* data() const
+		{
+			return first;
+		}
+
+		const T* begin() const
+		{
+			return first;
+		}
+
+		const T* end() const
+		{
+			return first + count;
+		}
+
+		const T& operator[](size_t index) const
+		{
+			return first[index];
+		}
+
+		const T& back() const
+		{
+			return first[count - 1];
+		}
+	};
+
+	/**
+	 * Immutable compressed sparse row (CSR) snapshot of a graph
+	 *
+	 * Vertices are remapped to dense indices 0..n-1 (in ascending order of their ids),
+	 * outgoing edges of vertex i are stored in range [edgesBegin(i), edgesEnd(i)) of
+	 * contiguous target/weight arrays. Targets of every vertex are sorted.
+	 * Snapshot does not follow later changes of the graph it was created from.
+	 */
+	template<typename V, typename E>
+	class FrozenGraph
+	{
+	private:
+		bool directed;
+		Column<size_t> ids;
+		Column<V> values;
+		Column<size_t> offsets;
+		Column<size_t> targets;
+		Column<E> weights;
+
+	public:
+		/**
+		 * Value returned by indexOf for ids which are not part of the graph
+		 */
+		static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+	private:
+		// Table mapping ids to dense indices is used while it has at most this many entries per vertex
+		static constexpr size_t denseIdsFactor = 4;
+
+	public:
+
+		/**
+		 * Builds snapshot of given graph
+		 * @param graph graph to be frozen
+		 */
+		template<typename S>
+		explicit FrozenGraph(const GraphBase<V,E,S>& graph)
+			:directed(graph.directed)
+		{
+			const auto& vertices = *graph.vertices;
+			size_t edgesCount = 0;
+			std::vector<size_t> ids;
+			std::vector<V> values;
+			std::vector<size_t> offsets;
+			std::vector<size_t> targets;
+			std::vector<E> weights;
+
+			ids.reserve(vertices.size());
+			values.reserve(vertices.size());
+			offsets.reserve(vertices.size() + 1);
+
+			for(const auto& v : vertices)
+			{
+				ids.push_back(v.first);
+				values.push_back(v.second->value);
+				edgesCount += v.second->outgoingEdges.size();
+			}
+
+			// Ids are sorted - dense index of id is found in table when ids are dense enough (memory of table
+			// is bounded by count of vertices), by binary search otherwise
+			bool direct = !ids.empty() && ids.back() / denseIdsFactor < ids.size();
+			std::vector<size_t> denseIndex(direct ? ids.back() + 1 : 0, npos);
+			for(size_t i = 0; direct && i < ids.size(); ++i)
+			{
+				denseIndex[ids[i]] = i;
+			}
+			auto indexOfId = [&](size_t id)
+			{
+				return direct ? denseIndex[id] : size_t(std::lower_bound(ids.begin(), ids.end(), id) - ids.begin());
+			};
+
+			targets.reserve(edgesCount);
+			weights.reserve(edgesCount);
+			offsets.push_back(0);
+
+			for(const auto& v : vertices)
+			{
+				for(const auto& e : v.second->outgoingEdges)
+				{
+					targets.push_back(indexOfId(e.first));
+					weights.push_back(graph.edgeStore->value(e.second));
+				}
+				offsets.push_back(targets.size());
+			}
+
+			this->ids = std::move(ids);
+			this->values = std::move(values);
+			this->offsets = std::move(offsets);
+			this->targets = std::move(targets);
+			this->weights = std::move(weights);
+		}
+
+		/**
+		 * Creates snapshot directly from CSR arrays (owned vectors or views of external memory)
+		 * @param directed true for directed, false undirected
+		 * @param ids ids of vertices (sorted ascending)
+		 * @param values values of vertices (in order of ids)
+		 * @param offsets edge offsets of vertices (size of ids + 1)
+		 * @param targets dense indices of edges' end vertices (sorted within each vertex)
+		 * @param weights values of edges
+		 * @throws invalid_argument exception if sizes of arrays do not match
+		 */
+		FrozenGraph(bool directed, Column<size_t> ids, Column<V> values,
+		            Column<size_t> offsets, Column<size_t> targets, Column<E> weights)
+			:directed(directed), ids(std::move(ids)), values(std::move(values)), offsets(std::move(offsets)),
+			 targets(std::move(targets)), weights(std::move(weights))
+		{
+			if(this->values.size() != this->ids.size() || this->offsets.size() != this->ids.size() + 1 ||
+			        this->targets.size() != this->weights.size() || this->offsets.back() != this->targets.size())
+			{
+				throw std::invalid_argument("CSR arrays sizes do not match.");
+			}
+		}
+
+		/**
+		 * Get count of vertices in graph
+		 * @return count of vertices
+		 */
+		size_t getVerticesCount() const
+		{
+			return ids.size();
+		}
+
+		/**
+		 * Get count of stored edges (each edge of undirected graph is stored twice)
+		 * @return count of edges
+		 */
+		size_t getEdgesCount() const
+		{
+			return targets.size();
+		}
+
+		/**
+		 * Checks if graph is directed
+		 * @return true if directed, false otherwise
+		 */
+		bool isDirected() const
+		{
+			return directed;
+		}
+
+		/**
+		 * Get dense index of vertex
+		 * @param vertex id of vertex
+		 * @return dense index, npos if vertex is not in graph
+		 */
+		size_t indexOf(size_t vertex) const
+		{
+			auto it = std::lower_bound(ids.begin(), ids.end(), vertex);
+			return (it != ids.end() && *it == vertex) ? size_t(it - ids.begin()) : npos;
+		}
+
+		/**
+		 * Get id of vertex at dense index
+		 * @param index dense index
+		 * @return id of vertex
+		 */
+		size_t idAt(size_t index) const
+		{
+			return ids[index];
+		}
+
+		/**
+		 * Get value of vertex at dense index
+		 * @param index dense index
+		 * @return value of vertex
+		 */
+		const V& valueAt(size_t index) const
+		{
+			return values[index];
+		}
+
+		/**
+		 * Get position of first outgoing edge of vertex
+		 * @param index dense index of vertex
+		 * @return edge position
+		 */
+		size_t edgesBegin(size_t index) const
+		{
+			return offsets[index];
+		}
+
+		/**
+		 * Get position after last outgoing edge of vertex
+		 * @param index dense index of vertex
+		 * @return edge position
+		 */
+		size_t edgesEnd(size_t index) const
+		{
+			return offsets[index + 1];
+		}
+
+		/**
+		 * Get dense index of end vertex of edge
+		 * @param edge edge position
+		 * @return dense index of end vertex
+		 */
+		size_t targetAt(size_t edge) const
+		{
+			return targets[edge];
+		}
+
+		/**
+		 * Get value of edge
+		 * @param edge edge position
+		 * @return value of edge
+		 */
+		const E& weightAt(size_t edge) const
+		{
+			return weights[edge];
+		}
+
+		/**
+		 * Get position of edge between two vertices
+		 * @param from dense index of vertex from
+		 * @param to dense index of vertex to
+		 * @return edge position, npos if edge does not exist
+		 */
+		size_t findEdge(size_t from, size_t to) const
+		{
+			auto first = targets.begin() + offsets[from];
+			auto last = targets.begin() + offsets[from + 1];
+			auto it = std::lower_bound(first, last, to);
+			return (it != last && *it == to) ? size_t(it - targets.begin()) : npos;
+		}
+
+		/**
+		 * Returns ids of all vertices in graph
+		 * @return sorted column of vertices' ids
+		 */
+		const Column<size_t>& getVerticesIds() const
+		{
+			return ids;
+		}
+
+		/**
+		 * Returns values of vertices in order of dense indices
+		 * @return column of vertices' values
+		 */
+		const Column<V>& getValues() const
+		{
+			return values;
+		}
+
+		/**
+		 * Returns edge offsets of vertices (outgoing edges of vertex i are in [offsets[i], offsets[i + 1]))
+		 * @return column of edge offsets
+		 */
+		const Column<size_t>& getOffsets() const
+		{
+			return offsets;
+		}
+
+		/**
+		 * Returns dense indices of end vertices of all edges
+		 * @return column of edge targets
+		 */
+		const Column<size_t>& getTargets() const
+		{
+			return targets;
+		}
+
+		/**
+		 * Returns values of all edges
+		 * @return column of edge values
+		 */
+		const Column<E>& getWeights() const
+		{
+			return weights;
+		}
+
+		/**
+		 * Get value of given vertex
+		 * @param vertex id of vertex
+		 * @throws invalid_argument exception if id is invalid
+		 * @return value of this vertex
+		 */
+		const V& getVertexValue(size_t vertex) const
+		{
+			size_t index = indexOf(vertex);
+			if(index == npos)
+			{
+				throw std::invalid_argument("vertex id not found");
+			}
+			return values[index];
+		}
+
+		/**
+		* Test adjacency of 2 vertices
+		* @param from vertex from
+		* @param to vertex to
+		* @return true if vertices are adjacent, false if not or if they are invalid
+		*/
+		bool adjacent(size_t from, size_t to) const
+		{
+			size_t fromIndex = indexOf(from);
+			size_t toIndex = indexOf(to);
+			return fromIndex != npos && toIndex != npos && findEdge(fromIndex, toIndex) != npos;
+		}
+
+		/**
+		* Get value of edge
+		* @param from vertex from
+		* @param to vertex to
+		* @throws invalid_argument exception if either id is invalid
+		* @return value of edge
+		*/
+		const E& getEdgeValue(size_t from, size_t to) const
+		{
+			size_t fromIndex = indexOf(from);
+			size_t toIndex = indexOf(to);
+			if(fromIndex == npos)
+			{
+				throw std::invalid_argument("\"from\" vertex id not found");
+			}
+			if(toIndex == npos)
+			{
+				throw std::invalid_argument("\"to\" vertex id not found");
+			}
+			size_t edge = findEdge(fromIndex, toIndex);
+			if(edge == npos)
+			{
+				throw std::invalid_argument("edge does not exist");
+			}
+			return weights[edge];
+		}
+
+		/**
+		* Find neighbours of vertex
+		* @param vertex
+		* @return vector of ids of neighbours, if invalid vertex - empty
+		*/
+		std::vector<size_t> getNeighbours(size_t vertex) const
+		{
+			std::vector<size_t> result;
+			size_t index = indexOf(vertex);
+			if(index != npos)
+			{
+				result.reserve(offsets[index + 1] - offsets[index]);
+				for(size_t e = offsets[index]; e < offsets[index + 1]; ++e)
+				{
+					result.push_back(ids[targets[e]]);
+				}
+			}
+			return result;
+		}
+	};
+
+	template<typename V, typename E>
+	constexpr size_t FrozenGraph<V,E>::npos;
+
+	template<typename V, typename E>
+	constexpr size_t FrozenGraph<V,E>::denseIdsFactor;
+
+	/**
+	 * Creates immutable CSR snapshot of graph for read-only algorithm runs
+	 * @param graph graph to be frozen
+	 * @return snapshot of graph
+	 */
+	template<typename V, typename E, typename S>
+	FrozenGraph<V,E> freeze(const GraphBase<V,E,S>& graph)
+	{
+		return FrozenGraph<V,E>(graph);
+	}
+
+	/**
+	 * Creates snapshot with reversed edges (outgoing edges of vertex are its incoming edges in graph)
+	 * @param graph frozen graph
+	 * @return transposed graph (copy of graph if it is undirected)
+	 */
+	template<typename V, typename E>
+	FrozenGraph<V,E> transpose(const FrozenGraph<V,E>& graph)
+	{
+		if(!graph.isDirected())
+		{
+			return graph;
+		}
+
+		const size_t n = graph.getVerticesCount();
+		std::vector<size_t> offsets(n + 1, 0);
+		for(size_t e = 0; e < graph.getEdgesCount(); ++e)
+		{
+			++offsets[graph.targetAt(e) + 1];
+		}
+		for(size_t i = 0; i < n; ++i)
+		{
+			offsets[i + 1] += offsets[i];
+		}
+
+		// Sources are visited in ascending order, so targets of every vertex stay sorted
+		std::vector<size_t> position(offsets.begin(), offsets.end() - 1);
+		std::vector<size_t> targets(graph.getEdgesCount());
+		std::vector<E> weights(graph.getEdgesCount());
+		for(size_t v = 0; v < n; ++v)
+		{
+			for(size_t e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e)
+			{
+				size_t slot = position[graph.targetAt(e)]++;
+				targets[slot] = v;
+				weights[slot] = graph.weightAt(e);
+			}
+		}
+		return FrozenGraph<V,E>(true, graph.getVerticesIds(), graph.getValues(), std::move(offsets),
+		                        std::move(targets), std::move(weights));
+	}
+}
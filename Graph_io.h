@@ -0,0 +1,1464 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <chrono>
+#include <cctype>
+#include <algorithm>
+#include <queue>
+#include <tuple>
+#include <cstdio>
+#include <cerrno>
+#include <limits>
+#include <sstream>
+#include "Graph_frozen.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace Graph
+{
+	/**
+	 * Binary graph file format
+	 *
+	 * File starts with BinaryHeader followed by sections (each aligned to 8 bytes):
+	 * ids of vertices (uint64), edge offsets (uint64, count of vertices + 1),
+	 * dense targets of edges (uint64), edge values and vertex values.
+	 * Trivially copyable values are stored packed as they are in memory,
+	 * strings are stored in string table (uint64 offsets, count + 1, followed by characters).
+	 * Numbers are stored in native byte order, endianTag detects files written on other architecture.
+	 */
+	namespace helper
+	{
+		constexpr char binaryMagic[8] = { 'G', 'R', 'A', 'P', 'H', 'B', 'I', 'N' };
+		constexpr uint32_t binaryVersion = 1;
+		constexpr uint32_t binaryEndianTag = 0x01020304;
+		constexpr uint32_t binaryDirectedFlag = 1;
+
+		/**
+		 * Encoding of vertex or edge values in binary file
+		 */
+		enum class BinaryEncoding : uint32_t
+		{
+			Raw = 0,
+			Strings = 1,
+			Empty = 2
+		};
+
+		struct BinaryHeader
+		{
+			char magic[8];
+			uint32_t version;
+			uint32_t endianTag;
+			uint32_t flags;
+			uint32_t vertexEncoding;
+			uint32_t vertexValueSize;
+			uint32_t edgeEncoding;
+			uint32_t edgeValueSize;
+			uint32_t reserved;
+			uint64_t verticesCount;
+			uint64_t edgesCount;
+			uint64_t idsOffset;
+			uint64_t offsetsOffset;
+			uint64_t targetsOffset;
+			uint64_t weightsOffset;
+			uint64_t valuesOffset;
+			uint64_t fileSize;
+		};
+
+		inline uint64_t alignedSection(uint64_t offset)
+		{
+			return (offset + 7) & ~uint64_t(7);
+		}
+
+		/**
+		 * Read-only mapping of whole file into memory
+		 * (on platforms without mmap, file is read into buffer)
+		 */
+		class MappedFile
+		{
+		private:
+			const char* first = nullptr;
+			size_t length = 0;
+#if defined(_WIN32)
+			std::vector<uint64_t> buffer;
+#endif
+
+		public:
+			/**
+			 * Maps file
+			 * @param filePath path to file
+			 * @throws invalid_argument exception if file cannot be opened or mapped
+			 */
+			explicit MappedFile(const std::string& filePath)
+			{
+#if defined(_WIN32)
+				std::ifstream inputFile(filePath, std::ios::binary | std::ios::ate);
+				if(!inputFile.is_open())
+				{
+					throw std::invalid_argument("cannot open file");
+				}
+				length = size_t(inputFile.tellg());
+				buffer.resize((length + 7) / 8);
+				inputFile.seekg(0);
+				if(!inputFile.read(reinterpret_cast<char*>(buffer.data()), std::streamsize(length)))
+				{
+					throw std::invalid_argument("cannot read file");
+				}
+				first = reinterpret_cast<const char*>(buffer.data());
+#else
+				int fd = ::open(filePath.c_str(), O_RDONLY);
+				if(fd < 0)
+				{
+					throw std::invalid_argument("cannot open file");
+				}
+				struct stat info;
+				if(::fstat(fd, &info) != 0)
+				{
+					::close(fd);
+					throw std::invalid_argument("cannot read file");
+				}
+				length = size_t(info.st_size);
+				if(length > 0)
+				{
+					void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+					if(mapped == MAP_FAILED)
+					{
+						::close(fd);
+						throw std::invalid_argument("cannot map file");
+					}
+					first = static_cast<const char*>(mapped);
+				}
+				// Mapping stays valid after descriptor is closed
+				::close(fd);
+#endif
+			}
+
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+
+			~MappedFile()
+			{
+#if !defined(_WIN32)
+				if(first)
+				{
+					::munmap(const_cast<char*>(first), length);
+				}
+#endif
+			}
+
+			const char* data() const
+			{
+				return first;
+			}
+
+			size_t size() const
+			{
+				return length;
+			}
+		};
+
+		template<typename T>
+		using isEmptyValue = std::is_empty<T>;
+
+		template<typename T>
+		using isRawValue = std::integral_constant<bool, std::is_trivially_copyable<T>::value && !std::is_empty<T>::value>;
+
+		template<typename T>
+		constexpr BinaryEncoding binaryEncoding()
+		{
+			static_assert(std::is_same<T, std::string>::value || std::is_trivially_copyable<T>::value,
+			              "binary format supports only std::string and trivially copyable values");
+			return std::is_same<T, std::string>::value ? BinaryEncoding::Strings
+			       : (std::is_empty<T>::value ? BinaryEncoding::Empty : BinaryEncoding::Raw);
+		}
+
+		inline void writePadding(std::ofstream& outputFile, uint64_t& position)
+		{
+			static const char zeros[8] = {};
+			uint64_t aligned = alignedSection(position);
+			outputFile.write(zeros, std::streamsize(aligned - position));
+			position = aligned;
+		}
+
+		inline void writeBytes(std::ofstream& outputFile, uint64_t& position, const void* data, uint64_t bytes)
+		{
+			outputFile.write(static_cast<const char*>(data), std::streamsize(bytes));
+			position += bytes;
+		}
+
+		inline void writeSizes(std::ofstream& outputFile, uint64_t& position, const Column<size_t>& column)
+		{
+			if(sizeof(size_t) == sizeof(uint64_t))
+			{
+				writeBytes(outputFile, position, column.data(), column.size() * sizeof(uint64_t));
+			}
+			else
+			{
+				std::vector<uint64_t> wide(column.begin(), column.end());
+				writeBytes(outputFile, position, wide.data(), wide.size() * sizeof(uint64_t));
+			}
+		}
+
+		template<typename T>
+		std::enable_if_t<isRawValue<T>::value>
+		writeValues(std::ofstream& outputFile, uint64_t& position, const Column<T>& column)
+		{
+			writeBytes(outputFile, position, column.data(), column.size() * sizeof(T));
+		}
+
+		template<typename T>
+		std::enable_if_t<isEmptyValue<T>::value>
+		writeValues(std::ofstream&, uint64_t&, const Column<T>&)
+		{
+		}
+
+		inline void writeValues(std::ofstream& outputFile, uint64_t& position, const Column<std::string>& column)
+		{
+			std::vector<uint64_t> offsets;
+			offsets.reserve(column.size() + 1);
+			offsets.push_back(0);
+			for(const auto& s : column)
+			{
+				offsets.push_back(offsets.back() + s.size());
+			}
+			writeBytes(outputFile, position, offsets.data(), offsets.size() * sizeof(uint64_t));
+			for(const auto& s : column)
+			{
+				writeBytes(outputFile, position, s.data(), s.size());
+			}
+		}
+
+		/**
+		 * Returns pointer to section of mapped file
+		 * @throws invalid_argument exception if section does not fit into file
+		 */
+		inline const char* binarySection(const MappedFile& file, uint64_t offset, uint64_t bytes)
+		{
+			if(offset % 8 != 0 || offset > file.size() || bytes > file.size() - offset)
+			{
+				throw std::invalid_argument("binary graph section out of file bounds");
+			}
+			return file.data() + offset;
+		}
+
+		inline Column<size_t> readSizes(const std::shared_ptr<const MappedFile>& file, uint64_t offset, uint64_t count)
+		{
+			if(count > file->size() / sizeof(uint64_t))
+			{
+				throw std::invalid_argument("binary graph section out of file bounds");
+			}
+			const char* section = binarySection(*file, offset, count * sizeof(uint64_t));
+			if(sizeof(size_t) == sizeof(uint64_t))
+			{
+				return Column<size_t>(reinterpret_cast<const size_t*>(section), size_t(count), file);
+			}
+			const uint64_t* wide = reinterpret_cast<const uint64_t*>(section);
+			return std::vector<size_t>(wide, wide + count);
+		}
+
+		template<typename T>
+		std::enable_if_t<isRawValue<T>::value, Column<T>>
+		readValues(const std::shared_ptr<const MappedFile>& file, uint64_t offset, uint64_t count)
+		{
+			if(count > file->size() / sizeof(T))
+			{
+				throw std::invalid_argument("binary graph section out of file bounds");
+			}
+			const char* section = binarySection(*file, offset, count * sizeof(T));
+			if(alignof(T) <= 8)
+			{
+				return Column<T>(reinterpret_cast<const T*>(section), size_t(count), file);
+			}
+			std::vector<T> copied(static_cast<size_t>(count));
+			std::memcpy(static_cast<void*>(copied.data()), section, size_t(count) * sizeof(T));
+			return copied;
+		}
+
+		template<typename T>
+		std::enable_if_t<isEmptyValue<T>::value, Column<T>>
+		readValues(const std::shared_ptr<const MappedFile>&, uint64_t, uint64_t count)
+		{
+			return std::vector<T>(size_t(count));
+		}
+
+		template<typename T>
+		std::enable_if_t<std::is_same<T, std::string>::value, Column<T>>
+		readValues(const std::shared_ptr<const MappedFile>& file, uint64_t offset, uint64_t count)
+		{
+			if(count >= file->size() / sizeof(uint64_t))
+			{
+				throw std::invalid_argument("binary graph section out of file bounds");
+			}
+			const uint64_t* offsets = reinterpret_cast<const uint64_t*>(
+				binarySection(*file, offset, (count + 1) * sizeof(uint64_t)));
+			uint64_t charsOffset = offset + (count + 1) * sizeof(uint64_t);
+			if(charsOffset > file->size() || offsets[count] > file->size() - charsOffset)
+			{
+				throw std::invalid_argument("binary graph section out of file bounds");
+			}
+			const char* chars = file->data() + charsOffset;
+
+			std::vector<std::string> strings;
+			strings.reserve(size_t(count));
+			for(uint64_t i = 0; i < count; ++i)
+			{
+				if(offsets[i] > offsets[i + 1] || offsets[i + 1] > offsets[count])
+				{
+					throw std::invalid_argument("binary graph string table is corrupted");
+				}
+				strings.emplace_back(chars + offsets[i], size_t(offsets[i + 1] - offsets[i]));
+			}
+			return strings;
+		}
+
+		/**
+		 * Checks that CSR arrays read from file describe valid graph: ids are strictly increasing,
+		 * offsets start at zero, do not decrease and end at count of edges, targets are dense indices
+		 * @throws invalid_argument exception if some array is corrupted
+		 */
+		inline void validateAdjacency(const Column<size_t>& ids, const Column<size_t>& offsets, const Column<size_t>& targets)
+		{
+			for(size_t i = 1; i < ids.size(); ++i)
+			{
+				if(ids[i - 1] >= ids[i])
+				{
+					throw std::invalid_argument("binary graph ids are not strictly increasing");
+				}
+			}
+			if(offsets[0] != 0 || offsets.back() != targets.size())
+			{
+				throw std::invalid_argument("binary graph offsets are corrupted");
+			}
+			for(size_t i = 1; i < offsets.size(); ++i)
+			{
+				if(offsets[i - 1] > offsets[i])
+				{
+					throw std::invalid_argument("binary graph offsets are corrupted");
+				}
+			}
+			for(size_t target : targets)
+			{
+				if(target >= ids.size())
+				{
+					throw std::invalid_argument("binary graph edge target out of range");
+				}
+			}
+		}
+	}
+
+	/**
+	 * Saves frozen graph to file in binary format (loadable by loadBinary)
+	 * @param graph graph to be saved
+	 * @param filePath path to file
+	 * @return true if save was successful, false otherwise
+	 */
+	template<typename V, typename E>
+	bool saveBinary(const FrozenGraph<V,E>& graph, const std::string& filePath)
+	{
+		using namespace helper;
+
+		std::ofstream outputFile(filePath, std::ios::binary | std::ios::trunc);
+		if(!outputFile.is_open())
+		{
+			return false;
+		}
+
+		BinaryHeader header = {};
+		std::memcpy(header.magic, binaryMagic, sizeof(header.magic));
+		header.version = binaryVersion;
+		header.endianTag = binaryEndianTag;
+		header.flags = graph.isDirected() ? binaryDirectedFlag : 0;
+		header.vertexEncoding = uint32_t(binaryEncoding<V>());
+		header.vertexValueSize = uint32_t(sizeof(V));
+		header.edgeEncoding = uint32_t(binaryEncoding<E>());
+		header.edgeValueSize = uint32_t(sizeof(E));
+		header.verticesCount = graph.getVerticesCount();
+		header.edgesCount = graph.getEdgesCount();
+
+		// Header is written twice, section offsets are known only after sections are written
+		uint64_t position = 0;
+		writeBytes(outputFile, position, &header, sizeof(header));
+
+		writePadding(outputFile, position);
+		header.idsOffset = position;
+		writeSizes(outputFile, position, graph.getVerticesIds());
+
+		writePadding(outputFile, position);
+		header.offsetsOffset = position;
+		writeSizes(outputFile, position, graph.getOffsets());
+
+		writePadding(outputFile, position);
+		header.targetsOffset = position;
+		writeSizes(outputFile, position, graph.getTargets());
+
+		writePadding(outputFile, position);
+		header.weightsOffset = position;
+		writeValues(outputFile, position, graph.getWeights());
+
+		writePadding(outputFile, position);
+		header.valuesOffset = position;
+		writeValues(outputFile, position, graph.getValues());
+
+		writePadding(outputFile, position);
+		header.fileSize = position;
+
+		outputFile.seekp(0);
+		outputFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		outputFile.close();
+		return !outputFile.fail();
+	}
+
+	/**
+	 * Saves graph to file in binary format (loadable by loadBinary)
+	 * @param graph graph to be saved
+	 * @param filePath path to file
+	 * @return true if save was successful, false otherwise
+	 */
+	template<typename V, typename E, typename S>
+	bool saveBinary(const GraphBase<V,E,S>& graph, const std::string& filePath)
+	{
+		return saveBinary(freeze(graph), filePath);
+	}
+
+	/**
+	 * Loads graph saved by saveBinary as read-only CSR graph
+	 *
+	 * File is memory mapped and ids, offsets, targets and trivially copyable values
+	 * are used in place without parsing; the mapping is released with last copy of the graph.
+	 * Strings are copied out of string table. Ids, offsets and targets are validated by one pass
+	 * over them, unless the file is trusted, in which case only header and bounds of sections are validated.
+	 * @param filePath path to file
+	 * @param trusted true to skip validation of ids, offsets and targets (file was written by saveBinary or BinaryGraphBuilder)
+	 * @throws invalid_argument exception if file cannot be mapped, is not a binary graph, its arrays are corrupted
+	 *         or was saved with different vertex/edge types or on architecture with different byte order
+	 * @return frozen graph viewing file
+	 */
+	template<typename V, typename E>
+	FrozenGraph<V,E> loadBinary(const std::string& filePath, bool trusted = false)
+	{
+		using namespace helper;
+
+		auto file = std::make_shared<const MappedFile>(filePath);
+
+		BinaryHeader header;
+		if(file->size() < sizeof(header))
+		{
+			throw std::invalid_argument("file is not a binary graph");
+		}
+		std::memcpy(&header, file->data(), sizeof(header));
+
+		if(std::memcmp(header.magic, binaryMagic, sizeof(header.magic)) != 0)
+		{
+			throw std::invalid_argument("file is not a binary graph");
+		}
+		if(header.endianTag != binaryEndianTag)
+		{
+			throw std::invalid_argument("binary graph was saved with different byte order");
+		}
+		if(header.version != binaryVersion)
+		{
+			throw std::invalid_argument("unsupported binary graph version");
+		}
+		if(header.vertexEncoding != uint32_t(binaryEncoding<V>()) || header.vertexValueSize != sizeof(V) ||
+		        header.edgeEncoding != uint32_t(binaryEncoding<E>()) || header.edgeValueSize != sizeof(E))
+		{
+			throw std::invalid_argument("binary graph was saved with different vertex or edge type");
+		}
+		if(header.fileSize != file->size() || header.verticesCount >= file->size() ||
+		        header.edgesCount > file->size())
+		{
+			throw std::invalid_argument("binary graph file is truncated");
+		}
+
+		auto ids = readSizes(file, header.idsOffset, header.verticesCount);
+		auto offsets = readSizes(file, header.offsetsOffset, header.verticesCount + 1);
+		auto targets = readSizes(file, header.targetsOffset, header.edgesCount);
+		if(!trusted)
+		{
+			validateAdjacency(ids, offsets, targets);
+		}
+		return FrozenGraph<V,E>((header.flags & binaryDirectedFlag) != 0, std::move(ids),
+		                        readValues<V>(file, header.valuesOffset, header.verticesCount),
+		                        std::move(offsets), std::move(targets),
+		                        readValues<E>(file, header.weightsOffset, header.edgesCount));
+	}
+
+	/**
+	 * Hint about expected order of access to memory mapped graph
+	 */
+	enum class AccessPattern
+	{
+		// Default read-ahead of the system
+		Normal,
+		// Edges are read in order of positions (e.g. bellmanFord, bfsByLevels), aggressive read-ahead
+		Sequential,
+		// Edges are read in unpredictable order (e.g. dijkstraAll), read-ahead is disabled
+		Random,
+		// Whole adjacency will be needed soon and is read into page cache in background
+		WillNeed
+	};
+
+	namespace helper
+	{
+		template<typename T>
+		void adviseColumn(const Column<T>& column, AccessPattern pattern)
+		{
+#if !defined(_WIN32)
+			if(!column.isView() || column.empty())
+			{
+				return;
+			}
+			int advice = MADV_NORMAL;
+			switch(pattern)
+			{
+			case AccessPattern::Normal:
+				advice = MADV_NORMAL;
+				break;
+			case AccessPattern::Sequential:
+				advice = MADV_SEQUENTIAL;
+				break;
+			case AccessPattern::Random:
+				advice = MADV_RANDOM;
+				break;
+			case AccessPattern::WillNeed:
+				advice = MADV_WILLNEED;
+				break;
+			}
+			// Advice has to start at page boundary, it is only a hint, so failures are ignored
+			uintptr_t page = uintptr_t(::sysconf(_SC_PAGESIZE));
+			uintptr_t first = reinterpret_cast<uintptr_t>(column.data()) & ~(page - 1);
+			uintptr_t last = reinterpret_cast<uintptr_t>(column.data() + column.size());
+			::madvise(reinterpret_cast<void*>(first), size_t(last - first), advice);
+#else
+			(void)column;
+			(void)pattern;
+#endif
+		}
+
+		/**
+		 * Buffered writer of one section of file, sections can be written alternately
+		 */
+		class SectionWriter
+		{
+		private:
+			std::ofstream& outputFile;
+			uint64_t position;
+			std::vector<char> buffer;
+
+		public:
+			SectionWriter(std::ofstream& outputFile, uint64_t position)
+				:outputFile(outputFile), position(position)
+			{
+				buffer.reserve(size_t(1) << 20);
+			}
+
+			void write(const void* data, size_t bytes)
+			{
+				const char* first = static_cast<const char*>(data);
+				buffer.insert(buffer.end(), first, first + bytes);
+				if(buffer.size() >= (size_t(1) << 20))
+				{
+					flush();
+				}
+			}
+
+			void flush()
+			{
+				if(!buffer.empty())
+				{
+					outputFile.seekp(std::streamoff(position));
+					outputFile.write(buffer.data(), std::streamsize(buffer.size()));
+					position += buffer.size();
+					buffer.clear();
+				}
+			}
+		};
+	}
+
+	/**
+	 * Gives system hint about order in which adjacency of graph loaded by loadBinary will be read
+	 *
+	 * Applies only to columns viewing memory mapped file, graphs held in memory are not affected.
+	 * @param graph frozen graph
+	 * @param pattern expected access pattern
+	 */
+	template<typename V, typename E>
+	void adviseAccess(const FrozenGraph<V,E>& graph, AccessPattern pattern)
+	{
+		helper::adviseColumn(graph.getOffsets(), pattern);
+		helper::adviseColumn(graph.getTargets(), pattern);
+		helper::adviseColumn(graph.getWeights(), pattern);
+	}
+
+	/**
+	 * Builds binary graph file (loadable by loadBinary) from vertices and edges added in any order,
+	 * for graphs whose edges do not fit into memory
+	 *
+	 * Edges are collected in buffer of bounded size, full buffer is sorted and written to temporary
+	 * run file next to the output file, finish merges the runs directly into CSR sections of output file.
+	 * At most 64 runs are merged at once, more runs are first merged into longer runs in several passes.
+	 * Memory use is the buffer plus O(count of vertices). Vertex values are kept in memory.
+	 * Edges with unknown end vertices are skipped, duplicate edges keep the first added value
+	 * and each edge of undirected graph is stored in both directions (as in Graph).
+	 */
+	template<typename V, typename E>
+	class BinaryGraphBuilder
+	{
+	private:
+		static_assert(std::is_trivially_copyable<E>::value, "edges of built graph must be trivially copyable");
+
+		struct Record
+		{
+			uint64_t from;
+			uint64_t to;
+			uint64_t sequence;
+			E value;
+
+			bool operator<(const Record& other) const
+			{
+				return std::tie(from, to, sequence) < std::tie(other.from, other.to, other.sequence);
+			}
+		};
+
+		// Maximum count of runs merged at once
+		static constexpr size_t maxMergedRuns = 64;
+
+		std::string filePath;
+		bool directed;
+		size_t bufferedEdges;
+		uint64_t sequence = 0;
+		uint64_t recordsCount = 0;
+		std::vector<std::pair<size_t, V>> vertices;
+		std::vector<Record> buffer;
+		// Run files which were not merged yet
+		std::vector<std::string> runs;
+		size_t runsCreated = 0;
+
+		/**
+		 * Creates new run file, it is removed together with the other runs
+		 */
+		std::ofstream _createRun()
+		{
+			runs.push_back(filePath + ".run" + std::to_string(runsCreated++));
+			return std::ofstream(runs.back(), std::ios::binary | std::ios::trunc);
+		}
+
+		static void _writeRun(std::ofstream& runFile, const std::vector<Record>& records)
+		{
+			if(!runFile.write(reinterpret_cast<const char*>(records.data()), std::streamsize(records.size() * sizeof(Record))))
+			{
+				throw std::runtime_error("cannot write temporary run file");
+			}
+		}
+
+		void _spill()
+		{
+			std::sort(buffer.begin(), buffer.end());
+			std::ofstream runFile = _createRun();
+			_writeRun(runFile, buffer);
+			buffer.clear();
+		}
+
+		void _push(size_t from, size_t to, const E& value)
+		{
+			if(buffer.size() == bufferedEdges)
+			{
+				_spill();
+			}
+			buffer.push_back(Record{ from, to, sequence, value });
+			++recordsCount;
+		}
+
+		void _removeRuns()
+		{
+			for(const auto& run : runs)
+			{
+				std::remove(run.c_str());
+			}
+			runs.clear();
+			runsCreated = 0;
+		}
+
+		/**
+		 * Calls function on all edge records in sorted order (merging runs if buffer was spilled)
+		 */
+		template<typename Func>
+		void _merge(Func f)
+		{
+			std::sort(buffer.begin(), buffer.end());
+			if(runs.empty())
+			{
+				for(const auto& record : buffer)
+				{
+					f(record);
+				}
+				return;
+			}
+			if(!buffer.empty())
+			{
+				_spill();
+			}
+			buffer.shrink_to_fit();
+
+			// The first runs are merged into new run at the end until all runs can be merged at once,
+			// so every record is rewritten about log(runs) / log(maxMergedRuns) times
+			while(runs.size() > maxMergedRuns)
+			{
+				// Reserves share of buffer memory for output block
+				const size_t blockSize = std::max<size_t>(bufferedEdges / (maxMergedRuns + 1), 1);
+				std::vector<Record> output;
+				output.reserve(blockSize);
+				std::ofstream runFile = _createRun();
+				_mergeRuns(maxMergedRuns, [&](const Record& record)
+				{
+					output.push_back(record);
+					if(output.size() == blockSize)
+					{
+						_writeRun(runFile, output);
+						output.clear();
+					}
+				});
+				_writeRun(runFile, output);
+				runFile.close();
+				for(size_t i = 0; i < maxMergedRuns; ++i)
+				{
+					std::remove(runs[i].c_str());
+				}
+				runs.erase(runs.begin(), runs.begin() + maxMergedRuns);
+			}
+			_mergeRuns(runs.size(), f);
+		}
+
+		/**
+		 * Merges the first count runs and calls function on their records in sorted order
+		 */
+		template<typename Func>
+		void _mergeRuns(size_t count, Func f)
+		{
+			// Buffer memory is divided among readers of runs
+			struct Reader
+			{
+				std::ifstream file;
+				std::vector<Record> block;
+				size_t position = 0;
+			};
+			const size_t blockSize = std::max<size_t>(bufferedEdges / (count + 1), 1);
+			std::vector<Reader> readers(count);
+			auto refill = [&](Reader& reader)
+			{
+				reader.block.resize(blockSize);
+				reader.file.read(reinterpret_cast<char*>(reader.block.data()), std::streamsize(blockSize * sizeof(Record)));
+				// Only the end of file may cut the block short and it must not cut a record
+				size_t bytes = size_t(reader.file.gcount());
+				if(reader.file.bad() || (reader.file.fail() && !reader.file.eof()) || bytes % sizeof(Record) != 0)
+				{
+					throw std::runtime_error("cannot read temporary run file");
+				}
+				reader.block.resize(bytes / sizeof(Record));
+				reader.position = 0;
+				return !reader.block.empty();
+			};
+
+			using entry_t = std::pair<Record, size_t>;
+			auto greater = [](const entry_t& a, const entry_t& b) { return b.first < a.first; };
+			std::priority_queue<entry_t, std::vector<entry_t>, decltype(greater)> heads(greater);
+			for(size_t i = 0; i < count; ++i)
+			{
+				readers[i].file.open(runs[i], std::ios::binary);
+				if(!readers[i].file.is_open())
+				{
+					throw std::runtime_error("cannot open temporary run file");
+				}
+				if(refill(readers[i]))
+				{
+					heads.emplace(readers[i].block[readers[i].position++], i);
+				}
+			}
+			while(!heads.empty())
+			{
+				entry_t top = heads.top();
+				heads.pop();
+				f(top.first);
+				Reader& reader = readers[top.second];
+				if(reader.position < reader.block.size() || refill(reader))
+				{
+					heads.emplace(reader.block[reader.position++], top.second);
+				}
+			}
+		}
+
+	public:
+		/**
+		 * Creates builder of binary graph file
+		 * @param filePath path to output file, temporary files are created next to it
+		 * @param directed true for directed, false undirected
+		 * @param bufferedEdges count of edges kept in memory before they are written to temporary file
+		 */
+		BinaryGraphBuilder(std::string filePath, bool directed, size_t bufferedEdges = size_t(1) << 22)
+			:filePath(std::move(filePath)), directed(directed), bufferedEdges(std::max<size_t>(bufferedEdges, 1))
+		{
+			buffer.reserve(std::min<size_t>(this->bufferedEdges, size_t(1) << 16));
+		}
+
+		BinaryGraphBuilder(const BinaryGraphBuilder&) = delete;
+		BinaryGraphBuilder& operator=(const BinaryGraphBuilder&) = delete;
+
+		~BinaryGraphBuilder()
+		{
+			_removeRuns();
+		}
+
+		/**
+		 * Adds vertex to built graph
+		 * @param id id of vertex (unique)
+		 * @param value value of vertex
+		 */
+		void addVertex(size_t id, V value = V())
+		{
+			vertices.emplace_back(id, std::move(value));
+		}
+
+		/**
+		 * Adds edge to built graph (end vertices may be added later)
+		 * @param from id of vertex from
+		 * @param to id of vertex to
+		 * @param value value of edge
+		 */
+		void addEdge(size_t from, size_t to, const E& value = E())
+		{
+			_push(from, to, value);
+			if(!directed && from != to)
+			{
+				_push(to, from, value);
+			}
+			++sequence;
+		}
+
+		/**
+		 * Writes built graph to output file and removes temporary files, builder is empty afterwards
+		 * @throws invalid_argument exception if some vertex id was added more than once
+		 * @throws runtime_error exception if temporary run file cannot be written, opened or read
+		 * @return true if graph was written successfully, false otherwise
+		 */
+		bool finish()
+		{
+			using namespace helper;
+
+			std::stable_sort(vertices.begin(), vertices.end(),
+			                 [](const std::pair<size_t, V>& a, const std::pair<size_t, V>& b) { return a.first < b.first; });
+			std::vector<size_t> ids;
+			std::vector<V> values;
+			ids.reserve(vertices.size());
+			values.reserve(vertices.size());
+			for(auto& v : vertices)
+			{
+				if(!ids.empty() && ids.back() == v.first)
+				{
+					_removeRuns();
+					throw std::invalid_argument("vertex id was added more than once");
+				}
+				ids.push_back(v.first);
+				values.push_back(std::move(v.second));
+			}
+			vertices = {};
+			const size_t n = ids.size();
+
+			std::ofstream outputFile(filePath, std::ios::binary | std::ios::trunc);
+			if(!outputFile.is_open())
+			{
+				_removeRuns();
+				return false;
+			}
+
+			// Final count of edges is known only after duplicates are merged, so sections of edges
+			// are placed for all added edges and sections after them follow this upper bound
+			BinaryHeader header = {};
+			std::memcpy(header.magic, binaryMagic, sizeof(header.magic));
+			header.version = binaryVersion;
+			header.endianTag = binaryEndianTag;
+			header.flags = directed ? binaryDirectedFlag : 0;
+			header.vertexEncoding = uint32_t(binaryEncoding<V>());
+			header.vertexValueSize = uint32_t(sizeof(V));
+			header.edgeEncoding = uint32_t(binaryEncoding<E>());
+			header.edgeValueSize = uint32_t(sizeof(E));
+			header.verticesCount = n;
+			header.idsOffset = alignedSection(sizeof(header));
+			header.offsetsOffset = alignedSection(header.idsOffset + n * sizeof(uint64_t));
+			header.targetsOffset = alignedSection(header.offsetsOffset + (n + 1) * sizeof(uint64_t));
+			header.weightsOffset = alignedSection(header.targetsOffset + recordsCount * sizeof(uint64_t));
+			header.valuesOffset = alignedSection(header.weightsOffset + (isRawValue<E>::value ? recordsCount * sizeof(E) : 0));
+
+			std::vector<size_t> offsets(n + 1, 0);
+			SectionWriter targets(outputFile, header.targetsOffset);
+			SectionWriter weights(outputFile, header.weightsOffset);
+			uint64_t edgesCount = 0;
+			size_t lastFrom = FrozenGraph<V,E>::npos;
+			size_t lastTo = FrozenGraph<V,E>::npos;
+
+			_merge([&](const Record& record)
+			{
+				auto from = std::lower_bound(ids.begin(), ids.end(), record.from);
+				auto to = std::lower_bound(ids.begin(), ids.end(), record.to);
+				if(from == ids.end() || *from != record.from || to == ids.end() || *to != record.to)
+				{
+					return;
+				}
+				size_t fromIndex = size_t(from - ids.begin());
+				uint64_t toIndex = uint64_t(to - ids.begin());
+				// Records of same edge are adjacent and the first added one comes first
+				if(fromIndex == lastFrom && toIndex == lastTo)
+				{
+					return;
+				}
+				lastFrom = fromIndex;
+				lastTo = size_t(toIndex);
+				++offsets[fromIndex + 1];
+				targets.write(&toIndex, sizeof(toIndex));
+				if(isRawValue<E>::value)
+				{
+					weights.write(&record.value, sizeof(E));
+				}
+				++edgesCount;
+			});
+			targets.flush();
+			weights.flush();
+			_removeRuns();
+			buffer = {};
+			recordsCount = 0;
+
+			for(size_t i = 0; i < n; ++i)
+			{
+				offsets[i + 1] += offsets[i];
+			}
+			header.edgesCount = edgesCount;
+
+			outputFile.seekp(std::streamoff(header.idsOffset));
+			uint64_t position = header.idsOffset;
+			writeSizes(outputFile, position, Column<size_t>(std::move(ids)));
+			writePadding(outputFile, position);
+			writeSizes(outputFile, position, Column<size_t>(std::move(offsets)));
+
+			outputFile.seekp(std::streamoff(header.valuesOffset));
+			position = header.valuesOffset;
+			writeValues(outputFile, position, Column<V>(std::move(values)));
+			writePadding(outputFile, position);
+			header.fileSize = position;
+
+			outputFile.seekp(0);
+			outputFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			outputFile.close();
+			return !outputFile.fail();
+		}
+	};
+
+	/**
+	 * Progress of streaming import, passed to progress callback after each batch of edges
+	 */
+	struct ImportProgress
+	{
+		// Bytes of file read so far
+		uint64_t bytes = 0;
+		// Edges read from file (including duplicates, which are not inserted)
+		uint64_t edges = 0;
+		// Edges inserted into graph
+		uint64_t insertedEdges = 0;
+		// Vertices created by import
+		uint64_t vertices = 0;
+		// Seconds since start of import
+		double seconds = 0;
+
+		double edgesPerSecond() const
+		{
+			return seconds > 0 ? double(edges) / seconds : 0;
+		}
+
+		double megabytesPerSecond() const
+		{
+			return seconds > 0 ? double(bytes) / (1 << 20) / seconds : 0;
+		}
+	};
+
+	/**
+	 * Mapping of vertex ids used in imported file to ids of graph
+	 */
+	using ExternalIds = std::unordered_map<size_t, size_t>;
+
+	namespace helper
+	{
+		/**
+		 * Value of vertex created for external id (the id itself for numbers and strings)
+		 */
+		template<typename V>
+		std::enable_if_t<std::is_arithmetic<V>::value, V> externalIdValue(size_t id)
+		{
+			return V(id);
+		}
+
+		template<typename V>
+		std::enable_if_t<std::is_same<V, std::string>::value, V> externalIdValue(size_t id)
+		{
+			return std::to_string(id);
+		}
+
+		template<typename V>
+		std::enable_if_t<!std::is_arithmetic<V>::value && !std::is_same<V, std::string>::value, V> externalIdValue(size_t)
+		{
+			return V();
+		}
+
+		/**
+		 * Negates value of mirrored entry of skew-symmetric matrix
+		 * @return false if value cannot be negated (non-zero value of unsigned type, type which is not numeric)
+		 */
+		template<typename E>
+		std::enable_if_t<std::is_arithmetic<E>::value && std::is_signed<E>::value, bool> negateValue(E& value)
+		{
+			value = -value;
+			return true;
+		}
+
+		template<typename E>
+		std::enable_if_t<std::is_unsigned<E>::value, bool> negateValue(E& value)
+		{
+			return value == E();
+		}
+
+		template<typename E>
+		std::enable_if_t<!std::is_arithmetic<E>::value, bool> negateValue(E&)
+		{
+			return std::is_same<E, Unweight>::value;
+		}
+
+		/**
+		 * Parses value of imported edge, the rest of line has to hold just the value
+		 * (integers and floating point numbers are checked for range, other types are read by operator>>)
+		 * @return false if value is malformed, out of range or followed by other text
+		 */
+		template<typename T>
+		std::enable_if_t<isTextInteger<T>::value, bool> parseImportValue(const char* pos, const char* end, T& value)
+		{
+			const char* first = skipBlanks(pos, end);
+			bool negative = first != end && *first == '-';
+			const char* digits = (first != end && (*first == '+' || negative)) ? first + 1 : first;
+			const char* last = digits;
+			while(last != end && *last >= '0' && *last <= '9')
+			{
+				++last;
+			}
+			if(last == digits || skipBlanks(last, end) != end || (negative && std::is_unsigned<T>::value))
+			{
+				return false;
+			}
+
+			using U = std::make_unsigned_t<T>;
+			U limit = negative ? U(U(std::numeric_limits<T>::max()) + 1) : U(std::numeric_limits<T>::max());
+			U result = 0;
+			for(; digits != last; ++digits)
+			{
+				U digit = U(*digits - '0');
+				if(result > U((limit - digit) / 10))
+				{
+					return false;
+				}
+				result = U(result * 10 + digit);
+			}
+			value = negative ? T(U(0) - result) : T(result);
+			return true;
+		}
+
+		template<typename T>
+		std::enable_if_t<std::is_floating_point<T>::value, bool> parseImportValue(const char* pos, const char* end, T& value)
+		{
+			const char* first = skipBlanks(pos, end);
+			const char* last = first;
+			while(last != end && *last != ' ' && *last != '\t')
+			{
+				++last;
+			}
+			if(first == last || skipBlanks(last, end) != end)
+			{
+				return false;
+			}
+			// Number is copied, as strtod needs terminated string
+			std::string token(first, last);
+			char* parsedEnd = nullptr;
+			errno = 0;
+			T result = parseFloating(token.c_str(), &parsedEnd, T());
+			if(parsedEnd != token.c_str() + token.size() || errno == ERANGE)
+			{
+				return false;
+			}
+			value = result;
+			return true;
+		}
+
+		template<typename T>
+		std::enable_if_t<!isTextInteger<T>::value && !std::is_floating_point<T>::value, bool> parseImportValue(const char* pos, const char* end, T& value)
+		{
+			std::istringstream ss(std::string(pos, end));
+			return (ss >> value) && (ss >> std::ws).eof();
+		}
+
+		inline bool parseImportValue(const char* pos, const char* end, std::string& value)
+		{
+			const char* first = skipBlanks(pos, end);
+			if(first == end || *first != '"' || !parseTextQuoted(first, end, value))
+			{
+				return false;
+			}
+			const char* last = end - 1;
+			while(*last != '"')
+			{
+				--last;
+			}
+			return skipBlanks(last + 1, end) == end;
+		}
+
+		// Value column is ignored by unweighted graph
+		inline bool parseImportValue(const char*, const char*, Unweight&)
+		{
+			return true;
+		}
+
+		/**
+		 * Element of batch passed to addEdges ({from, to, value}, or {from, to} for unweighted graph)
+		 */
+		template<typename E>
+		struct ImportEdge
+		{
+			using type = std::tuple<size_t, size_t, E>;
+
+			static type make(size_t from, size_t to, E value)
+			{
+				return type(from, to, std::move(value));
+			}
+		};
+
+		template<>
+		struct ImportEdge<Unweight>
+		{
+			using type = std::pair<size_t, size_t>;
+
+			static type make(size_t from, size_t to, Unweight)
+			{
+				return type(from, to);
+			}
+		};
+
+		/**
+		 * Calls function on each line of file, file is read in blocks, so memory use does not depend on its size
+		 * @param inputFile opened file
+		 * @param bytes count of read bytes, updated after each block
+		 * @param f function taking begin and end of line (without new line), returns false to stop reading
+		 * @return false if reading was stopped by function
+		 */
+		template<typename Func>
+		bool forEachLine(std::ifstream& inputFile, uint64_t& bytes, Func f)
+		{
+			const size_t blockSize = size_t(1) << 22;
+			std::string buffer;
+
+			while(true)
+			{
+				size_t carried = buffer.size();
+				buffer.resize(carried + blockSize);
+				inputFile.read(&buffer[carried], std::streamsize(blockSize));
+				buffer.resize(carried + size_t(inputFile.gcount()));
+				bytes += uint64_t(inputFile.gcount());
+				bool lastBlock = !inputFile;
+
+				const char* pos = buffer.data();
+				const char* end = pos + buffer.size();
+				while(pos != end)
+				{
+					const char* newLine = static_cast<const char*>(std::memchr(pos, '\n', size_t(end - pos)));
+					if(!newLine && !lastBlock)
+					{
+						break;
+					}
+					const char* lineEnd = newLine ? newLine : end;
+					const char* next = newLine ? newLine + 1 : end;
+					if(lineEnd != pos && lineEnd[-1] == '\r')
+					{
+						--lineEnd;
+					}
+					if(!f(pos, lineEnd))
+					{
+						return false;
+					}
+					pos = next;
+				}
+
+				buffer.erase(0, size_t(pos - buffer.data()));
+				if(lastBlock)
+				{
+					return true;
+				}
+			}
+		}
+
+		/**
+		 * Collects imported edges into bounded batches inserted by addEdges and creates vertices for external ids
+		 */
+		template<typename V, typename E, typename S, typename Progress>
+		class EdgeImporter
+		{
+		private:
+			using edge_t = typename ImportEdge<E>::type;
+
+			static constexpr size_t batchSize = size_t(1) << 20;
+
+			Graph<V,E,S>& graph;
+			ExternalIds& ids;
+			Progress& progress;
+			std::vector<edge_t> batch;
+			std::chrono::steady_clock::time_point start;
+
+		public:
+			ImportProgress state;
+
+			EdgeImporter(Graph<V,E,S>& graph, ExternalIds& ids, Progress& progress)
+				:graph(graph), ids(ids), progress(progress), start(std::chrono::steady_clock::now())
+			{
+				batch.reserve(batchSize);
+			}
+
+			/**
+			 * Get id of vertex for external id, vertex is created on first use
+			 * @param external id used in file
+			 * @return id of vertex in graph
+			 */
+			size_t vertex(size_t external)
+			{
+				auto found = ids.find(external);
+				if(found != ids.end())
+				{
+					return found->second;
+				}
+				size_t id = graph.addVertex(externalIdValue<V>(external));
+				ids.emplace(external, id);
+				++state.vertices;
+				return id;
+			}
+
+			void edge(size_t from, size_t to, E value)
+			{
+				batch.push_back(ImportEdge<E>::make(from, to, std::move(value)));
+				++state.edges;
+				if(batch.size() == batchSize)
+				{
+					flush();
+				}
+			}
+
+			/**
+			 * Inserts collected edges and reports progress
+			 */
+			void flush()
+			{
+				state.insertedEdges += graph.addEdges(batch);
+				batch.clear();
+				state.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				progress(static_cast<const ImportProgress&>(state));
+			}
+		};
+
+		inline bool isCommentOrBlank(const char* pos, const char* end, char comment)
+		{
+			pos = skipBlanks(pos, end);
+			return pos == end || *pos == comment;
+		}
+
+		inline std::string lowerToken(const char*& pos, const char* end)
+		{
+			pos = skipBlanks(pos, end);
+			std::string token;
+			for(; pos != end && *pos != ' ' && *pos != '\t'; ++pos)
+			{
+				token.push_back(char(std::tolower(static_cast<unsigned char>(*pos))));
+			}
+			return token;
+		}
+	}
+
+	/**
+	 * Imports edges from whitespace separated edge list (SNAP format: "from to [value]" per line, '#' starts comment)
+	 *
+	 * File is read in blocks and edges are inserted in batches by addEdges, memory use does not depend
+	 * on size of file. Vertex is created for each new external id (its value is the id for numeric and string
+	 * vertex types), edges without value get default constructed value and duplicate edges keep the first value.
+	 * Value has to be valid for type of edge value and be the last token of line (strings are quoted).
+	 * Import adds to current content of graph; on malformed line it stops, edges read before it stay in graph.
+	 * @param graph graph to import to
+	 * @param filePath path to file
+	 * @param ids mapping of external ids to ids of graph (extended by import, may be reused for more files)
+	 * @param progress function called with ImportProgress after each batch of edges and at the end
+	 * @return true if import was successful, false if file cannot be opened or contains malformed line
+	 */
+	template<typename V, typename E, typename S, typename Progress>
+	bool importEdgeList(Graph<V,E,S>& graph, const std::string& filePath, ExternalIds& ids, Progress progress)
+	{
+		std::ifstream inputFile(filePath, std::ios::binary);
+		if(!inputFile.is_open())
+		{
+			return false;
+		}
+
+		helper::EdgeImporter<V, E, S, Progress> importer(graph, ids, progress);
+		bool retValue = helper::forEachLine(inputFile, importer.state.bytes, [&](const char* pos, const char* end)
+		{
+			if(helper::isCommentOrBlank(pos, end, '#'))
+			{
+				return true;
+			}
+			size_t from, to;
+			if(!helper::parseTextId(pos, end, from) || !helper::parseTextId(pos, end, to))
+			{
+				return false;
+			}
+			E value = E();
+			if(helper::skipBlanks(pos, end) != end && !helper::parseImportValue(pos, end, value))
+			{
+				return false;
+			}
+			size_t fromId = importer.vertex(from);
+			importer.edge(fromId, importer.vertex(to), std::move(value));
+			return true;
+		});
+		importer.flush();
+		return retValue;
+	}
+
+	/**
+	 * Imports edges from whitespace separated edge list, see importEdgeList above
+	 * @param graph graph to import to
+	 * @param filePath path to file
+	 * @return true if import was successful, false if file cannot be opened or contains malformed line
+	 */
+	template<typename V, typename E, typename S>
+	bool importEdgeList(Graph<V,E,S>& graph, const std::string& filePath)
+	{
+		ExternalIds ids;
+		return importEdgeList(graph, filePath, ids, [](const ImportProgress&) { });
+	}
+
+	/**
+	 * Imports sparse matrix in Matrix Market coordinate format as graph (entry "i j [value]" is edge i -> j)
+	 *
+	 * Vertex is created for each of max(rows, columns) indices (external ids are 1-based indices),
+	 * pattern matrices give default constructed edge values. Entries of symmetric and skew-symmetric
+	 * matrices are mirrored in directed graph (skew-symmetric with negated value).
+	 * File is read in blocks and edges are inserted in batches by addEdges, memory use does not depend
+	 * on size of file. Import adds to current content of graph; on error edges read before it stay in graph.
+	 * @param graph graph to import to
+	 * @param filePath path to file
+	 * @param ids mapping of external ids to ids of graph (extended by import)
+	 * @param progress function called with ImportProgress after each batch of edges and at the end
+	 * @return true if import was successful, false if file cannot be opened, is not coordinate matrix
+	 *         with real, integer or pattern values, or contains malformed or out of range entry
+	 *         (or non-zero entry of skew-symmetric matrix which type of edge value cannot negate)
+	 */
+	template<typename V, typename E, typename S, typename Progress>
+	bool importMatrixMarket(Graph<V,E,S>& graph, const std::string& filePath, ExternalIds& ids, Progress progress)
+	{
+		std::ifstream inputFile(filePath, std::ios::binary);
+		if(!inputFile.is_open())
+		{
+			return false;
+		}
+
+		helper::EdgeImporter<V, E, S, Progress> importer(graph, ids, progress);
+		bool headerRead = false, sizeRead = false;
+		bool symmetric = false, skew = false, pattern = false;
+		size_t rows = 0, columns = 0, entries = 0, readEntries = 0;
+
+		bool retValue = helper::forEachLine(inputFile, importer.state.bytes, [&](const char* pos, const char* end)
+		{
+			if(!headerRead)
+			{
+				headerRead = true;
+				if(helper::lowerToken(pos, end) != "%%matrixmarket" || helper::lowerToken(pos, end) != "matrix" ||
+				        helper::lowerToken(pos, end) != "coordinate")
+				{
+					return false;
+				}
+				std::string field = helper::lowerToken(pos, end);
+				std::string symmetry = helper::lowerToken(pos, end);
+				pattern = field == "pattern";
+				symmetric = symmetry == "symmetric";
+				skew = symmetry == "skew-symmetric";
+				return (pattern || field == "real" || field == "double" || field == "integer") &&
+				       (symmetric || skew || symmetry == "general");
+			}
+			if(helper::isCommentOrBlank(pos, end, '%'))
+			{
+				return true;
+			}
+			if(!sizeRead)
+			{
+				sizeRead = true;
+				if(!helper::parseTextId(pos, end, rows) || !helper::parseTextId(pos, end, columns) ||
+				        !helper::parseTextId(pos, end, entries))
+				{
+					return false;
+				}
+				for(size_t i = 1; i <= std::max(rows, columns); ++i)
+				{
+					importer.vertex(i);
+				}
+				return true;
+			}
+
+			size_t row, column;
+			if(!helper::parseTextId(pos, end, row) || !helper::parseTextId(pos, end, column) ||
+			        row == 0 || row > rows || column == 0 || column > columns || ++readEntries > entries)
+			{
+				return false;
+			}
+			E value = E();
+			if(pattern ? helper::skipBlanks(pos, end) != end : !helper::parseImportValue(pos, end, value))
+			{
+				return false;
+			}
+			size_t from = importer.vertex(row), to = importer.vertex(column);
+			if((symmetric || skew) && graph.isDirected() && from != to)
+			{
+				E mirrored = value;
+				if(skew && !helper::negateValue(mirrored))
+				{
+					return false;
+				}
+				importer.edge(to, from, std::move(mirrored));
+			}
+			importer.edge(from, to, std::move(value));
+			return true;
+		});
+		importer.flush();
+		return retValue && sizeRead && readEntries == entries;
+	}
+
+	/**
+	 * Imports sparse matrix in Matrix Market coordinate format as graph, see importMatrixMarket above
+	 * @param graph graph to import to
+	 * @param filePath path to file
+	 * @return true if import was successful
+	 */
+	template<typename V, typename E, typename S>
+	bool importMatrixMarket(Graph<V,E,S>& graph, const std::string& filePath)
+	{
+		ExternalIds ids;
+		return importMatrixMarket(graph, filePath, ids, [](const ImportProgress&) { });
+	}
+}
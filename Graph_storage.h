@@ -0,0 +1,2062 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <tuple>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <new>
+#include <bitset>
+#include <cstddef>
+
+namespace Graph
+{
+	/**
+	 * Map-like container whose keys index directly into array of slots
+	 *
+	 * Slots are kept in chunks of 64 which are never reallocated, so values keep their address
+	 * while container grows. Erased slots stay in place as tombstones and their keys are kept in free-list,
+	 * so they can be handed out again by acquireKey. Lookup is O(1), iteration goes
+	 * over used slots in ascending order of keys. Interface mirrors the part of
+	 * std::map<size_t, T> which is used by graph classes.
+	 */
+	template<typename T, template<typename> class Allocator = std::allocator>
+	class SlotMap
+	{
+	public:
+		using key_type = size_t;
+		using mapped_type = T;
+		using value_type = std::pair<const size_t, T>;
+		using size_type = size_t;
+
+	private:
+		struct Slot
+		{
+			bool used = false;
+			typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type storage;
+
+			Slot()
+			{}
+
+			Slot(const Slot& other)
+			{
+				if(other.used)
+				{
+					construct(*other.get());
+				}
+			}
+
+			Slot(Slot&& other) noexcept(std::is_nothrow_move_constructible<value_type>::value)
+			{
+				if(other.used)
+				{
+					construct(std::move(*other.get()));
+				}
+			}
+
+			Slot& operator=(const Slot& other)
+			{
+				if(this != &other)
+				{
+					reset();
+					if(other.used)
+					{
+						construct(*other.get());
+					}
+				}
+				return *this;
+			}
+
+			Slot& operator=(Slot&& other)
+			{
+				if(this != &other)
+				{
+					reset();
+					if(other.used)
+					{
+						construct(std::move(*other.get()));
+					}
+				}
+				return *this;
+			}
+
+			~Slot()
+			{
+				reset();
+			}
+
+			template<typename... Args>
+			void construct(Args&&... args)
+			{
+				new(&storage) value_type(std::forward<Args>(args)...);
+				used = true;
+			}
+
+			void reset()
+			{
+				if(used)
+				{
+					get()->~value_type();
+					used = false;
+				}
+			}
+
+			value_type* get()
+			{
+				return reinterpret_cast<value_type*>(&storage);
+			}
+
+			const value_type* get() const
+			{
+				return reinterpret_cast<const value_type*>(&storage);
+			}
+		};
+
+		using chunk_type = std::vector<Slot, Allocator<Slot>>;
+		using table_type = std::vector<chunk_type, Allocator<chunk_type>>;
+		static constexpr size_t chunkSize = 64;
+
+		template<typename Table, typename Value>
+		class Iterator
+		{
+		private:
+			friend class SlotMap;
+			Table* table;
+			size_t key;
+			size_t last;
+
+			void skipUnused()
+			{
+				while(key < last && !slot().used)
+				{
+					++key;
+				}
+			}
+
+			auto slot() const -> decltype((*table)[0][0])
+			{
+				return (*table)[key / chunkSize][key % chunkSize];
+			}
+
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = Value;
+			using difference_type = std::ptrdiff_t;
+			using pointer = Value*;
+			using reference = Value&;
+
+			Iterator()
+				:table(nullptr), key(0), last(0)
+			{}
+
+			Iterator(Table* table, size_t key, size_t last)
+				:table(table), key(key), last(last)
+			{
+				skipUnused();
+			}
+
+			// Conversion from iterator to const_iterator
+			template<typename OtherTable, typename OtherValue>
+			Iterator(const Iterator<OtherTable, OtherValue>& other)
+				:table(other.table), key(other.key), last(other.last)
+			{}
+
+			reference operator*() const
+			{
+				return *slot().get();
+			}
+
+			pointer operator->() const
+			{
+				return slot().get();
+			}
+
+			Iterator& operator++()
+			{
+				++key;
+				skipUnused();
+				return *this;
+			}
+
+			Iterator operator++(int)
+			{
+				Iterator tmp = *this;
+				++(*this);
+				return tmp;
+			}
+
+			bool operator==(const Iterator& rhs) const
+			{
+				return key == rhs.key;
+			}
+
+			bool operator!=(const Iterator& rhs) const
+			{
+				return key != rhs.key;
+			}
+
+			template<typename, typename>
+			friend class Iterator;
+		};
+
+		table_type chunks;
+		std::vector<size_t, Allocator<size_t>> freeKeys;
+		// Count of keys covered by slots (used or not), chunks may hold a few more unused slots
+		size_t slotsCount = 0;
+		size_t usedCount = 0;
+
+		bool isUsed(size_t key) const
+		{
+			return key < slotsCount && chunks[key / chunkSize][key % chunkSize].used;
+		}
+
+		Slot& slot(size_t key)
+		{
+			return chunks[key / chunkSize][key % chunkSize];
+		}
+
+	public:
+		using iterator = Iterator<table_type, value_type>;
+		using const_iterator = Iterator<const table_type, const value_type>;
+
+		iterator begin()
+		{
+			return iterator(&chunks, 0, slotsCount);
+		}
+
+		iterator end()
+		{
+			return iterator(&chunks, slotsCount, slotsCount);
+		}
+
+		const_iterator begin() const
+		{
+			return const_iterator(&chunks, 0, slotsCount);
+		}
+
+		const_iterator end() const
+		{
+			return const_iterator(&chunks, slotsCount, slotsCount);
+		}
+
+		size_t size() const
+		{
+			return usedCount;
+		}
+
+		bool empty() const
+		{
+			return usedCount == 0;
+		}
+
+		/**
+		 * Get count of slots (used or not), every key is less than this bound
+		 * @return count of slots
+		 */
+		size_t capacity() const
+		{
+			return slotsCount;
+		}
+
+		void clear()
+		{
+			chunks.clear();
+			freeKeys.clear();
+			slotsCount = 0;
+			usedCount = 0;
+		}
+
+		iterator find(size_t key)
+		{
+			return isUsed(key) ? iterator(&chunks, key, slotsCount) : end();
+		}
+
+		const_iterator find(size_t key) const
+		{
+			return isUsed(key) ? const_iterator(&chunks, key, slotsCount) : end();
+		}
+
+		size_t count(size_t key) const
+		{
+			return isUsed(key) ? 1 : 0;
+		}
+
+		/**
+		 * Constructs value at given key, keys skipped by growing the array are put into free-list
+		 * @param key key of new value
+		 * @param args arguments for constructor of value
+		 * @return iterator to value with given key and true if it was inserted
+		 */
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(size_t key, Args&&... args)
+		{
+			if(key >= slotsCount)
+			{
+				while(chunks.size() * chunkSize <= key)
+				{
+					chunks.emplace_back(chunkSize);
+				}
+				for(size_t k = slotsCount; k < key; ++k)
+				{
+					freeKeys.push_back(k);
+				}
+				slotsCount = key + 1;
+			}
+			else if(slot(key).used)
+			{
+				return { find(key), false };
+			}
+
+			slot(key).construct(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+			++usedCount;
+			return { find(key), true };
+		}
+
+		/**
+		 * Destroys value with given key and marks its slot as free
+		 * @param key key of value
+		 * @return number of erased values - at most 1
+		 */
+		size_t erase(size_t key)
+		{
+			if(!isUsed(key))
+			{
+				return 0;
+			}
+			slot(key).reset();
+			freeKeys.push_back(key);
+			--usedCount;
+			return 1;
+		}
+
+		/**
+		 * Hands out key for new value - released key if there is any, next value of counter otherwise
+		 * @param counter counter of keys which were never used
+		 * @return unused key
+		 */
+		size_t acquireKey(size_t& counter)
+		{
+			// Free-list is validated lazily, as slot could have been taken by emplace with explicit key
+			while(!freeKeys.empty())
+			{
+				size_t key = freeKeys.back();
+				freeKeys.pop_back();
+				if(key < slotsCount && !slot(key).used)
+				{
+					return key;
+				}
+			}
+			counter = std::max(counter, slotsCount);
+			return counter++;
+		}
+
+		/**
+		 * Get bytes allocated by table of chunks, chunks and free-list
+		 * @return allocated bytes
+		 */
+		size_t allocatedBytes() const
+		{
+			return chunks.capacity() * sizeof(chunk_type) + chunks.size() * chunkSize * sizeof(Slot) + freeKeys.capacity() * sizeof(size_t);
+		}
+
+		bool operator==(const SlotMap& rhs) const
+		{
+			return usedCount == rhs.usedCount && std::equal(begin(), end(), rhs.begin());
+		}
+
+		bool operator!=(const SlotMap& rhs) const
+		{
+			return !(*this == rhs);
+		}
+	};
+
+	template<typename T, template<typename> class Allocator>
+	constexpr size_t SlotMap<T, Allocator>::chunkSize;
+
+	/**
+	 * Map-like container keeping pairs of <key, value> sorted in contiguous vector
+	 *
+	 * Lookup is binary search, insertion and erasure shift the following items, so it suits
+	 * adjacency which is read far more often than modified. Iteration is sequential in memory.
+	 * Interface mirrors the part of std::map<size_t, T> which is used by graph classes.
+	 */
+	template<typename T, template<typename> class Allocator = std::allocator>
+	class FlatMap
+	{
+	public:
+		using key_type = size_t;
+		using mapped_type = T;
+		using value_type = std::pair<size_t, T>;
+		using size_type = size_t;
+
+	private:
+		using container_type = std::vector<value_type, Allocator<value_type>>;
+
+		container_type items;
+
+		static bool keyLess(const value_type& item, size_t key)
+		{
+			return item.first < key;
+		}
+
+	public:
+		using iterator = typename container_type::iterator;
+		using const_iterator = typename container_type::const_iterator;
+
+		iterator begin()
+		{
+			return items.begin();
+		}
+
+		iterator end()
+		{
+			return items.end();
+		}
+
+		const_iterator begin() const
+		{
+			return items.begin();
+		}
+
+		const_iterator end() const
+		{
+			return items.end();
+		}
+
+		size_t size() const
+		{
+			return items.size();
+		}
+
+		bool empty() const
+		{
+			return items.empty();
+		}
+
+		/**
+		 * Get count of items which fit into already allocated memory
+		 * @return capacity
+		 */
+		size_t capacity() const
+		{
+			return items.capacity();
+		}
+
+		void reserve(size_t count)
+		{
+			items.reserve(count);
+		}
+
+		/**
+		 * Get bytes allocated by item vector
+		 * @return allocated bytes
+		 */
+		size_t allocatedBytes() const
+		{
+			return items.capacity() * sizeof(value_type);
+		}
+
+		void clear()
+		{
+			items.clear();
+		}
+
+		iterator lower_bound(size_t key)
+		{
+			return std::lower_bound(items.begin(), items.end(), key, keyLess);
+		}
+
+		const_iterator lower_bound(size_t key) const
+		{
+			return std::lower_bound(items.begin(), items.end(), key, keyLess);
+		}
+
+		iterator find(size_t key)
+		{
+			auto it = lower_bound(key);
+			return (it != items.end() && it->first == key) ? it : items.end();
+		}
+
+		const_iterator find(size_t key) const
+		{
+			auto it = lower_bound(key);
+			return (it != items.end() && it->first == key) ? it : items.end();
+		}
+
+		size_t count(size_t key) const
+		{
+			return find(key) != items.end() ? 1 : 0;
+		}
+
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(size_t key, Args&&... args)
+		{
+			auto it = lower_bound(key);
+			if(it != items.end() && it->first == key)
+			{
+				return { it, false };
+			}
+			it = items.emplace(it, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+			return { it, true };
+		}
+
+		/**
+		 * Inserts value, hint is used only if it is the right position (then no search is done)
+		 * @param hint position before which value should be inserted
+		 * @param key key of value
+		 * @param args arguments for constructor of value
+		 * @return iterator to value with given key
+		 */
+		template<typename... Args>
+		iterator emplace_hint(const_iterator hint, size_t key, Args&&... args)
+		{
+			if((hint == items.cend() || key < hint->first) && (hint == items.cbegin() || std::prev(hint)->first < key))
+			{
+				return items.emplace(hint, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+			}
+			return emplace(key, std::forward<Args>(args)...).first;
+		}
+
+		size_t erase(size_t key)
+		{
+			auto it = find(key);
+			if(it == items.end())
+			{
+				return 0;
+			}
+			items.erase(it);
+			return 1;
+		}
+
+		iterator erase(const_iterator position)
+		{
+			return items.erase(position);
+		}
+
+		/**
+		 * Merges sorted range of <key, value> pairs in O(n + k), keys which are already present
+		 * (or repeated in range) are skipped
+		 * @param first iterator to first pair
+		 * @param last iterator behind last pair
+		 * @param onInserted function called with key of every inserted pair
+		 * @param onSkipped function called with key and value of every skipped pair
+		 */
+		template<typename Iterator, typename Func, typename FuncSkipped>
+		void mergeSorted(Iterator first, Iterator last, Func onInserted, FuncSkipped onSkipped)
+		{
+			size_t oldSize = items.size();
+			size_t pos = 0;
+			for(auto it = first; it != last; ++it)
+			{
+				size_t key = it->first;
+				while(pos < oldSize && items[pos].first < key)
+				{
+					++pos;
+				}
+				if((items.size() > oldSize && items.back().first == key) || (pos < oldSize && items[pos].first == key))
+				{
+					onSkipped(key, it->second);
+					continue;
+				}
+				items.emplace_back(key, std::move(it->second));
+				onInserted(key);
+			}
+
+			std::inplace_merge(items.begin(), items.begin() + oldSize, items.end(), [](const value_type& a, const value_type& b)
+			{
+				return a.first < b.first;
+			});
+		}
+
+		bool operator==(const FlatMap& rhs) const
+		{
+			return items == rhs.items;
+		}
+
+		bool operator!=(const FlatMap& rhs) const
+		{
+			return !(*this == rhs);
+		}
+	};
+
+	/**
+	 * Iterator adaptor going over keys of map-like container
+	 */
+	template<typename Iterator>
+	class KeyIterator
+	{
+	private:
+		Iterator it;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = size_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const size_t*;
+		using reference = const size_t&;
+
+		KeyIterator()
+			:it()
+		{}
+
+		explicit KeyIterator(Iterator it)
+			:it(it)
+		{}
+
+		reference operator*() const
+		{
+			return it->first;
+		}
+
+		KeyIterator& operator++()
+		{
+			++it;
+			return *this;
+		}
+
+		KeyIterator operator++(int)
+		{
+			KeyIterator tmp = *this;
+			++it;
+			return tmp;
+		}
+
+		bool operator==(const KeyIterator& rhs) const
+		{
+			return it == rhs.it;
+		}
+
+		bool operator!=(const KeyIterator& rhs) const
+		{
+			return it != rhs.it;
+		}
+	};
+
+	/**
+	 * Iterator adaptor going over edges of map-like adjacency container,
+	 * dereferencing gives pair of target id and reference to edge value (resolved by edge store)
+	 */
+	template<typename Iterator, typename Store>
+	class EdgeIterator
+	{
+	private:
+		Iterator it;
+		const Store* store;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::pair<size_t, const typename Store::value_type&>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = value_type;
+
+		EdgeIterator()
+			:it(), store(nullptr)
+		{}
+
+		EdgeIterator(Iterator it, const Store& store)
+			:it(it), store(&store)
+		{}
+
+		reference operator*() const
+		{
+			return { it->first, store->value(it->second) };
+		}
+
+		EdgeIterator& operator++()
+		{
+			++it;
+			return *this;
+		}
+
+		EdgeIterator operator++(int)
+		{
+			EdgeIterator tmp = *this;
+			++it;
+			return tmp;
+		}
+
+		bool operator==(const EdgeIterator& rhs) const
+		{
+			return it == rhs.it;
+		}
+
+		bool operator!=(const EdgeIterator& rhs) const
+		{
+			return it != rhs.it;
+		}
+	};
+
+	/**
+	 * Iterator adaptor going over ids of predecessors of vertex, dereferencing gives pair of
+	 * source id and reference to value of edge leading from it (found in adjacency of source)
+	 */
+	template<typename Iterator, typename VertexMap, typename Store>
+	class IncomingEdgeIterator
+	{
+	private:
+		Iterator it;
+		const VertexMap* vertices;
+		const Store* store;
+		size_t target;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::pair<size_t, const typename Store::value_type&>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = value_type;
+
+		IncomingEdgeIterator()
+			:it(), vertices(nullptr), store(nullptr), target(0)
+		{}
+
+		IncomingEdgeIterator(Iterator it, const VertexMap& vertices, const Store& store, size_t target)
+			:it(it), vertices(&vertices), store(&store), target(target)
+		{}
+
+		reference operator*() const
+		{
+			const auto& edges = vertices->find(*it)->second->outgoingEdges;
+			return { *it, store->value(edges.find(target)->second) };
+		}
+
+		IncomingEdgeIterator& operator++()
+		{
+			++it;
+			return *this;
+		}
+
+		IncomingEdgeIterator operator++(int)
+		{
+			IncomingEdgeIterator tmp = *this;
+			++it;
+			return tmp;
+		}
+
+		bool operator==(const IncomingEdgeIterator& rhs) const
+		{
+			return it == rhs.it;
+		}
+
+		bool operator!=(const IncomingEdgeIterator& rhs) const
+		{
+			return it != rhs.it;
+		}
+	};
+
+	namespace helper
+	{
+		/**
+		 * Estimates bytes allocated by node-based container (std::map, std::set)
+		 *
+		 * Every item is counted as tree node - colour and three links followed by aligned value,
+		 * which matches common standard library implementations. Allocator overhead is not included.
+		 * @param container container
+		 * @return estimated allocated bytes
+		 */
+		template<typename Container>
+		size_t allocatedBytes(const Container& container)
+		{
+			using value_type = typename Container::value_type;
+			const size_t align = alignof(value_type);
+			const size_t header = (4 * sizeof(void*) + align - 1) / align * align;
+			return container.size() * (header + sizeof(value_type));
+		}
+
+		template<typename T, typename Allocator>
+		size_t allocatedBytes(const std::vector<T, Allocator>& container)
+		{
+			return container.capacity() * sizeof(T);
+		}
+
+		template<typename T, template<typename> class Allocator>
+		size_t allocatedBytes(const SlotMap<T, Allocator>& container)
+		{
+			return container.allocatedBytes();
+		}
+
+		template<typename T, template<typename> class Allocator>
+		size_t allocatedBytes(const FlatMap<T, Allocator>& container)
+		{
+			return container.allocatedBytes();
+		}
+
+		/**
+		 * Get bytes of heap memory owned by value (not including size of value itself)
+		 * @param value value
+		 * @return owned bytes, 0 for types which do not own heap memory
+		 */
+		template<typename T>
+		size_t heapBytes(const T&)
+		{
+			return 0;
+		}
+
+		template<typename Char, typename Traits, typename Allocator>
+		size_t heapBytes(const std::basic_string<Char, Traits, Allocator>& value)
+		{
+			// Short strings are stored inside of the object itself (small string optimization)
+			auto data = reinterpret_cast<const char*>(value.data());
+			auto object = reinterpret_cast<const char*>(&value);
+			if(!std::less<const char*>()(data, object) && std::less<const char*>()(data, object + sizeof(value)))
+			{
+				return 0;
+			}
+			return (value.capacity() + 1) * sizeof(Char);
+		}
+
+		template<typename T, typename Allocator>
+		size_t heapBytes(const std::vector<T, Allocator>& value)
+		{
+			size_t result = value.capacity() * sizeof(T);
+			for(const auto& item : value)
+			{
+				result += heapBytes(item);
+			}
+			return result;
+		}
+
+		/**
+		 * Fixed-size array of slots whose values are constructed and destroyed one by one,
+		 * used slots are marked in bitset and values never move
+		 */
+		template<typename T>
+		class SlotChunk
+		{
+		public:
+			static constexpr size_t capacity = 256;
+
+		private:
+			std::bitset<capacity> used;
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type storage[capacity];
+
+		public:
+			SlotChunk()
+			{}
+
+			SlotChunk(const SlotChunk& other)
+			{
+				for(size_t i = 0; i < capacity; ++i)
+				{
+					if(other.used[i])
+					{
+						construct(i, other[i]);
+					}
+				}
+			}
+
+			SlotChunk& operator=(const SlotChunk&) = delete;
+
+			~SlotChunk()
+			{
+				for(size_t i = 0; i < capacity; ++i)
+				{
+					reset(i);
+				}
+			}
+
+			bool isUsed(size_t i) const
+			{
+				return used[i];
+			}
+
+			bool empty() const
+			{
+				return used.none();
+			}
+
+			T& operator[](size_t i)
+			{
+				return *reinterpret_cast<T*>(&storage[i]);
+			}
+
+			const T& operator[](size_t i) const
+			{
+				return *reinterpret_cast<const T*>(&storage[i]);
+			}
+
+			/**
+			 * Constructs value in unused slot
+			 * @param i index of slot
+			 * @param args arguments for constructor of value
+			 * @return reference to value
+			 */
+			template<typename... Args>
+			T& construct(size_t i, Args&&... args)
+			{
+				new(&storage[i]) T(std::forward<Args>(args)...);
+				used[i] = true;
+				return (*this)[i];
+			}
+
+			/**
+			 * Destroys value of slot (if slot is used)
+			 * @param i index of slot
+			 */
+			void reset(size_t i)
+			{
+				if(used[i])
+				{
+					(*this)[i].~T();
+					used[i] = false;
+				}
+			}
+
+			/**
+			 * Get bytes of heap memory owned by values of used slots
+			 * @return owned bytes
+			 */
+			size_t heapBytes() const
+			{
+				size_t result = 0;
+				for(size_t i = 0; i < capacity; ++i)
+				{
+					if(used[i])
+					{
+						result += helper::heapBytes((*this)[i]);
+					}
+				}
+				return result;
+			}
+		};
+
+		template<typename T>
+		constexpr size_t SlotChunk<T>::capacity;
+	}
+
+	/**
+	 * Holder owning its value directly, copies of holder are deep copies
+	 *
+	 * Holders separate reading (operator*, operator->) from writing (mutate), which lets
+	 * copy-on-write holder clone shared value right before it is modified.
+	 */
+	template<typename T>
+	class ValueHolder
+	{
+	private:
+		T value;
+
+	public:
+		static constexpr bool copy_on_write = false;
+
+		ValueHolder()
+			:value()
+		{}
+
+		explicit ValueHolder(T value)
+			:value(std::move(value))
+		{}
+
+		const T& operator*() const
+		{
+			return value;
+		}
+
+		const T* operator->() const
+		{
+			return &value;
+		}
+
+		/**
+		 * Get value for modification
+		 * @return reference to value
+		 */
+		T& mutate()
+		{
+			return value;
+		}
+	};
+
+	/**
+	 * Holder sharing its value with copies (copy is O(1)), value is cloned on first
+	 * modification through holder which is not its only owner
+	 *
+	 * Holders sharing value may be used from different threads as long as each of them
+	 * is used by one thread at a time. Ownership is decided by atomic count of owners - holder
+	 * released by other thread is synchronised with (acquire/release), so its reads of value
+	 * happen before value is modified by the last owner.
+	 */
+	template<typename T>
+	class CowHolder
+	{
+	private:
+		struct Node
+		{
+			std::atomic<size_t> owners;
+			T value;
+
+			template<typename... Args>
+			explicit Node(Args&&... args)
+				:owners(1), value(std::forward<Args>(args)...)
+			{}
+		};
+
+		Node* node;
+
+		void release()
+		{
+			if(node->owners.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				delete node;
+			}
+		}
+
+	public:
+		static constexpr bool copy_on_write = true;
+
+		CowHolder()
+			:node(new Node())
+		{}
+
+		// Moving shares value as well, so moved-from holder stays usable
+		CowHolder(const CowHolder& other)
+			:node(other.node)
+		{
+			node->owners.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		CowHolder& operator=(const CowHolder& other)
+		{
+			if(node != other.node)
+			{
+				other.node->owners.fetch_add(1, std::memory_order_relaxed);
+				release();
+				node = other.node;
+			}
+			return *this;
+		}
+
+		explicit CowHolder(T value)
+			:node(new Node(std::move(value)))
+		{}
+
+		~CowHolder()
+		{
+			release();
+		}
+
+		const T& operator*() const
+		{
+			return node->value;
+		}
+
+		const T* operator->() const
+		{
+			return &node->value;
+		}
+
+		/**
+		 * Get value for modification, shared value is cloned first
+		 * @return reference to value
+		 */
+		T& mutate()
+		{
+			if(node->owners.load(std::memory_order_acquire) != 1)
+			{
+				Node* clone = new Node(node->value);
+				release();
+				node = clone;
+			}
+			return node->value;
+		}
+
+		/**
+		 * Get bytes allocated for shared value together with its count of owners
+		 * @return allocated bytes
+		 */
+		static constexpr size_t nodeSize()
+		{
+			return sizeof(Node);
+		}
+	};
+
+	template<typename T>
+	constexpr bool ValueHolder<T>::copy_on_write;
+
+	template<typename T>
+	constexpr bool CowHolder<T>::copy_on_write;
+
+	namespace helper
+	{
+		/**
+		 * Get bytes of value held by copy-on-write holder together with its count of owners
+		 * (value shared by copies is counted in each of them)
+		 * @param value holder
+		 * @return owned bytes
+		 */
+		template<typename T>
+		size_t heapBytes(const CowHolder<T>&)
+		{
+			return CowHolder<T>::nodeSize();
+		}
+	}
+
+	/**
+	 * Map-like container whose keys index into table of fixed-size chunks of slots
+	 *
+	 * Chunks are held by copy-on-write holders, so copy of container copies only the table
+	 * (O(count of keys / 256)) and modification through non-const find or iterator clones only
+	 * the chunk it touches. Chunks which were never used share one empty chunk. Lookup is O(1),
+	 * iteration goes over used slots in ascending order of keys. Interface mirrors the part of
+	 * std::map<size_t, T> which is used by graph classes.
+	 */
+	template<typename T, template<typename> class Allocator = std::allocator>
+	class ChunkMap
+	{
+	public:
+		using key_type = size_t;
+		using mapped_type = T;
+		using value_type = std::pair<const size_t, T>;
+		using size_type = size_t;
+
+	private:
+		using chunk_type = helper::SlotChunk<value_type>;
+		using chunk_holder = CowHolder<chunk_type>;
+		using table_type = std::vector<chunk_holder, Allocator<chunk_holder>>;
+		static constexpr size_t chunkSize = chunk_type::capacity;
+
+		template<typename Table, typename Value>
+		class Iterator
+		{
+		private:
+			friend class ChunkMap;
+			Table* table;
+			size_t key;
+			size_t last;
+
+			void skipUnused()
+			{
+				while(key < last)
+				{
+					const chunk_type& chunk = *(*table)[key / chunkSize];
+					if(chunk.empty())
+					{
+						key = (key / chunkSize + 1) * chunkSize;
+					}
+					else if(!chunk.isUsed(key % chunkSize))
+					{
+						++key;
+					}
+					else
+					{
+						return;
+					}
+				}
+			}
+
+			// Value is reached through non-const table only for modification, so its chunk is cloned if shared
+			static typename ChunkMap::value_type& get(table_type& table, size_t key)
+			{
+				return table[key / chunkSize].mutate()[key % chunkSize];
+			}
+
+			static const typename ChunkMap::value_type& get(const table_type& table, size_t key)
+			{
+				return (*table[key / chunkSize])[key % chunkSize];
+			}
+
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = Value;
+			using difference_type = std::ptrdiff_t;
+			using pointer = Value*;
+			using reference = Value&;
+
+			Iterator()
+				:table(nullptr), key(0), last(0)
+			{}
+
+			Iterator(Table* table, size_t key, size_t last)
+				:table(table), key(key), last(last)
+			{
+				skipUnused();
+			}
+
+			// Conversion from iterator to const_iterator
+			template<typename OtherTable, typename OtherValue>
+			Iterator(const Iterator<OtherTable, OtherValue>& other)
+				:table(other.table), key(other.key), last(other.last)
+			{}
+
+			reference operator*() const
+			{
+				return get(*table, key);
+			}
+
+			pointer operator->() const
+			{
+				return &get(*table, key);
+			}
+
+			Iterator& operator++()
+			{
+				++key;
+				skipUnused();
+				return *this;
+			}
+
+			Iterator operator++(int)
+			{
+				Iterator tmp = *this;
+				++(*this);
+				return tmp;
+			}
+
+			bool operator==(const Iterator& rhs) const
+			{
+				return key == rhs.key;
+			}
+
+			bool operator!=(const Iterator& rhs) const
+			{
+				return key != rhs.key;
+			}
+
+			template<typename, typename>
+			friend class Iterator;
+		};
+
+		table_type chunks;
+		size_t usedCount = 0;
+
+	public:
+		using iterator = Iterator<table_type, value_type>;
+		using const_iterator = Iterator<const table_type, const value_type>;
+
+		iterator begin()
+		{
+			return iterator(&chunks, 0, capacity());
+		}
+
+		iterator end()
+		{
+			return iterator(&chunks, capacity(), capacity());
+		}
+
+		const_iterator begin() const
+		{
+			return const_iterator(&chunks, 0, capacity());
+		}
+
+		const_iterator end() const
+		{
+			return const_iterator(&chunks, capacity(), capacity());
+		}
+
+		size_t size() const
+		{
+			return usedCount;
+		}
+
+		bool empty() const
+		{
+			return usedCount == 0;
+		}
+
+		/**
+		 * Get count of slots (used or not), every key is less than this bound
+		 * @return count of slots
+		 */
+		size_t capacity() const
+		{
+			return chunks.size() * chunkSize;
+		}
+
+		void clear()
+		{
+			chunks.clear();
+			usedCount = 0;
+		}
+
+		iterator find(size_t key)
+		{
+			return count(key) ? iterator(&chunks, key, capacity()) : end();
+		}
+
+		const_iterator find(size_t key) const
+		{
+			return count(key) ? const_iterator(&chunks, key, capacity()) : end();
+		}
+
+		size_t count(size_t key) const
+		{
+			return (key < capacity() && chunks[key / chunkSize]->isUsed(key % chunkSize)) ? 1 : 0;
+		}
+
+		/**
+		 * Constructs value at given key, table grows by chunks sharing one empty chunk
+		 * @param key key of new value
+		 * @param args arguments for constructor of value
+		 * @return iterator to value with given key and true if it was inserted
+		 */
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(size_t key, Args&&... args)
+		{
+			if(count(key))
+			{
+				return { find(key), false };
+			}
+			if(key >= capacity())
+			{
+				chunks.resize(key / chunkSize + 1, chunk_holder());
+			}
+			chunks[key / chunkSize].mutate().construct(key % chunkSize, std::piecewise_construct, std::forward_as_tuple(key),
+			                                           std::forward_as_tuple(std::forward<Args>(args)...));
+			++usedCount;
+			return { find(key), true };
+		}
+
+		/**
+		 * Destroys value with given key, slot stays in its chunk
+		 * @param key key of value
+		 * @return number of erased values - at most 1
+		 */
+		size_t erase(size_t key)
+		{
+			if(!count(key))
+			{
+				return 0;
+			}
+			chunks[key / chunkSize].mutate().reset(key % chunkSize);
+			--usedCount;
+			return 1;
+		}
+
+		/**
+		 * Get bytes allocated by table and chunks (chunk shared by copies is counted in each of them)
+		 * @return allocated bytes
+		 */
+		size_t allocatedBytes() const
+		{
+			return chunks.capacity() * sizeof(chunk_holder) + chunks.size() * chunk_holder::nodeSize();
+		}
+
+		bool operator==(const ChunkMap& rhs) const
+		{
+			return usedCount == rhs.usedCount && std::equal(begin(), end(), rhs.begin());
+		}
+
+		bool operator!=(const ChunkMap& rhs) const
+		{
+			return !(*this == rhs);
+		}
+	};
+
+	template<typename T, template<typename> class Allocator>
+	constexpr size_t ChunkMap<T, Allocator>::chunkSize;
+
+	namespace helper
+	{
+		template<typename T, template<typename> class Allocator>
+		size_t allocatedBytes(const ChunkMap<T, Allocator>& container)
+		{
+			return container.allocatedBytes();
+		}
+	}
+
+	/**
+	 * Edge store keeping values directly in adjacency - every edge of undirected graph
+	 * holds its own copy of value in both endpoints
+	 */
+	template<typename E>
+	class InlineEdgeStore
+	{
+	public:
+		using value_type = E;
+		// Type kept in adjacency container for every edge
+		using entry_type = E;
+
+		static constexpr bool shared = false;
+
+		/**
+		 * Creates entry for new edge
+		 * @param value value of edge
+		 * @return entry to be put in adjacency
+		 */
+		entry_type create(E value)
+		{
+			return value;
+		}
+
+		/**
+		 * Creates entry for mirrored direction of undirected edge
+		 * @param entry entry of the other direction
+		 * @return entry to be put in adjacency
+		 */
+		entry_type mirror(const entry_type& entry) const
+		{
+			return entry;
+		}
+
+		/**
+		 * Releases edge which is removed from graph (mirrored entries are released once)
+		 * @param entry entry of edge
+		 */
+		void release(const entry_type&)
+		{}
+
+		E& value(entry_type& entry)
+		{
+			return entry;
+		}
+
+		const E& value(const entry_type& entry) const
+		{
+			return entry;
+		}
+
+		size_t allocatedBytes() const
+		{
+			return 0;
+		}
+
+		void clear()
+		{}
+	};
+
+	/**
+	 * Edge store keeping values in separate array of fixed-size chunks, adjacency holds only their indices
+	 *
+	 * Both directions of undirected edge refer to the same value, so it is stored and updated once.
+	 * Indices of released values are reused, released values are destroyed right away. Chunks are held
+	 * by copy-on-write holders, so copies of store share them and modification clones only the chunk
+	 * it touches (with CowStorage the table of chunks is cloned as well).
+	 * Each edge takes index in adjacency of both endpoints plus its value, so the store saves memory
+	 * only when sizeof(E) > 2 * sizeof(size_t) or when value owns heap memory (e.g. undirected edge with
+	 * size_t value takes 24 bytes instead of 16 taken by InlineEdgeStore), SharedEdgeStorage picks it only then.
+	 */
+	template<typename E, template<typename> class Allocator = std::allocator>
+	class SharedEdgeStore
+	{
+	private:
+		using chunk_type = helper::SlotChunk<E>;
+		using chunk_holder = CowHolder<chunk_type>;
+		static constexpr size_t chunkSize = chunk_type::capacity;
+
+		std::vector<chunk_holder, Allocator<chunk_holder>> chunks;
+		std::vector<size_t, Allocator<size_t>> freeSlots;
+		// Count of slots handed out (used or released)
+		size_t slotsCount = 0;
+
+	public:
+		using value_type = E;
+		using entry_type = size_t;
+
+		static constexpr bool shared = true;
+
+		entry_type create(E value)
+		{
+			size_t slot;
+			if(!freeSlots.empty())
+			{
+				slot = freeSlots.back();
+				freeSlots.pop_back();
+			}
+			else
+			{
+				slot = slotsCount++;
+				if(slot / chunkSize == chunks.size())
+				{
+					chunks.emplace_back();
+				}
+			}
+			chunks[slot / chunkSize].mutate().construct(slot % chunkSize, std::move(value));
+			return slot;
+		}
+
+		entry_type mirror(entry_type entry) const
+		{
+			return entry;
+		}
+
+		void release(entry_type entry)
+		{
+			// Value is destroyed so that memory owned by it is freed right away
+			chunks[entry / chunkSize].mutate().reset(entry % chunkSize);
+			freeSlots.push_back(entry);
+		}
+
+		E& value(entry_type entry)
+		{
+			return chunks[entry / chunkSize].mutate()[entry % chunkSize];
+		}
+
+		const E& value(entry_type entry) const
+		{
+			return (*chunks[entry / chunkSize])[entry % chunkSize];
+		}
+
+		size_t allocatedBytes() const
+		{
+			size_t result = helper::allocatedBytes(chunks) + chunks.size() * chunk_holder::nodeSize() + helper::allocatedBytes(freeSlots);
+			for(const auto& chunk : chunks)
+			{
+				result += chunk->heapBytes();
+			}
+			return result;
+		}
+
+		void clear()
+		{
+			chunks.clear();
+			freeSlots.clear();
+			slotsCount = 0;
+		}
+	};
+
+	template<typename E>
+	constexpr bool InlineEdgeStore<E>::shared;
+
+	template<typename E, template<typename> class Allocator>
+	constexpr bool SharedEdgeStore<E, Allocator>::shared;
+
+	template<typename E, template<typename> class Allocator>
+	constexpr size_t SharedEdgeStore<E, Allocator>::chunkSize;
+
+	/**
+	 * Non-owning view of iterator range, usable in range-based for loops
+	 */
+	template<typename Iterator>
+	class Range
+	{
+	public:
+		using iterator = Iterator;
+
+	private:
+		Iterator first;
+		Iterator last;
+		size_t count;
+
+	public:
+		Range()
+			:first(), last(), count(0)
+		{}
+
+		Range(Iterator first, Iterator last, size_t count)
+			:first(first), last(last), count(count)
+		{}
+
+		Iterator begin() const
+		{
+			return first;
+		}
+
+		Iterator end() const
+		{
+			return last;
+		}
+
+		size_t size() const
+		{
+			return count;
+		}
+
+		bool empty() const
+		{
+			return count == 0;
+		}
+	};
+
+	namespace helper
+	{
+		/**
+		 * Arena of fixed-size blocks owned by graph (and copies of graph)
+		 *
+		 * Blocks of each size are carved from chunks which grow geometrically, freed blocks go to
+		 * free-list of their size and are reused only by this arena. All chunks are returned to
+		 * the system at once when arena is destroyed, released arena does not keep freed blocks at all.
+		 */
+		class PoolArena
+		{
+		private:
+			struct FreeBlock
+			{
+				FreeBlock* next;
+			};
+
+			struct SizeClass
+			{
+				size_t blockSize;
+				FreeBlock* freeList;
+				char* current;
+				char* chunkEnd;
+				size_t chunkBlocks;
+			};
+
+			static constexpr size_t minChunkBlocks = 64;
+			static constexpr size_t maxChunkBlocks = 1 << 16;
+
+			std::mutex mutex;
+			// Graph allocates nodes of few sizes (vertices, adjacency), so classes are searched linearly
+			std::vector<SizeClass> classes;
+			std::vector<void*> chunks;
+			size_t chunksBytes = 0;
+			bool released = false;
+
+			SizeClass& sizeClass(size_t blockSize)
+			{
+				for(auto& c : classes)
+				{
+					if(c.blockSize == blockSize)
+					{
+						return c;
+					}
+				}
+				classes.push_back({ blockSize, nullptr, nullptr, nullptr, minChunkBlocks });
+				return classes.back();
+			}
+
+			static size_t blockSize(size_t size, size_t align)
+			{
+				size_t minSize = size < sizeof(FreeBlock) ? sizeof(FreeBlock) : size;
+				align = align < alignof(FreeBlock) ? alignof(FreeBlock) : align;
+				return (minSize + align - 1) / align * align;
+			}
+
+		public:
+			PoolArena()
+			{}
+
+			PoolArena(const PoolArena&) = delete;
+			PoolArena& operator=(const PoolArena&) = delete;
+
+			~PoolArena()
+			{
+				for(void* chunk : chunks)
+				{
+					::operator delete(chunk);
+				}
+			}
+
+			/**
+			 * Allocates block (alignment must not exceed alignment of std::max_align_t)
+			 * @param size size of block
+			 * @param align alignment of block
+			 * @return pointer to block
+			 */
+			void* allocate(size_t size, size_t align)
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				SizeClass& c = sizeClass(blockSize(size, align));
+				if(c.freeList)
+				{
+					FreeBlock* block = c.freeList;
+					c.freeList = block->next;
+					return block;
+				}
+
+				if(c.current == c.chunkEnd)
+				{
+					chunks.reserve(chunks.size() + 1);
+					c.current = static_cast<char*>(::operator new(c.chunkBlocks * c.blockSize));
+					c.chunkEnd = c.current + c.chunkBlocks * c.blockSize;
+					chunks.push_back(c.current);
+					chunksBytes += c.chunkBlocks * c.blockSize;
+					if(c.chunkBlocks < maxChunkBlocks)
+					{
+						c.chunkBlocks *= 2;
+					}
+				}
+
+				void* block = c.current;
+				c.current += c.blockSize;
+				return block;
+			}
+
+			void deallocate(void* p, size_t size, size_t align)
+			{
+				// Owner of released arena is being destroyed, its chunks are freed at once
+				if(released)
+				{
+					return;
+				}
+
+				std::lock_guard<std::mutex> lock(mutex);
+				SizeClass& c = sizeClass(blockSize(size, align));
+				FreeBlock* block = static_cast<FreeBlock*>(p);
+				block->next = c.freeList;
+				c.freeList = block;
+			}
+
+			/**
+			 * Marks arena as released by its last owner, its blocks are no longer put to free-lists
+			 */
+			void release()
+			{
+				released = true;
+			}
+
+			/**
+			 * Get bytes of chunks allocated by arena
+			 * @return allocated bytes
+			 */
+			size_t allocatedBytes()
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				return chunksBytes;
+			}
+		};
+	}
+
+	/**
+	 * Allocator serving single objects (e.g. nodes of std::map) from arena of graph
+	 *
+	 * Graph built from many small nodes then takes memory from few large chunks, threads building
+	 * different graphs at the same time do not contend in global allocator and memory of graph is
+	 * returned to the system when graph is destroyed. Allocator without arena and requests for more
+	 * than one object (e.g. storage of std::vector) are passed to std::allocator.
+	 */
+	template<typename T>
+	class PoolAllocator
+	{
+	private:
+		template<typename U>
+		friend class PoolAllocator;
+
+		static constexpr bool pooled = alignof(T) <= alignof(std::max_align_t);
+
+		helper::PoolArena* arena;
+
+	public:
+		using value_type = T;
+		// Container takes arena of the container it is assigned from, so graph keeps both of them alive
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+
+		PoolAllocator() noexcept
+			:arena(nullptr)
+		{}
+
+		explicit PoolAllocator(helper::PoolArena* arena) noexcept
+			:arena(arena)
+		{}
+
+		template<typename U>
+		PoolAllocator(const PoolAllocator<U>& other) noexcept
+			:arena(other.arena)
+		{}
+
+		T* allocate(size_t n)
+		{
+			if(n == 1 && pooled && arena)
+			{
+				return static_cast<T*>(arena->allocate(sizeof(T), alignof(T)));
+			}
+			return std::allocator<T>().allocate(n);
+		}
+
+		void deallocate(T* p, size_t n)
+		{
+			if(n == 1 && pooled && arena)
+			{
+				arena->deallocate(p, sizeof(T), alignof(T));
+				return;
+			}
+			std::allocator<T>().deallocate(p, n);
+		}
+
+		template<typename U>
+		bool operator==(const PoolAllocator<U>& other) const noexcept
+		{
+			return arena == other.arena;
+		}
+
+		template<typename U>
+		bool operator!=(const PoolAllocator<U>& other) const noexcept
+		{
+			return arena != other.arena;
+		}
+	};
+
+	namespace helper
+	{
+		/**
+		 * Arena of graph whose allocator keeps no state
+		 */
+		struct NoArena
+		{
+			template<typename Allocator>
+			Allocator allocator() const
+			{
+				return Allocator();
+			}
+
+			void release()
+			{}
+
+			size_t allocatedBytes() const
+			{
+				return 0;
+			}
+		};
+
+		/**
+		 * Arena of graph using PoolAllocator, copies and moved-from graphs share it (so that nodes
+		 * shared or left behind stay valid), it is freed with the last graph which refers to it
+		 */
+		class SharedPoolArena
+		{
+		private:
+			std::shared_ptr<PoolArena> arena;
+
+		public:
+			SharedPoolArena()
+				:arena(std::make_shared<PoolArena>())
+			{}
+
+			// Moved-from graph keeps containers referring to arena, so arena is shared instead of moved
+			SharedPoolArena(const SharedPoolArena&) = default;
+			SharedPoolArena& operator=(const SharedPoolArena&) = default;
+
+			template<typename Allocator>
+			Allocator allocator() const
+			{
+				return Allocator(arena.get());
+			}
+
+			/**
+			 * Called by destructor of graph, arena of the last owner skips freeing of single nodes
+			 */
+			void release()
+			{
+				if(arena.use_count() == 1)
+				{
+					arena->release();
+				}
+			}
+
+			size_t allocatedBytes() const
+			{
+				return arena->allocatedBytes();
+			}
+		};
+
+		/**
+		 * Constructs container with given allocator (containers which do not take allocator are default constructed)
+		 * @param allocator allocator of graph
+		 * @return container
+		 */
+		template<typename Container, typename Allocator>
+		typename std::enable_if<std::is_constructible<Container, const Allocator&>::value, Container>::type makeContainer(const Allocator& allocator)
+		{
+			return Container(allocator);
+		}
+
+		template<typename Container, typename Allocator>
+		typename std::enable_if<!std::is_constructible<Container, const Allocator&>::value, Container>::type makeContainer(const Allocator&)
+		{
+			return Container();
+		}
+	}
+
+	/**
+	 * Storage policies
+	 *
+	 * Policy decides which containers graph uses internally, it is passed as last
+	 * template parameter of Graph. Custom policy can be created by deriving from
+	 * DefaultStorage and redefining chosen member templates.
+	 */
+
+	/**
+	 * Default storage - vertices in std::map, ids of removed vertices are never reused,
+	 * memory comes from std::allocator
+	 */
+	struct DefaultStorage
+	{
+		/**
+		 * Allocator used for all nodes of graph (vertices and adjacency)
+		 */
+		template<typename T>
+		using allocator = std::allocator<T>;
+
+		/**
+		 * Arena owned by each graph, it gives allocator to vertex and adjacency containers
+		 */
+		using arena = helper::NoArena;
+
+		template<typename T, template<typename> class Allocator>
+		using vertex_container = std::map<size_t, T, std::less<size_t>, Allocator<std::pair<const size_t, T>>>;
+
+		/**
+		 * Container of outgoing edges of vertex (key = id of end vertex, value = edge value)
+		 */
+		template<typename T, template<typename> class Allocator>
+		using edge_container = std::map<size_t, T, std::less<size_t>, Allocator<std::pair<const size_t, T>>>;
+
+		/**
+		 * Store of edge values (adjacency keeps its entries)
+		 */
+		template<typename T, template<typename> class Allocator>
+		using edge_store = InlineEdgeStore<T>;
+
+		/**
+		 * Holder of vertex container, of each vertex and of edge store
+		 */
+		template<typename T>
+		using holder = ValueHolder<T>;
+	};
+
+	/**
+	 * Vertices stored in chunked slot array (SlotMap) - O(1) access by id,
+	 * ids of removed vertices are reused by later addVertex calls
+	 */
+	struct SlotStorage : DefaultStorage
+	{
+		template<typename T, template<typename> class Allocator>
+		using vertex_container = SlotMap<T, Allocator>;
+	};
+
+	/**
+	 * Outgoing edges stored in sorted contiguous vector (FlatMap) - binary search lookups,
+	 * sequential iteration and smaller memory footprint, slower modifications of large adjacency
+	 */
+	struct FlatStorage : DefaultStorage
+	{
+		template<typename T, template<typename> class Allocator>
+		using edge_container = FlatMap<T, Allocator>;
+	};
+
+	namespace helper
+	{
+		/**
+		 * Shared store saves memory when undirected edge keeps one value and two indices instead of
+		 * two values - value has to be larger than two indices or own heap memory
+		 */
+		template<typename E>
+		using sharesEdgeValues = std::integral_constant<bool, (sizeof(E) > 2 * sizeof(size_t)) || !std::is_trivially_copyable<E>::value>;
+	}
+
+	/**
+	 * Edge values kept once in shared array (SharedEdgeStore) - undirected edges store
+	 * and update their value once instead of in both endpoints, adjacency keeps index
+	 * of value instead. Small trivially copyable values (e.g. numbers) stay in adjacency
+	 * (InlineEdgeStore) as indices would take more memory than the values themselves.
+	 */
+	struct SharedEdgeStorage : DefaultStorage
+	{
+		template<typename T, template<typename> class Allocator>
+		using edge_store = typename std::conditional<helper::sharesEdgeValues<T>::value, SharedEdgeStore<T, Allocator>, InlineEdgeStore<T>>::type;
+	};
+
+	/**
+	 * Copies of graph share vertex container, vertices and edge store (CowHolder), copy is O(1)
+	 *
+	 * Vertices are kept in chunks of 256 slots (ChunkMap), ids of removed vertices are never reused.
+	 * First modification of copy clones table of chunks (O(V / 256) holders), each modification then
+	 * clones the chunk of modified vertex (256 holders) and the vertex together with its adjacency.
+	 * Holders of other vertices in cloned chunk share their vertices, so those stay at the same address.
+	 * Shared edge store clones its table of chunks and the chunk of modified value the same way.
+	 */
+	struct CowStorage : DefaultStorage
+	{
+		template<typename T, template<typename> class Allocator>
+		using vertex_container = ChunkMap<T, Allocator>;
+
+		template<typename T>
+		using holder = CowHolder<T>;
+	};
+
+	/**
+	 * Nodes of vertices and adjacency are allocated from arena of graph (PoolAllocator),
+	 * which is shared by copies of graph and freed at once with the last of them
+	 */
+	struct PoolStorage : DefaultStorage
+	{
+		template<typename T>
+		using allocator = PoolAllocator<T>;
+
+		using arena = helper::SharedPoolArena;
+	};
+
+	namespace helper
+	{
+		/**
+		 * Returns id for new vertex (ids are handed out from counter)
+		 * @param counter counter of ids which were never used
+		 * @return new id
+		 */
+		template<typename Container>
+		size_t acquireVertexId(Container&, size_t& counter)
+		{
+			return counter++;
+		}
+
+		/**
+		 * Returns id for new vertex (ids of removed vertices are reused first)
+		 * @param counter counter of ids which were never used
+		 * @return new id
+		 */
+		template<typename T, template<typename> class Allocator>
+		size_t acquireVertexId(SlotMap<T, Allocator>& container, size_t& counter)
+		{
+			return container.acquireKey(counter);
+		}
+
+		/**
+		 * Merges sorted run of staged edges into adjacency, targets which are already present
+		 * (or repeated in run) are skipped
+		 * @param edges adjacency container
+		 * @param first iterator to first staged edge {from, to, value}
+		 * @param last iterator behind last staged edge
+		 * @param onInserted function called with target of every inserted edge
+		 * @param onSkipped function called with target and value of every skipped edge
+		 */
+		template<typename Container, typename Iterator, typename Func, typename FuncSkipped>
+		void mergeSortedEdges(Container& edges, Iterator first, Iterator last, Func onInserted, FuncSkipped onSkipped)
+		{
+			if(first == last)
+			{
+				return;
+			}
+
+			// Targets come sorted, so hint stays at lower bound of the next target unless
+			// some existing edges lie in between (then it is searched again)
+			auto hint = edges.lower_bound(std::get<1>(*first));
+			for(auto it = first; it != last; ++it)
+			{
+				size_t to = std::get<1>(*it);
+				if(hint != edges.end() && hint->first < to)
+				{
+					hint = edges.lower_bound(to);
+				}
+				if((it != first && std::get<1>(*std::prev(it)) == to) || (hint != edges.end() && hint->first == to))
+				{
+					onSkipped(to, std::get<2>(*it));
+					continue;
+				}
+
+				hint = edges.emplace_hint(hint, to, std::move(std::get<2>(*it)));
+				++hint;
+				onInserted(to);
+			}
+		}
+
+		/**
+		 * Merges sorted run of staged edges into flat adjacency in O(n + k)
+		 * @param edges adjacency container
+		 * @param first iterator to first staged edge {from, to, value}
+		 * @param last iterator behind last staged edge
+		 * @param onInserted function called with target of every inserted edge
+		 * @param onSkipped function called with target and value of every skipped edge
+		 */
+		template<typename T, template<typename> class Allocator, typename Iterator, typename Func, typename FuncSkipped>
+		void mergeSortedEdges(FlatMap<T, Allocator>& edges, Iterator first, Iterator last, Func onInserted, FuncSkipped onSkipped)
+		{
+			std::vector<std::pair<size_t, T>> run;
+			run.reserve(std::distance(first, last));
+			for(auto it = first; it != last; ++it)
+			{
+				run.emplace_back(std::get<1>(*it), std::move(std::get<2>(*it)));
+			}
+			edges.mergeSorted(run.begin(), run.end(), onInserted, onSkipped);
+		}
+	}
+}
@@ -0,0 +1,94 @@
+#include <cmath>
+#include <map>
+#include "Test.h"
+
+struct City
+{
+	double x, y;
+};
+
+std::ostream& operator<<(std::ostream& os, const City& city)
+{
+	return os << city.x << "," << city.y;
+}
+
+/**
+ * A* with euclidean, zero and admissible but inconsistent heuristic finds shortest paths of dijkstraAll
+ */
+void testSearch(bool directed, unsigned seed)
+{
+	std::mt19937 rng(seed);
+	Graph::Graph<City, size_t> graph(directed);
+	const size_t n = 300;
+	for(size_t i = 0; i < n; ++i)
+	{
+		graph.addVertex(City{ double(rng() % 1000), double(rng() % 1000) });
+	}
+	auto distance = [&](size_t a, size_t b)
+	{
+		const City& p = graph.getVertexValue(a);
+		const City& q = graph.getVertexValue(b);
+		return std::hypot(p.x - q.x, p.y - q.y);
+	};
+	for(size_t i = 0; i < 1200; ++i)
+	{
+		size_t a = rng() % n, b = rng() % n;
+		if(a != b)
+		{
+			graph.addEdge(a, b, size_t(std::ceil(distance(a, b))) + rng() % 50);
+		}
+	}
+	graph.addVertex(City{ 0, 0 });
+	auto frozen = Graph::freeze(graph);
+
+	for(int query = 0; query < 40; ++query)
+	{
+		size_t source = rng() % n;
+		size_t target = query == 0 ? source : rng() % (n + 1);
+		size_t expected = Graph::dijkstraAll(graph, source).first.at(target);
+		const City goal = graph.getVertexValue(target);
+		auto euclidean = [&](size_t, const City& city) { return size_t(std::hypot(city.x - goal.x, city.y - goal.y)); };
+		auto zero = [](size_t, const City&) { return size_t(0); };
+		Test::checkPath(graph, source, target, Graph::aStar(graph, source, target, euclidean), expected);
+		Test::checkPath(graph, source, target, Graph::aStar(graph, source, target, zero), expected);
+		Test::checkPath(graph, source, target, Graph::aStar(frozen, source, target, euclidean), expected);
+		Test::checkPath(graph, source, target, Graph::aStar(frozen, source, target, euclidean, Test::infinity, Graph::IndexedHeapQueue<4>()), expected);
+		if(!directed)
+		{
+			// Random fraction of exact distance is admissible, but not consistent
+			std::mt19937 fractions(query);
+			std::map<size_t, size_t> bounds;
+			for(const auto& exact : Graph::dijkstraAll(graph, target).first)
+			{
+				bounds[exact.first] = exact.second == Test::infinity ? 0 : (fractions() % 2 ? exact.second : exact.second / 3);
+			}
+			auto inconsistent = [&](size_t id, const City&) { return bounds.at(id); };
+			Test::checkPath(graph, source, target, Graph::aStar(graph, source, target, inconsistent), expected);
+			Test::checkPath(graph, source, target, Graph::aStar(frozen, source, target, inconsistent), expected);
+			Test::checkPath(graph, source, target, Graph::aStar(frozen, source, target, inconsistent, Test::infinity, Graph::IndexedHeapQueue<2>()), expected);
+		}
+	}
+
+	bool thrown = false;
+	try
+	{
+		Graph::aStar(frozen, 0, 1000, [](size_t, const City&) { return size_t(0); });
+	}
+	catch(const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	CHECK(thrown);
+}
+
+int main()
+{
+	for(unsigned seed = 1; seed < 6; ++seed)
+	{
+		testSearch(false, seed);
+		testSearch(true, seed);
+	}
+
+	std::cout << "AStar OK" << std::endl;
+	return 0;
+}
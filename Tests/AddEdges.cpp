@@ -0,0 +1,103 @@
+#include <tuple>
+#include "Test.h"
+
+struct SlotFlatStorage : Graph::SlotStorage
+{
+	template<typename T, template<typename> class Allocator>
+	using edge_container = Graph::FlatMap<T, Allocator>;
+};
+
+struct SharedFlatStorage : Graph::FlatStorage
+{
+	template<typename T, template<typename> class Allocator>
+	using edge_store = Graph::SharedEdgeStore<T, Allocator>;
+};
+
+/**
+ * Batch gives the same graph as edges added one by one, existing, repeated and invalid edges are skipped
+ */
+template<typename S>
+void testBatch(bool directed, unsigned seed)
+{
+	Graph::Graph<std::string, size_t, S> graph(directed), reference(directed);
+	graph.setIncomingIndex(true);
+	for(int i = 0; i < 50; ++i)
+	{
+		graph.addVertex("a");
+		reference.addVertex("a");
+	}
+	graph.addEdge(1, 2, 7);
+	reference.addEdge(1, 2, 7);
+
+	std::mt19937 rng(seed);
+	std::vector<std::tuple<size_t, size_t, size_t>> batch;
+	for(int i = 0; i < 400; ++i)
+	{
+		batch.emplace_back(rng() % 55, rng() % 55, rng() % 100);
+	}
+	batch.emplace_back(1, 2, 99);
+	batch.emplace_back(2, 1, 98);
+
+	size_t inserted = 0;
+	for(auto& e : batch)
+	{
+		bool existed = reference.adjacent(std::get<0>(e), std::get<1>(e));
+		reference.addEdge(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+		inserted += !existed && reference.adjacent(std::get<0>(e), std::get<1>(e));
+	}
+	CHECK(graph.addEdges(batch) == inserted);
+	CHECK(graph == reference);
+	for(auto id : reference.getVerticesIds())
+	{
+		CHECK(graph.getPredecessors(id) == reference.getPredecessors(id));
+	}
+
+	Graph::Graph<std::string, size_t, S> rebuilt(directed);
+	for(int i = 0; i < 50; ++i)
+	{
+		rebuilt.addVertex("a");
+	}
+	rebuilt.addEdges(graph.getEdgesPositionsAndValues(true));
+	CHECK(rebuilt == graph);
+}
+
+template<typename S>
+void testUnweighted()
+{
+	Graph::Graph<int, Graph::Unweight, S> graph, reference;
+	for(int i = 0; i < 5; ++i)
+	{
+		graph.addVertex(i);
+		reference.addVertex(i);
+	}
+	std::vector<std::pair<size_t, size_t>> batch{ { 0, 1 }, { 1, 2 }, { 0, 1 }, { 4, 3 }, { 9, 1 } };
+	CHECK(graph.addEdges(batch) == 3);
+	for(auto& e : batch)
+	{
+		reference.addEdge(e.first, e.second);
+	}
+	CHECK(graph == reference);
+}
+
+template<typename S>
+void testStorage()
+{
+	for(unsigned seed = 1; seed < 10; ++seed)
+	{
+		testBatch<S>(false, seed);
+		testBatch<S>(true, seed);
+	}
+	testUnweighted<S>();
+}
+
+int main()
+{
+	testStorage<Graph::DefaultStorage>();
+	testStorage<Graph::SlotStorage>();
+	testStorage<Graph::FlatStorage>();
+	testStorage<SlotFlatStorage>();
+	testStorage<Graph::SharedEdgeStorage>();
+	testStorage<SharedFlatStorage>();
+	std::cout << "AddEdges OK" << std::endl;
+	return 0;
+}
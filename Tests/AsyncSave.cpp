@@ -0,0 +1,63 @@
+#include <cstdio>
+#include <fstream>
+#include "Test.h"
+
+/**
+ * Snapshot is taken at the time of call while graph keeps changing, temporary file does not remain
+ */
+template<typename S>
+void testSnapshot()
+{
+	const std::string path = "AsyncSave_test.txt";
+	Graph::Graph<std::string, size_t, S> graph(false);
+	Test::randomFill(graph, 2000, 8000, 4);
+	Graph::Graph<std::string, size_t, S> expected(graph);
+
+	auto saved = graph.saveToFileAsync(path);
+	for(size_t i = 0; i < 2000; ++i)
+	{
+		graph.addEdge(i, (i * 31) % 2000, 1);
+		graph.updateEdgeValue(i, i + 1, 77);
+		if(i % 100 == 0)
+		{
+			graph.removeVertex(i);
+		}
+		graph.addVertex("new");
+	}
+	CHECK(saved.get());
+
+	Graph::Graph<std::string, size_t> loaded(false);
+	CHECK(loaded.loadFromFile(path));
+	CHECK(loaded.getEdgesPositionsAndValues() == expected.getEdgesPositionsAndValues());
+	CHECK(loaded.getVerticesCount() == expected.getVerticesCount());
+	CHECK(!std::ifstream(path + ".tmp").is_open());
+
+	// Existing file is replaced
+	CHECK(graph.saveToFileAsync(path).get());
+	CHECK(loaded.loadFromFile(path));
+	CHECK(loaded.getVerticesCount() == graph.getVerticesCount());
+	CHECK(!graph.saveToFileAsync("AsyncSave_missing_directory/graph.txt").get());
+	std::remove(path.c_str());
+}
+
+int main()
+{
+	testSnapshot<Graph::DefaultStorage>();
+	testSnapshot<Graph::CowStorage>();
+	testSnapshot<Graph::SlotStorage>();
+
+	const std::string path = "AsyncSave_unweighted.txt";
+	Graph::Graph<int> graph(true);
+	graph.addVertex(1);
+	graph.addVertex(2);
+	graph.addEdge(0, 1);
+	auto saved = graph.saveToFileAsync(path);
+	graph.removeEdge(0, 1);
+	CHECK(saved.get());
+	Graph::Graph<int> loaded(true);
+	CHECK(loaded.loadFromFile(path) && loaded.adjacent(0, 1));
+	std::remove(path.c_str());
+
+	std::cout << "AsyncSave OK" << std::endl;
+	return 0;
+}
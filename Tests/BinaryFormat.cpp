@@ -0,0 +1,155 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include "Test.h"
+#include "../Graph_io.h"
+
+template<typename V, typename E>
+bool loadThrows(const std::string& path)
+{
+	try
+	{
+		Graph::loadBinary<V, E>(path);
+	}
+	catch(const std::invalid_argument&)
+	{
+		return true;
+	}
+	return false;
+}
+
+const std::string path = "BinaryFormat_test.bin";
+const std::string otherPath = "BinaryFormat_test2.bin";
+
+/**
+ * Mapped graph equals frozen graph it was saved from, saving it again gives the same graph
+ */
+void testRoundTrip(bool directed, unsigned seed)
+{
+	Graph::Graph<std::string, size_t> graph(directed);
+	Test::randomFill(graph, 40, 80, seed);
+	graph.removeVertex(5);
+	CHECK(Graph::saveBinary(graph, path));
+
+	auto frozen = Graph::freeze(graph);
+	auto mapped = Graph::loadBinary<std::string, size_t>(path);
+	CHECK(Test::sameFrozen(frozen, mapped));
+	// Arrays of trivially copyable types are views of mapped file, strings are parsed
+	CHECK(mapped.getTargets().isView() && mapped.getWeights().isView() && !mapped.getValues().isView());
+	auto copy = mapped;
+	CHECK(Test::sameFrozen(copy, frozen));
+	CHECK(Graph::dijkstraAll(frozen, 0).first == Graph::dijkstraAll(mapped, 0).first);
+	CHECK(Graph::edmondsKarpMaxFlow(mapped, 0, 20).first == Graph::edmondsKarpMaxFlow(frozen, 0, 20).first);
+
+	CHECK(Graph::saveBinary(mapped, otherPath));
+	CHECK(Test::sameFrozen(Graph::loadBinary<std::string, size_t>(otherPath), frozen));
+}
+
+/**
+ * Loading fails for other types, missing, foreign and truncated files
+ */
+void testInvalid()
+{
+	Graph::Graph<double, Graph::Unweight> graph(false);
+	for(int i = 0; i < 10; ++i)
+	{
+		graph.addVertex(i * 0.5);
+	}
+	for(int i = 0; i + 1 < 10; ++i)
+	{
+		graph.addEdge(i, i + 1);
+	}
+	graph.addEdge(3, 3);
+	CHECK(Graph::saveBinary(graph, path));
+	auto mapped = Graph::loadBinary<double, Graph::Unweight>(path);
+	CHECK(Test::sameFrozen(Graph::freeze(graph), mapped));
+	CHECK(mapped.getValues().isView());
+
+	CHECK((loadThrows<int, Graph::Unweight>(path)));
+	CHECK((loadThrows<double, Graph::Unweight>("BinaryFormat_missing.bin")));
+
+	std::string content;
+	{
+		std::ifstream input(path, std::ios::binary);
+		content.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+	}
+	{
+		std::ofstream output(otherPath, std::ios::binary);
+		output << "not a graph file, only some text which is long enough to hold the header";
+	}
+	CHECK((loadThrows<double, Graph::Unweight>(otherPath)));
+	{
+		std::ofstream output(otherPath, std::ios::binary);
+		output.write(content.data(), content.size() - 8);
+	}
+	CHECK((loadThrows<double, Graph::Unweight>(otherPath)));
+
+	Graph::Graph<int, int> empty(true);
+	CHECK(Graph::saveBinary(empty, path));
+	auto mappedEmpty = Graph::loadBinary<int, int>(path);
+	CHECK(mappedEmpty.getVerticesCount() == 0 && mappedEmpty.getEdgesCount() == 0);
+}
+
+/**
+ * Overwrites one 64-bit word of saved file and checks that loading rejects it
+ */
+bool corruptedThrows(const std::string& content, uint64_t offset, uint64_t word)
+{
+	std::string corrupted = content;
+	std::memcpy(&corrupted[size_t(offset)], &word, sizeof(word));
+	{
+		std::ofstream output(otherPath, std::ios::binary);
+		output.write(corrupted.data(), corrupted.size());
+	}
+	return loadThrows<int, int>(otherPath);
+}
+
+/**
+ * Loading rejects ids out of order, broken offsets and targets out of range
+ */
+void testCorrupted()
+{
+	Graph::Graph<int, int> graph(true);
+	for(int i = 0; i < 6; ++i)
+	{
+		graph.addVertex(i);
+	}
+	for(size_t i = 0; i < 6; ++i)
+	{
+		graph.addEdge(i, (i + 1) % 6, 1);
+		graph.addEdge(i, (i + 3) % 6, 2);
+	}
+	CHECK(Graph::saveBinary(graph, path));
+	std::string content;
+	{
+		std::ifstream input(path, std::ios::binary);
+		content.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+	}
+	Graph::helper::BinaryHeader header;
+	std::memcpy(&header, content.data(), sizeof(header));
+
+	CHECK(corruptedThrows(content, header.targetsOffset + 8, 123456789012));
+	CHECK(corruptedThrows(content, header.targetsOffset, 6));
+	CHECK(corruptedThrows(content, header.idsOffset + 8, 0));
+	CHECK(corruptedThrows(content, header.offsetsOffset, 1));
+	CHECK(corruptedThrows(content, header.offsetsOffset + 16, 1));
+	CHECK(corruptedThrows(content, header.offsetsOffset + 6 * 8, 11));
+	CHECK(!corruptedThrows(content, header.targetsOffset, 5));
+	CHECK(Test::sameFrozen(Graph::loadBinary<int, int>(path, true), Graph::freeze(graph)));
+}
+
+int main()
+{
+	for(unsigned seed = 1; seed < 6; ++seed)
+	{
+		testRoundTrip(false, seed);
+		testRoundTrip(true, seed);
+	}
+	testInvalid();
+	testCorrupted();
+	std::remove(path.c_str());
+	std::remove(otherPath.c_str());
+	std::cout << "BinaryFormat OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,173 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include "Test.h"
+#include "../Graph_ch.h"
+
+/**
+ * Queries on built and reloaded hierarchy equal dijkstraAll, unpacked paths use original edges
+ */
+void testQueries(bool directed, unsigned seed)
+{
+	Graph::Graph<std::string, size_t> graph(directed);
+	Test::randomFill(graph, 150, seed % 2 ? 150 : 400, seed, seed < 4 ? 3 : 20);
+	for(size_t i = 0; i < 3; ++i)
+	{
+		graph.addVertex("isolated");
+	}
+	graph.removeVertex(3);
+	Graph::ContractionHierarchy<size_t> hierarchy(graph, seed == 5 ? 3 : 500);
+
+	const std::string file = "ContractionHierarchy_test.bin";
+	CHECK(Graph::saveContractionHierarchy(hierarchy, file));
+	auto loaded = Graph::loadContractionHierarchy<size_t>(file);
+	CHECK(loaded.getArcsCount() == hierarchy.getArcsCount());
+	std::remove(file.c_str());
+
+	Graph::ContractionHierarchyQuery<size_t> query(hierarchy);
+	Graph::ContractionHierarchyQuery<size_t, Graph::LazyHeapQueue> lazyQuery(loaded);
+	auto ids = graph.getVerticesIds();
+	std::mt19937 rng(seed);
+	for(int k = 0; k < 30; ++k)
+	{
+		size_t source = ids[rng() % ids.size()];
+		auto reference = Graph::dijkstraAll(graph, source).first;
+		for(int j = 0; j < 10; ++j)
+		{
+			size_t target = j == 0 ? source : ids[rng() % ids.size()];
+			Test::checkPath(graph, source, target, query.query(source, target), reference.at(target));
+			Test::checkPath(graph, source, target, lazyQuery.query(source, target), reference.at(target));
+			Test::checkPath(graph, source, target, Graph::dijkstra(loaded, source, target), reference.at(target));
+			CHECK(query.distance(source, target) == reference.at(target));
+		}
+	}
+
+	bool thrown = false;
+	try
+	{
+		query.query(3, 0);
+	}
+	catch(const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	CHECK(thrown);
+}
+
+/**
+ * Hierarchy of frozen grid with asymmetric weights gives distances of dijkstraDense
+ */
+void testGrid()
+{
+	Graph::Graph<int, unsigned> graph(true);
+	const size_t width = 40;
+	std::mt19937 rng(3);
+	for(size_t i = 0; i < width * width; ++i)
+	{
+		graph.addVertex(0);
+	}
+	for(size_t i = 0; i < width * width; ++i)
+	{
+		if(i % width + 1 < width)
+		{
+			graph.addEdge(i, i + 1, 1 + rng() % 9);
+			graph.addEdge(i + 1, i, 1 + rng() % 9);
+		}
+		if(i + width < width * width)
+		{
+			graph.addEdge(i, i + width, 1 + rng() % 9);
+			graph.addEdge(i + width, i, 1 + rng() % 9);
+		}
+	}
+	auto frozen = Graph::freeze(graph);
+	Graph::ContractionHierarchy<unsigned> hierarchy(frozen);
+	Graph::ContractionHierarchyQuery<unsigned> query(hierarchy);
+	for(int k = 0; k < 20; ++k)
+	{
+		size_t source = rng() % (width * width);
+		auto reference = Graph::dijkstraDense(frozen, source);
+		for(int j = 0; j < 20; ++j)
+		{
+			size_t target = rng() % (width * width);
+			auto result = query.query(source, target);
+			CHECK(result.first == reference.distance[target]);
+			CHECK(result.second.front() == source && result.second.back() == target);
+			unsigned length = 0;
+			for(size_t i = 0; i + 1 < result.second.size(); ++i)
+			{
+				length += graph.getEdgeValue(result.second[i], result.second[i + 1]);
+			}
+			CHECK(length == result.first);
+		}
+	}
+}
+
+/**
+ * Overwrites one 64-bit word of saved hierarchy and checks that loading rejects it
+ */
+bool corruptedThrows(const std::string& content, const std::string& file, uint64_t offset, uint64_t word)
+{
+	std::string corrupted = content;
+	std::memcpy(&corrupted[size_t(offset)], &word, sizeof(word));
+	{
+		std::ofstream output(file, std::ios::binary);
+		output.write(corrupted.data(), corrupted.size());
+	}
+	try
+	{
+		Graph::loadContractionHierarchy<size_t>(file);
+	}
+	catch(const std::invalid_argument&)
+	{
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Loading rejects arc ends out of range, broken offsets and shortcuts which cannot be unpacked
+ */
+void testCorrupted()
+{
+	Graph::Graph<std::string, size_t> graph(true);
+	Test::randomFill(graph, 60, 200, 4);
+	Graph::ContractionHierarchy<size_t> hierarchy(graph);
+	const std::string file = "ContractionHierarchy_test.bin";
+	CHECK(Graph::saveContractionHierarchy(hierarchy, file));
+	std::string content;
+	{
+		std::ifstream input(file, std::ios::binary);
+		content.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+	}
+	Graph::helper::ContractionHeader header;
+	std::memcpy(&header, content.data(), sizeof(header));
+	const auto& middles = hierarchy.getUpMiddles();
+	size_t shortcut = size_t(std::find_if(middles.begin(), middles.end(), [](size_t m) { return m != Graph::ContractionHierarchy<size_t>::npos; }) - middles.begin());
+	CHECK(shortcut < middles.size());
+	size_t highest = size_t(std::max_element(hierarchy.getRanks().begin(), hierarchy.getRanks().end()) - hierarchy.getRanks().begin());
+
+	CHECK(corruptedThrows(content, file, header.sections[3], 123456789012));
+	CHECK(corruptedThrows(content, file, header.sections[7] + 8, 60));
+	CHECK(corruptedThrows(content, file, header.sections[5] + shortcut * 8, 123456789012));
+	CHECK(corruptedThrows(content, file, header.sections[5] + shortcut * 8, highest));
+	CHECK(corruptedThrows(content, file, header.sections[2] + 8, 1000));
+	CHECK(corruptedThrows(content, file, header.sections[1], 60));
+	CHECK(corruptedThrows(content, file, header.sections[0], 59));
+	CHECK(Graph::loadContractionHierarchy<size_t>(file, true).getArcsCount() == hierarchy.getArcsCount());
+	std::remove(file.c_str());
+}
+
+int main()
+{
+	for(unsigned seed = 1; seed < 8; ++seed)
+	{
+		testQueries(false, seed);
+		testQueries(true, seed);
+	}
+	testGrid();
+	testCorrupted();
+
+	std::cout << "ContractionHierarchy OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,290 @@
+#include <cstdio>
+#include <thread>
+#include <tuple>
+#include "Test.h"
+
+struct CowSharedStorage : Graph::CowStorage
+{
+	template<typename T, template<typename> class Allocator>
+	using edge_store = Graph::SharedEdgeStore<T, Allocator>;
+};
+
+struct CowSlotFlatStorage : Graph::CowStorage
+{
+	template<typename T, template<typename> class Allocator>
+	using vertex_container = Graph::SlotMap<T, Allocator>;
+
+	template<typename T, template<typename> class Allocator>
+	using edge_container = Graph::FlatMap<T, Allocator>;
+};
+
+/**
+ * Copies are modified independently, each of them must stay equal to deep copy modified the same way
+ */
+template<typename S, typename R>
+void testIsolation(bool directed, unsigned seed)
+{
+	Graph::Graph<std::string, size_t, R> reference(directed);
+	Graph::Graph<std::string, size_t, S> graph(directed);
+	if(seed % 2)
+	{
+		reference.setIncomingIndex(true);
+		graph.setIncomingIndex(true);
+	}
+	Test::randomFill(reference, 50, 200, seed);
+	Test::randomFill(graph, 50, 200, seed);
+
+	std::mt19937 rng(seed);
+	std::vector<Graph::Graph<std::string, size_t, R>> references{ reference };
+	std::vector<Graph::Graph<std::string, size_t, S>> copies{ graph };
+	for(int round = 0; round < 30; ++round)
+	{
+		size_t k = rng() % references.size();
+		references.push_back(references[k]);
+		copies.push_back(copies[k]);
+		auto& a = references.back();
+		auto& b = copies.back();
+		for(int step = 0; step < 20; ++step)
+		{
+			size_t from = rng() % 52, to = rng() % 52, value = rng() % 100;
+			switch(rng() % 9)
+			{
+				case 0:
+				case 1:
+					a.addEdge(from, to, value);
+					b.addEdge(from, to, value);
+					break;
+				case 2:
+					CHECK(a.removeEdge(from, to) == b.removeEdge(from, to));
+					break;
+				case 3:
+					CHECK(a.updateEdgeValue(from, to, value) == b.updateEdgeValue(from, to, value));
+					break;
+				case 4:
+					if(rng() % 4 == 0)
+					{
+						CHECK(a.removeVertex(from) == b.removeVertex(from));
+						CHECK(a.addVertex("n") == b.addVertex("n"));
+					}
+					break;
+				case 5:
+				{
+					std::vector<std::tuple<size_t, size_t, size_t>> batch;
+					for(int i = 0; i < 5; ++i)
+					{
+						batch.emplace_back(rng() % 52, rng() % 52, rng() % 100);
+					}
+					CHECK(a.addEdges(batch) == b.addEdges(batch));
+					break;
+				}
+				case 6:
+					if(a.adjacent(from, to))
+					{
+						a.getEdgeValue(from, to) += 1;
+						b.getEdgeValue(from, to) += 1;
+						if(!directed)
+						{
+							a.getEdgeValue(to, from) = a.getEdgeValue(from, to);
+							b.getEdgeValue(to, from) = b.getEdgeValue(from, to);
+						}
+					}
+					break;
+				case 7:
+					CHECK(a.setVertexValue(from, "s" + std::to_string(value)) == b.setVertexValue(from, "s" + std::to_string(value)));
+					break;
+				case 8:
+					if(rng() % 10 == 0)
+					{
+						a.setIncomingIndex(!a.hasIncomingIndex());
+						b.setIncomingIndex(!b.hasIncomingIndex());
+					}
+					break;
+			}
+		}
+
+		for(size_t i = 0; i < references.size(); ++i)
+		{
+			CHECK(references[i].getEdgesPositionsAndValues(true) == copies[i].getEdgesPositionsAndValues(true));
+			for(auto id : references[i].getVerticesIds())
+			{
+				CHECK(references[i].getVertexValue(id) == copies[i].getVertexValue(id));
+				if(directed)
+				{
+					CHECK(references[i].getPredecessors(id) == copies[i].getPredecessors(id));
+				}
+			}
+		}
+	}
+
+	auto moved = std::move(copies[0]);
+	CHECK(copies[0].getVerticesCount() == moved.getVerticesCount());
+	copies[0].addVertex("after move");
+	CHECK(moved.getVerticesCount() + 1 == copies[0].getVerticesCount());
+	copies[1] = moved;
+	CHECK(copies[1] == moved);
+
+	const std::string path = "CowStorage_test.txt";
+	CHECK(copies[1].saveToFile(path));
+	Graph::Graph<std::string, size_t, S> loaded(directed);
+	CHECK(loaded.loadFromFile(path));
+	CHECK(loaded == moved);
+	// Loading into copy does not change graph it shares data with
+	auto reloaded = loaded;
+	CHECK(reloaded.loadFromFile(path));
+	CHECK(reloaded == loaded);
+	std::remove(path.c_str());
+	CHECK(Graph::freeze(references[3]).getEdgesCount() == Graph::freeze(copies[3]).getEdgesCount());
+}
+
+/**
+ * Copies of one graph are modified from different threads
+ */
+template<typename S>
+void testThreads()
+{
+	Graph::Graph<std::string, size_t, S> graph(false);
+	Test::randomFill(graph, 200, 800, 9);
+	auto edges = graph.getEdgesPositionsAndValues();
+	std::vector<std::thread> threads;
+	for(size_t t = 0; t < 4; ++t)
+	{
+		threads.emplace_back([&graph, t]()
+		{
+			auto copy = graph;
+			for(size_t i = 0; i < 200; ++i)
+			{
+				copy.addEdge(i, (i * 7 + t) % 200, t);
+				copy.updateEdgeValue(i, i + 1, t);
+			}
+		});
+	}
+	for(auto& thread : threads)
+	{
+		thread.join();
+	}
+	CHECK(graph.getEdgesPositionsAndValues() == edges);
+}
+
+/**
+ * Graph is modified while its copy exists, views and value references of vertices which were
+ * not modified must survive cloning of their chunk and destruction of the copy
+ */
+template<typename S>
+void testStableViews(bool directed)
+{
+	using G = Graph::Graph<std::string, size_t, S>;
+	G graph(directed);
+	auto ids = Test::randomFill(graph, 600, 2000, 5);
+	std::vector<typename G::NeighboursView> views;
+	std::vector<const std::string*> values;
+	for(auto id : ids)
+	{
+		views.push_back(graph.getNeighboursView(id));
+		values.push_back(&graph.getVertexValue(id));
+	}
+
+	std::mt19937 rng(5);
+	std::vector<bool> modified(ids.size(), false);
+	for(int round = 0; round < 40; ++round)
+	{
+		auto copy = graph;
+		size_t from = rng() % ids.size(), to = rng() % ids.size();
+		switch(rng() % 4)
+		{
+			case 0:
+				graph.addEdge(from, to, 1);
+				break;
+			case 1:
+				graph.removeEdge(from, to);
+				break;
+			case 2:
+				graph.updateEdgeValue(from, to, 7);
+				break;
+			case 3:
+				graph.addVertex("new");
+				break;
+		}
+		modified[from] = true;
+		modified[to] = modified[to] || !directed;
+	}
+
+	for(size_t i = 0; i < ids.size(); ++i)
+	{
+		if(!modified[i])
+		{
+			CHECK(std::vector<size_t>(views[i].begin(), views[i].end()) == graph.getNeighbours(ids[i]));
+			CHECK(values[i] == &graph.getVertexValue(ids[i]));
+		}
+	}
+}
+
+/**
+ * Copy of chunk map shares chunks, write clones only the chunk it touches
+ */
+void testChunkMap()
+{
+	Graph::ChunkMap<std::string> map;
+	for(size_t i = 0; i < 1000; i += 3)
+	{
+		map.emplace(i, std::to_string(i));
+	}
+	map.emplace(5000, "far");
+	CHECK(map.size() == 335 && map.count(5000) && !map.count(4999) && !map.count(4));
+
+	auto copy = map;
+	const auto& constMap = map;
+	const auto& constCopy = copy;
+	copy.find(600)->second = "changed";
+	CHECK(&*constMap.find(3) == &*constCopy.find(3));
+	CHECK(&*constMap.find(600) != &*constCopy.find(600) && constMap.find(600)->second == "600");
+
+	CHECK(copy.erase(3) == 1 && copy.erase(3) == 0);
+	CHECK(map.count(3) && !copy.count(3) && copy.size() == 334 && map != copy);
+	CHECK(!copy.emplace(6, "x").second && copy.emplace(7, "y").second && copy.find(7)->second == "y");
+
+	size_t previous = 0, count = 0;
+	for(auto& item : constCopy)
+	{
+		CHECK(count == 0 || item.first > previous);
+		previous = item.first;
+		++count;
+	}
+	CHECK(count == copy.size() && previous == 5000);
+	copy.clear();
+	CHECK(copy.empty() && copy.begin() == copy.end() && map.size() == 335);
+}
+
+template<typename S, typename R = Graph::DefaultStorage>
+void testStorage()
+{
+	for(unsigned seed = 1; seed < 8; ++seed)
+	{
+		testIsolation<S, R>(false, seed);
+		testIsolation<S, R>(true, seed);
+	}
+	testThreads<S>();
+	testStableViews<S>(false);
+	testStableViews<S>(true);
+}
+
+int main()
+{
+	testStorage<Graph::CowStorage>();
+	testStorage<CowSharedStorage>();
+	testStorage<CowSlotFlatStorage, Graph::SlotStorage>();
+	testChunkMap();
+
+	Graph::Graph<int, size_t, Graph::CowStorage> graph;
+	for(int i = 0; i < 3; ++i)
+	{
+		graph.addVertex(i);
+	}
+	graph.addEdge(0, 1, 5);
+	auto copy = graph;
+	copy.getEdgeValue(0, 1) = 7;
+	CHECK(graph.getEdgeValue(0, 1) == 5 && copy.getEdgeValue(0, 1) == 7);
+	CHECK(Graph::edmondsKarpMaxFlow(graph, 0, 1).first == 5);
+
+	std::cout << "CowStorage OK" << std::endl;
+	return 0;
+}
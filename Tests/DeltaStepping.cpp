@@ -0,0 +1,105 @@
+#include "Test.h"
+
+/**
+ * Delta-stepping gives distances of dijkstraAll for any delta and thread count,
+ * dense results do not depend on thread count and predecessors lie on shortest paths
+ */
+void testDistances(bool directed, unsigned seed)
+{
+	Graph::Graph<std::string, size_t> graph(directed);
+	Test::randomFill(graph, 150, 400, seed, seed == 2 ? 1 : (seed == 3 ? 5000 : 20));
+	graph.removeVertex(9);
+	graph.addVertex("isolated");
+	auto frozen = Graph::freeze(graph);
+	const size_t infinity = std::numeric_limits<size_t>::max();
+
+	for(size_t source : { size_t(0), size_t(33), size_t(150) })
+	{
+		auto reference = Graph::dijkstraAll(frozen, source);
+		for(size_t delta : { 0, 1, 7, 100000 })
+		{
+			auto sequential = Graph::deltaSteppingDense(frozen, source, delta, 1);
+			for(size_t threads : { 1, 2, 3, 8 })
+			{
+				auto paths = Graph::deltaSteppingDense(frozen, source, delta, threads);
+				CHECK(Graph::deltaStepping(frozen, source, delta, threads).first == reference.first);
+				CHECK(paths.distance == sequential.distance);
+				CHECK(paths.predecessor == sequential.predecessor);
+				for(size_t i = 0; i < frozen.getVerticesCount(); ++i)
+				{
+					if(i == frozen.indexOf(source) || paths.distance[i] == infinity)
+					{
+						CHECK(paths.predecessor[i] == i);
+						continue;
+					}
+					size_t previous = paths.predecessor[i];
+					CHECK(paths.distance[previous] + frozen.weightAt(frozen.findEdge(previous, i)) == paths.distance[i]);
+				}
+			}
+		}
+		CHECK(Graph::deltaStepping(graph, source, size_t(3), 2).first == reference.first);
+	}
+}
+
+/**
+ * Zero and floating weights, negative weight and unknown source are rejected
+ */
+void testFloating()
+{
+	Graph::Graph<int, double> graph(true);
+	for(int i = 0; i < 6; ++i)
+	{
+		graph.addVertex(i);
+	}
+	graph.addEdge(0, 1, 0.0);
+	graph.addEdge(1, 0, 0.0);
+	graph.addEdge(1, 2, 0.5);
+	graph.addEdge(0, 2, 0.75);
+	graph.addEdge(2, 3, 2.5);
+	graph.addEdge(3, 4, 0.0);
+	graph.addEdge(4, 3, 0.0);
+	auto frozen = Graph::freeze(graph);
+	auto reference = Graph::dijkstraAll(frozen, 0);
+	for(size_t threads : { 1, 4 })
+	{
+		for(double delta : { 0.0, 0.1, 1.0, 10.0 })
+		{
+			CHECK(Graph::deltaStepping(frozen, 0, delta, threads).first == reference.first);
+		}
+	}
+
+	graph.addEdge(4, 5, -1.0);
+	bool thrown = false;
+	try
+	{
+		Graph::deltaStepping(graph, 0);
+	}
+	catch(const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	CHECK(thrown);
+	thrown = false;
+	try
+	{
+		Graph::deltaStepping(frozen, 77);
+	}
+	catch(const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	CHECK(thrown);
+}
+
+int main()
+{
+	for(unsigned seed = 1; seed < 8; ++seed)
+	{
+		testDistances(false, seed);
+		testDistances(true, seed);
+	}
+	testFloating();
+
+	std::cout << "DeltaStepping OK" << std::endl;
+	return 0;
+}
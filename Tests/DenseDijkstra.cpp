@@ -0,0 +1,80 @@
+#include "Test.h"
+
+/**
+ * Dense results equal dijkstraAll, paths have length of their distance, reused search equals fresh one
+ */
+void testSearch(bool directed, unsigned seed)
+{
+	Graph::Graph<std::string, size_t> graph(directed);
+	Test::randomFill(graph, 80, 120, seed);
+	for(size_t i = 0; i < 5; ++i)
+	{
+		graph.addVertex("isolated");
+	}
+	graph.removeVertex(3);
+	auto frozen = Graph::freeze(graph);
+	Graph::DijkstraSearch<std::string, size_t> search(frozen);
+	const size_t infinity = std::numeric_limits<size_t>::max();
+
+	for(size_t source : { size_t(0), size_t(10), size_t(81), size_t(40), size_t(0) })
+	{
+		auto reference = Graph::dijkstraAll(graph, source);
+		CHECK(reference.first == Graph::dijkstraAll(frozen, source).first);
+		const auto& paths = search.run(frozen.indexOf(source));
+		auto fresh = Graph::dijkstraDense(frozen, source);
+		CHECK(paths.distance == fresh.distance && paths.predecessor == fresh.predecessor);
+
+		size_t reached = 0;
+		for(size_t i = 0; i < frozen.getVerticesCount(); ++i)
+		{
+			CHECK(paths.distance[i] == reference.first.at(frozen.idAt(i)));
+			auto path = paths.path(i);
+			if(paths.distance[i] == infinity)
+			{
+				CHECK(path.size() == 1);
+				continue;
+			}
+			++reached;
+			CHECK(path.front() == frozen.indexOf(source) && path.back() == i);
+			size_t length = 0;
+			for(size_t k = 0; k + 1 < path.size(); ++k)
+			{
+				length += frozen.getEdgeValue(frozen.idAt(path[k]), frozen.idAt(path[k + 1]));
+			}
+			CHECK(length == paths.distance[i]);
+		}
+		CHECK(reached == search.reachedVertices().size());
+	}
+
+	bool thrown = false;
+	try
+	{
+		Graph::dijkstraDense(frozen, 3);
+	}
+	catch(const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	CHECK(thrown);
+	thrown = false;
+	try
+	{
+		search.run(frozen.getVerticesCount());
+	}
+	catch(const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	CHECK(thrown);
+}
+
+int main()
+{
+	for(unsigned seed = 1; seed < 8; ++seed)
+	{
+		testSearch(false, seed);
+		testSearch(true, seed);
+	}
+	std::cout << "DenseDijkstra OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,68 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include "Test.h"
+
+/**
+ * Counts lines of exported edges and those of them which are colored
+ */
+std::pair<size_t, size_t> countEdges(const std::string& dot, const std::string& connector)
+{
+	std::istringstream input(dot);
+	std::string line;
+	size_t edges = 0, colored = 0;
+	while(std::getline(input, line))
+	{
+		if(line.find(connector) != std::string::npos)
+		{
+			++edges;
+			colored += line.find("color=\"red\"") != std::string::npos;
+		}
+	}
+	return { edges, colored };
+}
+
+/**
+ * Export to file and to stream are the same, each edge is written once and edges of path are colored
+ */
+void testExport(bool directed)
+{
+	const std::string path = "DotExport_test.dot";
+	Graph::Graph<std::string, size_t> graph(directed);
+	Test::randomFill(graph, 60, 150, directed ? 10 : 9);
+	std::vector<size_t> route{ 1, 2, 3, 10 };
+	graph.addEdge(3, 10, 1);
+
+	CHECK(graph.exportToDot(path, route));
+	std::ifstream input(path);
+	std::string fromFile((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+	input.close();
+	std::remove(path.c_str());
+	std::ostringstream stream;
+	CHECK(graph.exportToDot(stream, route));
+	CHECK(stream.str() == fromFile);
+	CHECK(!graph.exportToDot("DotExport_missing_directory/graph.dot"));
+
+	auto counts = countEdges(stream.str(), directed ? " -> " : " -- ");
+	CHECK(counts.first == graph.getEdgesPositions().size());
+	CHECK(counts.second == route.size() - 1);
+	CHECK(stream.str().find("0 [label=\"v0\"];") != std::string::npos);
+
+	// Colored edge of undirected graph may be given in either direction
+	Graph::Graph<int> unweighted(directed);
+	unweighted.addVertex(1);
+	unweighted.addVertex(2);
+	unweighted.addEdge(0, 1);
+	std::ostringstream unweightedStream;
+	CHECK(unweighted.exportToDot(unweightedStream, std::vector<std::pair<size_t, size_t>>{ { 1, 0 } }));
+	CHECK((unweightedStream.str().find("[color=\"red\"]") != std::string::npos) == !directed);
+}
+
+int main()
+{
+	testExport(false);
+	testExport(true);
+	std::cout << "DotExport OK" << std::endl;
+	return 0;
+}
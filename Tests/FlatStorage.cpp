@@ -0,0 +1,78 @@
+#include <algorithm>
+#include "Test.h"
+
+/**
+ * Graph with flat adjacency gives the same results as graph with default storage
+ */
+void testResults(bool directed, unsigned seed)
+{
+	Graph::Graph<std::string, size_t> graph(directed);
+	Graph::Graph<std::string, size_t, Graph::FlatStorage> flat(directed);
+	Test::randomFill(graph, 60, 300, seed);
+	Test::randomFill(flat, 60, 300, seed);
+
+	std::mt19937 rng(seed);
+	for(int i = 0; i < 40; ++i)
+	{
+		size_t from = rng() % 60, to = rng() % 60;
+		CHECK(graph.removeEdge(from, to) == flat.removeEdge(from, to));
+	}
+	graph.removeVertex(7);
+	flat.removeVertex(7);
+	graph.updateEdgeValue(1, 2, 5);
+	flat.updateEdgeValue(1, 2, 5);
+
+	CHECK(graph.getEdgesPositionsAndValues(true) == flat.getEdgesPositionsAndValues(true));
+	for(auto id : graph.getVerticesIds())
+	{
+		CHECK(graph.getEdgesFrom(id) == flat.getEdgesFrom(id));
+		CHECK(graph.getNeighbours(id) == flat.getNeighbours(id));
+	}
+	CHECK(Graph::dijkstraAll(graph, 0).first == Graph::dijkstraAll(flat, 0).first);
+	CHECK(Graph::bellmanFord(graph, 0).first == Graph::bellmanFord(flat, 0).first);
+
+	std::vector<std::string> order, flatOrder;
+	Graph::dfs(graph, 0, [&](const std::string& v) { order.push_back(v); }, [](const std::string&){});
+	Graph::dfs(flat, 0, [&](const std::string& v) { flatOrder.push_back(v); }, [](const std::string&){});
+	CHECK(order == flatOrder);
+	if(!directed)
+	{
+		CHECK(Graph::kruskalMST(graph) == Graph::kruskalMST(flat));
+	}
+	CHECK(Graph::freeze(graph).getEdgesCount() == Graph::freeze(flat).getEdgesCount());
+
+	auto copy = flat;
+	CHECK(copy == flat);
+}
+
+/**
+ * Merge of sorted run skips keys which are present or repeated in run
+ */
+void testMerge()
+{
+	Graph::FlatMap<int> map;
+	for(int key : { 5, 1, 9, 3 })
+	{
+		map.emplace(key, key);
+	}
+	CHECK(map.size() == 4 && map.begin()->first == 1 && map.count(9) && !map.count(4));
+
+	std::vector<std::pair<size_t, int>> run{ { 0, 0 }, { 3, 7 }, { 4, 4 }, { 4, 8 }, { 10, 10 } };
+	size_t inserted = 0, skipped = 0;
+	map.mergeSorted(run.begin(), run.end(), [&](size_t) { ++inserted; }, [&](size_t, int&) { ++skipped; });
+	CHECK(inserted == 3 && skipped == 2);
+	CHECK(map.size() == 7 && map.find(3)->second == 3);
+	CHECK(std::is_sorted(map.begin(), map.end(), [](const std::pair<size_t, int>& a, const std::pair<size_t, int>& b) { return a.first < b.first; }));
+}
+
+int main()
+{
+	for(unsigned seed = 1; seed < 8; ++seed)
+	{
+		testResults(false, seed);
+		testResults(true, seed);
+	}
+	testMerge();
+	std::cout << "FlatStorage OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,86 @@
+#include <cstdio>
+#include <fstream>
+#include "Test.h"
+#include "../Graph_frozen.h"
+
+/**
+ * Algorithms on frozen snapshot must give the same results as on graph it was taken from
+ */
+void testAlgorithms(bool directed, unsigned seed)
+{
+	Graph::Graph<std::string, size_t> graph(directed);
+	Test::randomFill(graph, 30, 60, seed);
+	graph.removeVertex(7);
+	auto frozen = Graph::freeze(graph);
+
+	CHECK(frozen.getVerticesCount() == graph.getVerticesCount());
+	for(auto id : graph.getVerticesIds())
+	{
+		CHECK(frozen.getNeighbours(id) == graph.getNeighbours(id));
+	}
+
+	CHECK(Graph::bfs(graph, 0, [](const std::string&){}).first == Graph::bfs(frozen, 0, [](const std::string&){}).first);
+
+	auto distances = Graph::dijkstraAll(graph, 0, std::numeric_limits<size_t>::max());
+	CHECK(distances.first == Graph::dijkstraAll(frozen, 0).first);
+	CHECK(Graph::bellmanFord(frozen, 0).first == distances.first);
+
+	std::vector<std::string> preorder, postorder, frozenPreorder, frozenPostorder;
+	Graph::dfs(graph, 3, [&](const std::string& v) { preorder.push_back(v); }, [&](const std::string& v) { postorder.push_back(v); });
+	Graph::dfs(frozen, 3, [&](const std::string& v) { frozenPreorder.push_back(v); }, [&](const std::string& v) { frozenPostorder.push_back(v); });
+	CHECK(preorder == frozenPreorder && postorder == frozenPostorder);
+
+	if(directed)
+	{
+		CHECK(Graph::edmondsKarpMaxFlow(graph, 0, 20).first == Graph::edmondsKarpMaxFlow(frozen, 0, 20).first);
+	}
+	else
+	{
+		size_t kruskalWeight = 0, primWeight = 0;
+		for(auto& e : Graph::kruskalMST(frozen))
+		{
+			kruskalWeight += graph.getEdgeValue(e.first, e.second);
+		}
+		auto tree = Graph::prim(frozen);
+		for(auto& e : tree)
+		{
+			primWeight += graph.getEdgeValue(e.first, e.second);
+		}
+		CHECK(kruskalWeight == primWeight);
+		CHECK(tree.size() + 1 == frozen.getVerticesCount());
+	}
+}
+
+/**
+ * Freezing does not allocate memory proportional to the largest id (ids loaded from file may be sparse)
+ */
+void testSparseIds()
+{
+	const std::string path = "FrozenGraph_test.txt";
+	{
+		std::ofstream output(path);
+		output << "id 0 1\n1000000000000 5\n18446744073709551615 7\nid 1000000000000 2\n0 3\nid 18446744073709551615 3\n";
+	}
+	Graph::Graph<int, int> graph(true);
+	CHECK(graph.loadFromFile(path));
+	std::remove(path.c_str());
+	auto frozen = Graph::freeze(graph);
+	CHECK(frozen.getVerticesCount() == 3);
+	for(auto id : graph.getVerticesIds())
+	{
+		CHECK(frozen.getNeighbours(id) == graph.getNeighbours(id));
+	}
+	CHECK(frozen.indexOf(18446744073709551615u) == 2 && frozen.indexOf(1) == frozen.npos);
+}
+
+int main()
+{
+	for(unsigned seed = 1; seed < 20; ++seed)
+	{
+		testAlgorithms(false, seed);
+		testAlgorithms(true, seed);
+	}
+	testSparseIds();
+	std::cout << "FrozenGraph OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,172 @@
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include "Test.h"
+#include "../Graph_io.h"
+
+void writeFile(const std::string& path, const std::string& text)
+{
+	std::ofstream output(path, std::ios::binary);
+	output << text;
+}
+
+const std::string path = "Importers_test.txt";
+
+/**
+ * Comments, empty lines, CRLF, repeated edges and ids not fitting into 32 bits
+ */
+void testEdgeList()
+{
+	writeFile(path, "# Directed graph\n# FromNodeId\tToNodeId\n1000\t7\n7 1000\n\n  42 7\r\n7 7\n1000 7\n99999999999 5");
+	Graph::Graph<size_t, Graph::Unweight> graph(true);
+	Graph::ExternalIds ids;
+	size_t calls = 0;
+	Graph::ImportProgress last;
+	CHECK(Graph::importEdgeList(graph, path, ids, [&](const Graph::ImportProgress& progress)
+	{
+		++calls;
+		last = progress;
+	}));
+	CHECK(graph.getVerticesCount() == 5);
+	CHECK(calls == 1 && last.edges == 6 && last.insertedEdges == 5 && last.vertices == 5 && last.bytes > 50);
+	CHECK(graph.adjacent(ids[1000], ids[7]) && graph.adjacent(ids[7], ids[1000]));
+	CHECK(graph.adjacent(ids[42], ids[7]) && graph.adjacent(ids[7], ids[7]));
+	CHECK(graph.getVertexValue(ids[99999999999]) == 99999999999u);
+	CHECK(graph.adjacent(ids[99999999999], ids[5]));
+
+	// Missing weight is default value, vertex value is external id converted to string
+	writeFile(path, "1 2 3.5\n2 3 -1\n3 1\n");
+	Graph::Graph<std::string, double> weighted(false);
+	CHECK(Graph::importEdgeList(weighted, path));
+	CHECK(weighted.getVertexValue(0) == "1" && weighted.getEdgeValue(1, 0) == 3.5);
+	CHECK(weighted.getEdgeValue(1, 2) == -1 && weighted.getEdgeValue(2, 0) == 0);
+
+	writeFile(path, "1 2\nx 3\n");
+	Graph::Graph<std::string, double> invalid(false);
+	CHECK(!Graph::importEdgeList(invalid, path));
+	CHECK(!Graph::importEdgeList(invalid, "Importers_missing.txt"));
+
+	// Value has to be valid for type of edge value and the last token of line
+	for(const char* text : { "1 2 abc\n", "1 2 7x\n", "1 2 3 4\n", "1 2 -1\n", "1 2 99999999999\n", "1 2 +\n" })
+	{
+		writeFile(path, text);
+		Graph::Graph<int, unsigned> graph(true);
+		CHECK(!Graph::importEdgeList(graph, path));
+	}
+	writeFile(path, "1 2 5\n2 3 7x\n");
+	Graph::Graph<int, int> stopped(true);
+	CHECK(!Graph::importEdgeList(stopped, path));
+	CHECK(stopped.getEdgesPositions().size() == 1 && stopped.getEdgeValue(0, 1) == 5);
+	writeFile(path, "1 2 \"a b\"\n2 3 \"c\" d\n");
+	Graph::Graph<int, std::string> strings(true);
+	CHECK(!Graph::importEdgeList(strings, path) && strings.getEdgeValue(0, 1) == "a b");
+	writeFile(path, "1 2 2.5e\n");
+	CHECK(!Graph::importEdgeList(weighted, path));
+	// Unweighted graph ignores value column
+	writeFile(path, "1 2 abc\n");
+	Graph::Graph<int> unweighted(true);
+	CHECK(Graph::importEdgeList(unweighted, path) && unweighted.adjacent(0, 1));
+}
+
+/**
+ * File crossing blocks and batches of importer gives the same graph as edges added one by one
+ */
+void testLargeEdgeList()
+{
+	std::mt19937 rng(3);
+	std::string text;
+	std::vector<std::pair<size_t, size_t>> edges;
+	for(int i = 0; i < 1500000; ++i)
+	{
+		size_t from = rng() % 100000 * 13, to = rng() % 100000 * 13;
+		edges.emplace_back(from, to);
+		text += std::to_string(from) + " " + std::to_string(to) + " " + std::to_string(i % 97) + "\n";
+	}
+	writeFile(path, text);
+
+	Graph::Graph<int, int> graph(true);
+	Graph::ExternalIds ids;
+	size_t calls = 0;
+	CHECK(Graph::importEdgeList(graph, path, ids, [&](const Graph::ImportProgress& progress)
+	{
+		++calls;
+		CHECK(progress.seconds >= 0);
+	}));
+	CHECK(calls == 2);
+
+	Graph::Graph<int, int> reference(true);
+	std::map<size_t, size_t> referenceIds;
+	int i = 0;
+	for(auto& e : edges)
+	{
+		for(size_t external : { e.first, e.second })
+		{
+			if(!referenceIds.count(external))
+			{
+				referenceIds[external] = reference.addVertex(int(external));
+			}
+		}
+		reference.addEdge(referenceIds[e.first], referenceIds[e.second], i++ % 97);
+	}
+	CHECK(graph.getEdgesPositionsAndValues() == reference.getEdgesPositionsAndValues());
+	CHECK(graph.getVerticesCount() == reference.getVerticesCount());
+}
+
+/**
+ * Symmetric, skew-symmetric and pattern matrices, unsupported and malformed files
+ */
+void testMatrixMarket()
+{
+	writeFile(path, "%%MatrixMarket matrix coordinate real symmetric\n% comment\n%\n4 4 4\n1 1 2.0\n2 1 -1.5\n4 2 3e2\n3 3 1\n");
+	Graph::Graph<int, double> directed(true), undirected(false);
+	Graph::ExternalIds ids;
+	CHECK(Graph::importMatrixMarket(directed, path, ids, [](const Graph::ImportProgress&) {}));
+	CHECK(Graph::importMatrixMarket(undirected, path));
+	CHECK(directed.getVerticesCount() == 4 && undirected.getVerticesCount() == 4);
+	CHECK(directed.getEdgeValue(ids[2], ids[1]) == -1.5 && directed.getEdgeValue(ids[1], ids[2]) == -1.5);
+	CHECK(directed.getEdgeValue(ids[1], ids[1]) == 2.0);
+	CHECK(directed.getEdgesPositions().size() == 6 && undirected.getEdgesPositions().size() == 4);
+	CHECK(undirected.getEdgeValue(1, 3) == 300);
+	CHECK(directed.getVertexValue(ids[4]) == 4);
+
+	writeFile(path, "%%MatrixMarket matrix coordinate integer skew-symmetric\n3 3 1\n2 1 5\n");
+	Graph::Graph<int, int> skew(true);
+	CHECK(Graph::importMatrixMarket(skew, path));
+	CHECK(skew.getEdgeValue(1, 0) == 5 && skew.getEdgeValue(0, 1) == -5);
+	// Negated value does not fit into unsigned type, undirected graph does not mirror it
+	Graph::Graph<int, unsigned> skewUnsigned(true), skewUndirected(false);
+	CHECK(!Graph::importMatrixMarket(skewUnsigned, path));
+	CHECK(Graph::importMatrixMarket(skewUndirected, path) && skewUndirected.getEdgeValue(0, 1) == 5);
+
+	writeFile(path, "%%MatrixMarket matrix coordinate pattern general\n2 5 2\n1 5\n2 1\n");
+	Graph::Graph<int, Graph::Unweight> pattern(true);
+	CHECK(Graph::importMatrixMarket(pattern, path));
+	CHECK(pattern.getVerticesCount() == 5 && pattern.adjacent(0, 4) && pattern.adjacent(1, 0));
+
+	for(const char* text : { "%%MatrixMarket matrix array real general\n2 2\n1\n2\n3\n4\n",
+	                         "%%MatrixMarket matrix coordinate complex general\n1 1 1\n1 1 1 0\n",
+	                         "%%MatrixMarket matrix coordinate real general\n2 2 2\n1 1 1\n",
+	                         "%%MatrixMarket matrix coordinate real general\n2 2 1\n3 1 1\n",
+	                         "%%MatrixMarket matrix coordinate real general\n2 2 1\n1 1 1\n2 2 2\n",
+	                         "%%MatrixMarket matrix coordinate real general\n2 2 1\n1 1 abc\n",
+	                         "%%MatrixMarket matrix coordinate real general\n2 2 1\n1 1 1x\n",
+	                         "%%MatrixMarket matrix coordinate real general\n2 2 1\n1 1 1 2\n",
+	                         "%%MatrixMarket matrix coordinate real general\n2 2 1\n1 1\n",
+	                         "%%MatrixMarket matrix coordinate pattern general\n2 2 1\n1 1 1\n",
+	                         "1 2\n" })
+	{
+		writeFile(path, text);
+		Graph::Graph<int, double> graph(true);
+		CHECK(!Graph::importMatrixMarket(graph, path));
+	}
+}
+
+int main()
+{
+	testEdgeList();
+	testLargeEdgeList();
+	testMatrixMarket();
+	std::remove(path.c_str());
+	std::cout << "Importers OK" << std::endl;
+	return 0;
+}
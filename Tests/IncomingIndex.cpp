@@ -0,0 +1,122 @@
+#include <cstdio>
+#include <map>
+#include "Test.h"
+
+/**
+ * Checks predecessors of graph with incoming index against graph without it
+ */
+template<typename G>
+void checkIndex(const G& graph, const G& reference)
+{
+	for(auto id : reference.getVerticesIds())
+	{
+		CHECK(graph.getPredecessors(id) == reference.getPredecessors(id));
+		CHECK(graph.getIncomingEdges(id) == reference.getIncomingEdges(id));
+		if(graph.hasIncomingIndex())
+		{
+			std::map<size_t, size_t> viewed;
+			for(auto e : graph.getIncomingEdgesView(id))
+			{
+				viewed.emplace(e.first, e.second);
+			}
+			CHECK(viewed == reference.getIncomingEdges(id));
+		}
+	}
+}
+
+/**
+ * Index stays consistent through random removals and insertions, copies and loading
+ */
+template<typename S>
+void testIndex()
+{
+	const std::string path = "IncomingIndex_test.txt";
+	for(unsigned seed = 1; seed < 10; ++seed)
+	{
+		Graph::Graph<std::string, size_t, S> graph, reference;
+		graph.setIncomingIndex(true);
+		Test::randomFill(graph, 40, 120, seed);
+		Test::randomFill(reference, 40, 120, seed);
+		graph.addEdge(3, 3, 1);
+		reference.addEdge(3, 3, 1);
+		checkIndex(graph, reference);
+
+		std::mt19937 rng(seed);
+		for(int i = 0; i < 30; ++i)
+		{
+			size_t a = rng() % 40, b = rng() % 40;
+			if(rng() % 3 == 0)
+			{
+				CHECK(graph.removeVertex(a) == reference.removeVertex(a));
+			}
+			else if(graph.adjacent(a, b))
+			{
+				CHECK(graph.removeEdge(a, b) == reference.removeEdge(a, b));
+			}
+			else
+			{
+				graph.addEdge(a, b, 5);
+				reference.addEdge(a, b, 5);
+			}
+			CHECK(graph == reference);
+			checkIndex(graph, reference);
+		}
+		auto copy = graph;
+		checkIndex(copy, reference);
+
+		CHECK(graph.saveToFile(path));
+		Graph::Graph<std::string, size_t, S> loaded;
+		loaded.setIncomingIndex(true);
+		CHECK(loaded.loadFromFile(path));
+		checkIndex(loaded, reference);
+		loaded.setIncomingIndex(false);
+		checkIndex(loaded, reference);
+	}
+	std::remove(path.c_str());
+}
+
+/**
+ * Undirected graph has no incoming index, removal of vertex still removes both directions
+ */
+template<typename S>
+void testUndirected()
+{
+	Graph::Graph<int, size_t, S> graph(false);
+	auto a = graph.addVertex(1), b = graph.addVertex(2), c = graph.addVertex(3);
+	graph.addEdge(a, b, 1);
+	graph.addEdge(c, a, 2);
+	CHECK(graph.getPredecessors(a) == (std::vector<size_t>{ b, c }));
+	graph.removeVertex(a);
+	CHECK(graph.getNeighbours(b).empty() && graph.getNeighbours(c).empty());
+
+	bool thrown = false;
+	try
+	{
+		graph.getIncomingEdgesView(b);
+	}
+	catch(const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	CHECK(thrown);
+}
+
+int main()
+{
+	testIndex<Graph::DefaultStorage>();
+	testIndex<Graph::SlotStorage>();
+	testUndirected<Graph::DefaultStorage>();
+	testUndirected<Graph::SlotStorage>();
+
+	// Removal of missing edge returns 0 without modifying vertices
+	Graph::Graph<int, int> graph(false);
+	size_t a = graph.addVertex(1), b = graph.addVertex(2);
+	graph.addEdge(a, b, 3);
+	CHECK(graph.removeEdge(a, 42) == 0);
+	CHECK(graph.removeEdge(42, a) == 0);
+	CHECK(graph.removeEdge(a, b) == 2);
+	CHECK(graph.removeEdge(a, b) == 0);
+
+	std::cout << "IncomingIndex OK" << std::endl;
+	return 0;
+}
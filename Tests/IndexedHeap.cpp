@@ -0,0 +1,188 @@
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <set>
+#include "Test.h"
+
+/**
+ * Indexed heaps of different arity and order against map of keys
+ */
+void testIndexedHeap(unsigned seed)
+{
+	std::mt19937 rng(seed);
+	const size_t n = 200;
+	MinIndexedHeap<int, 4> minHeap(n);
+	IndexedHeap<int, std::less<int>, 8> maxHeap(n);
+	IndexedHeap<int, std::greater<int>, 2> binaryHeap(n);
+	std::map<size_t, int> keys;
+	for(int step = 0; step < 5000; ++step)
+	{
+		size_t id = rng() % n;
+		int key = int(rng() % 1000);
+		int operation = int(rng() % 4);
+		if(operation < 2)
+		{
+			minHeap.pushOrUpdate(id, key);
+			maxHeap.pushOrUpdate(id, key);
+			binaryHeap.pushOrUpdate(id, key);
+			keys[id] = key;
+		}
+		else if(operation == 2 && !keys.empty())
+		{
+			auto it = keys.begin();
+			std::advance(it, rng() % keys.size());
+			minHeap.erase(it->first);
+			maxHeap.erase(it->first);
+			binaryHeap.erase(it->first);
+			keys.erase(it);
+		}
+		else if(!keys.empty())
+		{
+			int minimum = 1 << 30, maximum = -1;
+			for(auto& k : keys)
+			{
+				minimum = std::min(minimum, k.second);
+				maximum = std::max(maximum, k.second);
+			}
+			CHECK(minHeap.topKey() == minimum && binaryHeap.topKey() == minimum && maxHeap.topKey() == maximum);
+			CHECK(keys.at(minHeap.top()) == minimum);
+			size_t top = minHeap.top();
+			minHeap.pop();
+			maxHeap.erase(top);
+			binaryHeap.erase(top);
+			keys.erase(top);
+		}
+		CHECK(minHeap.size() == keys.size() && maxHeap.size() == keys.size() && binaryHeap.size() == keys.size());
+		for(auto& k : keys)
+		{
+			CHECK(minHeap.contains(k.first) && minHeap.key(k.first) == k.second);
+		}
+	}
+	minHeap.clear();
+	CHECK(minHeap.empty());
+	for(size_t i = 0; i < n; ++i)
+	{
+		CHECK(!minHeap.contains(i));
+	}
+}
+
+/**
+ * Original heap with handles keeps working
+ */
+void testHeap()
+{
+	MinHeap<int> heap{ 5, 3, 9, 1, 7 };
+	CHECK((toSortedVector(heap) == std::vector<int>{ 1, 3, 5, 7, 9 }));
+
+	std::mt19937 rng(3);
+	MaxHeap<int> maxHeap;
+	std::vector<MaxHeap<int>::Handle> handles;
+	for(int i = 0; i < 500; ++i)
+	{
+		handles.push_back(maxHeap.insert(int(rng() % 1000)));
+	}
+	for(int i = 0; i < 200; ++i)
+	{
+		maxHeap.update(handles[i], int(rng() % 1000));
+	}
+	for(int i = 200; i < 300; ++i)
+	{
+		maxHeap.erase(handles[i]);
+	}
+	int previous = 1 << 30;
+	while(!maxHeap.empty())
+	{
+		CHECK(maxHeap.top() <= previous);
+		previous = maxHeap.top();
+		maxHeap.pop();
+	}
+}
+
+/**
+ * Dijkstra and Prim give the same results with every heap queue tag
+ */
+void testQueueTags(bool directed, unsigned seed)
+{
+	Graph::Graph<std::string, size_t> graph(directed);
+	Test::randomFill(graph, 90, 150, seed);
+	graph.removeVertex(4);
+	graph.addVertex("isolated");
+	auto frozen = Graph::freeze(graph);
+	const size_t infinity = std::numeric_limits<size_t>::max();
+
+	for(size_t source : { size_t(0), size_t(17), size_t(90) })
+	{
+		auto reference = Graph::dijkstraAll(graph, source);
+		CHECK(Graph::dijkstraAll(graph, source, infinity, Graph::IndexedHeapQueue<4>()).first == reference.first);
+		CHECK(Graph::dijkstraAll(graph, source, infinity, Graph::IndexedHeapQueue<8>()).first == reference.first);
+		CHECK(Graph::dijkstraAll(graph, source, infinity, Graph::LazyHeapQueue()).first == reference.first);
+		CHECK(Graph::dijkstraAll(frozen, source, infinity, Graph::IndexedHeapQueue<2>()).first == reference.first);
+
+		auto dense = Graph::dijkstraDense(frozen, source, infinity, Graph::IndexedHeapQueue<8>());
+		CHECK(dense.distance == Graph::dijkstraDense(frozen, source).distance);
+		Graph::DijkstraSearch<std::string, size_t, Graph::IndexedHeapQueue<4>> search(frozen);
+		search.run(frozen.indexOf(source));
+		search.run(0);
+		CHECK(search.run(frozen.indexOf(source)).distance == dense.distance);
+	}
+
+	if(!directed)
+	{
+		auto weight = [&graph](const std::set<std::pair<size_t, size_t>>& tree)
+		{
+			size_t sum = 0;
+			for(auto& e : tree)
+			{
+				sum += graph.getEdgeValue(e.first, e.second);
+			}
+			return sum;
+		};
+		auto reference = Graph::prim(frozen, 0);
+		auto indexed = Graph::prim(graph, 0, Graph::IndexedHeapQueue<4>());
+		auto frozenIndexed = Graph::prim(frozen, 0, Graph::IndexedHeapQueue<8>());
+		auto lazy = Graph::prim(graph, 0, Graph::LazyHeapQueue());
+		CHECK(indexed.size() == reference.size() && frozenIndexed.size() == reference.size() && lazy.size() == reference.size());
+		CHECK(weight(indexed) == weight(reference) && weight(frozenIndexed) == weight(reference) && weight(lazy) == weight(reference));
+	}
+}
+
+/**
+ * Searches with queue tags use memory proportional to count of vertices, not to the largest id
+ */
+void testSparseIds()
+{
+	const std::string path = "IndexedHeap_test.txt";
+	{
+		std::ofstream output(path);
+		output << "id 0 \"a\"\n5 2\n1000000000000 9\nid 5 \"b\"\n0 2\n1000000000000 3\nid 1000000000000 \"c\"\n0 9\n5 3\n";
+	}
+	Graph::Graph<std::string, size_t> graph(false);
+	CHECK(graph.loadFromFile(path));
+	std::remove(path.c_str());
+	const size_t infinity = std::numeric_limits<size_t>::max();
+
+	auto reference = Graph::dijkstraAll(graph, 0);
+	auto indexed = Graph::dijkstraAll(graph, 0, infinity, Graph::IndexedHeapQueue<4>());
+	CHECK(indexed == reference && indexed.first.at(1000000000000) == 5 && indexed.second.at(1000000000000) == 5);
+	CHECK(Graph::dijkstraAll(graph, 1000000000000, infinity, Graph::DialQueue()) == Graph::dijkstraAll(graph, 1000000000000));
+	auto tree = Graph::prim(graph, 1000000000000, Graph::IndexedHeapQueue<2>());
+	CHECK(tree == (std::set<std::pair<size_t, size_t>>{ { 5, 0 }, { 1000000000000, 5 } }));
+	CHECK(Graph::prim(graph, 0, Graph::LazyHeapQueue()).size() == 2);
+}
+
+int main()
+{
+	for(unsigned seed = 1; seed < 20; ++seed)
+	{
+		testIndexedHeap(seed);
+	}
+	testHeap();
+	for(unsigned seed = 1; seed < 8; ++seed)
+	{
+		testQueueTags(false, seed);
+		testQueueTags(true, seed);
+	}
+	testSparseIds();
+	std::cout << "IndexedHeap OK" << std::endl;
+	return 0;
+}
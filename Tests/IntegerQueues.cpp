@@ -0,0 +1,108 @@
+#include <cstdint>
+#include <set>
+#include "Test.h"
+
+/**
+ * Monotone queue pops keys in the same order as sorted reference (pushed keys are never below the last popped)
+ */
+template<typename Q, typename E>
+void testQueue(unsigned seed, E maxStep)
+{
+	std::mt19937 rng(seed);
+	Graph::helper::SearchQueue<Q, E> queue;
+	queue.reset(0);
+	std::multiset<std::pair<E, size_t>> reference;
+	E last = 0;
+	for(int round = 0; round < 3; ++round)
+	{
+		for(int step = 0; step < 3000; ++step)
+		{
+			if(reference.empty() || rng() % 3 != 0)
+			{
+				E key = E(last + E(rng() % (uint64_t(maxStep) + 1)));
+				size_t id = rng() % 100;
+				queue.push(id, key);
+				reference.emplace(key, id);
+			}
+			else
+			{
+				auto top = queue.pop();
+				CHECK(top.first == reference.begin()->first && reference.find(top) != reference.end());
+				reference.erase(reference.find(top));
+				last = top.first;
+			}
+		}
+		while(!reference.empty())
+		{
+			auto top = queue.pop();
+			CHECK(top.first == reference.begin()->first);
+			reference.erase(reference.find(top));
+		}
+		CHECK(queue.empty());
+		queue.reset(0);
+		last = 0;
+	}
+}
+
+/**
+ * Searches with integer queues give the same distances as lazy heap
+ */
+void testSearches(bool directed, unsigned seed)
+{
+	Graph::Graph<std::string, size_t> graph(directed);
+	Test::randomFill(graph, 90, 150, seed, seed == 3 ? 100000 : 20);
+	graph.removeVertex(4);
+	graph.addVertex("isolated");
+	auto frozen = Graph::freeze(graph);
+	const size_t infinity = std::numeric_limits<size_t>::max();
+
+	for(size_t source : { size_t(0), size_t(17), size_t(90) })
+	{
+		auto reference = Graph::dijkstraAll(graph, source);
+		CHECK(Graph::dijkstraAll(graph, source, infinity, Graph::RadixHeapQueue()).first == reference.first);
+		CHECK(Graph::dijkstraAll(graph, source, infinity, Graph::DialQueue()).first == reference.first);
+		CHECK(Graph::dijkstraAll(graph, source, infinity, Graph::AutoQueue()).first == reference.first);
+		CHECK(Graph::dijkstraAll(frozen, source).first == reference.first);
+		CHECK(Graph::dijkstraAll(frozen, source, infinity, Graph::DialQueue()).first == reference.first);
+
+		auto dense = Graph::dijkstraDense(frozen, source, infinity, Graph::LazyHeapQueue());
+		Graph::DijkstraSearch<std::string, size_t, Graph::DialQueue> dial(frozen);
+		Graph::DijkstraSearch<std::string, size_t, Graph::RadixHeapQueue> radix(frozen);
+		dial.run(0);
+		radix.run(0);
+		CHECK(dial.run(frozen.indexOf(source)).distance == dense.distance);
+		CHECK(radix.run(frozen.indexOf(source)).distance == dense.distance);
+	}
+}
+
+int main()
+{
+	for(unsigned seed = 1; seed < 6; ++seed)
+	{
+		testQueue<Graph::RadixHeapQueue, size_t>(seed, 1000);
+		testQueue<Graph::RadixHeapQueue, uint8_t>(seed, 0);
+		testQueue<Graph::RadixHeapQueue, uint32_t>(seed, 5);
+		testQueue<Graph::DialQueue, size_t>(seed, 1000);
+		testQueue<Graph::DialQueue, uint32_t>(seed, 3);
+		testQueue<Graph::DialQueue, uint16_t>(seed, 0);
+	}
+	for(unsigned seed = 1; seed < 8; ++seed)
+	{
+		testSearches(false, seed);
+		testSearches(true, seed);
+	}
+
+	// Floating values use lazy heap with AutoQueue
+	Graph::Graph<int, double> graph(true);
+	for(int i = 0; i < 5; ++i)
+	{
+		graph.addVertex(i);
+	}
+	graph.addEdge(0, 1, 0.5);
+	graph.addEdge(1, 2, 0.25);
+	graph.addEdge(0, 2, 1.0);
+	CHECK(Graph::dijkstraDense(Graph::freeze(graph), 0).distance[2] == 0.75);
+
+	std::cout << "IntegerQueues OK" << std::endl;
+	return 0;
+}
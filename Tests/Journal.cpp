@@ -0,0 +1,275 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include "Test.h"
+
+/**
+ * Vertex value whose parsing throws for negative numbers
+ */
+struct Checked
+{
+	int value = 0;
+
+	bool operator==(const Checked& rhs) const
+	{
+		return value == rhs.value;
+	}
+};
+
+std::istream& operator>>(std::istream& stream, Checked& checked)
+{
+	stream >> checked.value;
+	if(checked.value < 0)
+	{
+		throw std::invalid_argument("negative value");
+	}
+	return stream;
+}
+
+std::ostream& operator<<(std::ostream& stream, const Checked& checked)
+{
+	return stream << checked.value;
+}
+
+template<typename G>
+bool sameGraphs(const G& a, const G& b)
+{
+	if(a.getVerticesIds() != b.getVerticesIds())
+	{
+		return false;
+	}
+	for(auto id : a.getVerticesIds())
+	{
+		if(!(a.getVertexValue(id) == b.getVertexValue(id)))
+		{
+			return false;
+		}
+	}
+	return a.getEdgesPositionsAndValues(true) == b.getEdgesPositionsAndValues(true);
+}
+
+/**
+ * Applies random journaled mutations (vertex values contain spaces and quotes)
+ */
+template<typename G>
+void mutate(G& graph, std::mt19937& rng, size_t steps)
+{
+	for(size_t i = 0; i < steps; ++i)
+	{
+		auto ids = graph.getVerticesIds();
+		if(ids.empty())
+		{
+			graph.addVertex("first");
+			continue;
+		}
+		size_t from = ids[rng() % ids.size()], to = ids[rng() % ids.size()];
+		switch(rng() % 8)
+		{
+			case 0:
+				graph.addVertex("n" + std::to_string(i));
+				break;
+			case 1:
+				graph.removeVertex(from);
+				break;
+			case 2:
+				graph.setVertexValue(from, "s \"q\" " + std::to_string(i));
+				break;
+			case 3:
+				graph.removeEdge(from, to);
+				break;
+			case 4:
+				graph.updateEdgeValue(from, to, rng() % 50);
+				break;
+			case 5:
+			{
+				std::vector<std::tuple<size_t, size_t, size_t>> batch;
+				for(int k = 0; k < 5; ++k)
+				{
+					batch.emplace_back(ids[rng() % ids.size()], ids[rng() % ids.size()], rng() % 50);
+				}
+				batch.emplace_back(from, to, 1);
+				batch.emplace_back(from, to, 2);
+				graph.addEdges(batch);
+				break;
+			}
+			default:
+				graph.addEdge(from, to, rng() % 50);
+				break;
+		}
+	}
+}
+
+const std::string basePath = "Journal_test.txt";
+const std::string journalPath = "Journal_test.log";
+
+/**
+ * Base file with replayed journal equals live graph, also after replaying twice, compaction and torn record
+ */
+template<typename S>
+void testReplay(bool directed)
+{
+	using G = Graph::Graph<std::string, size_t, S>;
+	std::remove(journalPath.c_str());
+	std::mt19937 rng(directed ? 7 : 8);
+	G graph(directed);
+	Test::randomFill(graph, 50, 100, 3);
+	graph.removeVertex(49);
+	CHECK(graph.saveToFile(basePath));
+	CHECK(graph.openJournal(journalPath) && graph.hasJournal());
+	mutate(graph, rng, 400);
+
+	// Copies do not inherit journal
+	auto copy = graph;
+	CHECK(!copy.hasJournal());
+	copy.addVertex("not journaled");
+
+	CHECK(graph.syncJournal());
+	G replayed(directed);
+	CHECK(replayed.loadFromFile(basePath) && replayed.replayJournal(journalPath));
+	CHECK(sameGraphs(graph, replayed));
+	// Replay over state which already contains journal gives the same graph
+	CHECK(replayed.replayJournal(journalPath));
+	CHECK(sameGraphs(graph, replayed));
+
+	// Compaction folds journal into base file
+	CHECK(graph.compactJournal(basePath));
+	{
+		std::ifstream input(journalPath);
+		CHECK(input.peek() == std::ifstream::traits_type::eof());
+	}
+	mutate(graph, rng, 200);
+	CHECK(graph.syncJournal());
+	G compacted(directed);
+	CHECK(compacted.loadFromFile(basePath) && compacted.replayJournal(journalPath));
+	CHECK(sameGraphs(graph, compacted));
+
+	// Torn last record is ignored, unknown record fails replay
+	graph.closeJournal();
+	CHECK(!graph.hasJournal());
+	{
+		std::ofstream output(journalPath, std::ios::app);
+		output << "e 1 2 4";
+	}
+	G torn(directed);
+	CHECK(torn.loadFromFile(basePath) && torn.replayJournal(journalPath));
+	CHECK(sameGraphs(graph, torn));
+	{
+		std::ofstream output(journalPath, std::ios::app);
+		output << "\nq 1 2\n";
+	}
+	G invalid(directed);
+	CHECK(invalid.loadFromFile(basePath) && !invalid.replayJournal(journalPath));
+	std::remove(basePath.c_str());
+	std::remove(journalPath.c_str());
+}
+
+/**
+ * Records stay buffered until sync, replay into empty graph restores unweighted graph
+ */
+void testUnweighted()
+{
+	std::remove(journalPath.c_str());
+	Graph::Graph<int> graph(true), replayed(true);
+	graph.setIncomingIndex(true);
+	CHECK(graph.openJournal(journalPath));
+	for(int i = 0; i < 10; ++i)
+	{
+		graph.addVertex(i);
+	}
+	for(int i = 0; i < 10; ++i)
+	{
+		graph.addEdge(i, (i * 3) % 10);
+	}
+	graph.addEdges(std::vector<std::pair<size_t, size_t>>{ { 1, 2 }, { 2, 1 }, { 1, 2 } });
+	graph.removeEdge(0, 0);
+	graph.removeVertex(4);
+	graph.setVertexValue(5, 55);
+	{
+		std::ifstream input(journalPath);
+		CHECK(input.peek() == std::ifstream::traits_type::eof());
+	}
+
+	CHECK(graph.syncJournal());
+	CHECK(replayed.replayJournal(journalPath));
+	CHECK(sameGraphs(graph, replayed));
+	std::ifstream input(journalPath);
+	std::string counter, first;
+	std::getline(input, counter);
+	std::getline(input, first);
+	CHECK(counter == "n 0" && first == "v 0 0");
+	input.close();
+	graph.closeJournal();
+	std::remove(journalPath.c_str());
+}
+
+/**
+ * Journal of graph stays open when replay fails on malformed record or throws,
+ * id above counter of fresh ids is rejected before it is allocated
+ */
+void testFailedReplay()
+{
+	const std::string ownPath = "Journal_test_own.log";
+	{
+		std::ofstream output(journalPath);
+		output << "v 0 \"a\"\nv 99999999999999999 \"x\"\n";
+	}
+	Graph::Graph<std::string, size_t, Graph::SlotStorage> slots;
+	CHECK(slots.openJournal(ownPath));
+	CHECK(!slots.replayJournal(journalPath));
+	CHECK(slots.hasJournal() && slots.getVerticesCount() == 1 && slots.addVertex("b") == 1);
+
+	{
+		std::ofstream output(journalPath);
+		output << "v 100000000000 1\n";
+	}
+	Graph::Graph<int, int, Graph::SlotStorage> numbers;
+	CHECK(numbers.openJournal(ownPath));
+	CHECK(!numbers.replayJournal(journalPath));
+	CHECK(numbers.hasJournal() && numbers.getVerticesCount() == 0);
+
+	{
+		std::ofstream output(journalPath);
+		output << "n 3\nv 3 1\nv 5 2\n";
+	}
+	CHECK(!numbers.replayJournal(journalPath));
+	CHECK(numbers.hasJournal() && numbers.getVerticesCount() == 1 && numbers.hasVertex(3));
+
+	{
+		std::ofstream output(journalPath);
+		output << "v 0 1\nv 1 -1\n";
+	}
+	Graph::Graph<Checked, size_t> checked;
+	CHECK(checked.openJournal(ownPath));
+	bool thrown = false;
+	try
+	{
+		checked.replayJournal(journalPath);
+	}
+	catch(const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	CHECK(thrown && checked.hasJournal() && checked.getVerticesCount() == 1);
+	slots.closeJournal();
+	checked.closeJournal();
+	std::remove(ownPath.c_str());
+	std::remove(journalPath.c_str());
+}
+
+int main()
+{
+	for(bool directed : { false, true })
+	{
+		testReplay<Graph::DefaultStorage>(directed);
+		testReplay<Graph::SlotStorage>(directed);
+		testReplay<Graph::CowStorage>(directed);
+		testReplay<Graph::SharedEdgeStorage>(directed);
+		testReplay<Graph::FlatStorage>(directed);
+	}
+	testUnweighted();
+	testFailedReplay();
+	std::cout << "Journal OK" << std::endl;
+	return 0;
+}
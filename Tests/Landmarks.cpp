@@ -0,0 +1,112 @@
+#include "Test.h"
+#include "../Graph_alt.h"
+
+/**
+ * Bounds enclose dijkstraAll distance (exact when every vertex is landmark),
+ * searches with and without landmarks find shortest paths
+ */
+void testQueries(bool directed, unsigned seed)
+{
+	Graph::Graph<std::string, size_t> graph(directed);
+	Test::randomFill(graph, 150, 200, seed);
+	for(size_t i = 0; i < 3; ++i)
+	{
+		graph.addVertex("isolated");
+	}
+	graph.removeVertex(3);
+	auto frozen = Graph::freeze(graph);
+
+	auto selection = seed % 2 ? Graph::LandmarkSelection::Farthest : Graph::LandmarkSelection::Degree;
+	const bool everyVertex = seed == 3;
+	Graph::LandmarkIndex<size_t> index(frozen, everyVertex ? 1000 : 6, selection, seed % 3 + 1);
+	Graph::LandmarkIndex<size_t> fromGraph(graph, 6, selection, 1);
+	CHECK(index.getLandmarks().size() == (everyVertex ? frozen.getVerticesCount() : 6));
+	CHECK(fromGraph.getLandmarks() == Graph::LandmarkIndex<size_t>(frozen, 6, selection, 4).getLandmarks());
+	Graph::LandmarkIndex<size_t> none(frozen, 0);
+	CHECK(none.getTablesSize() == 0);
+
+	Graph::LandmarkSearch<std::string, size_t> search(frozen, index);
+	Graph::LandmarkSearch<std::string, size_t, Graph::IndexedHeapQueue<4>> search4(frozen, fromGraph);
+	Graph::LandmarkSearch<std::string, size_t> plain(frozen, none);
+	auto ids = graph.getVerticesIds();
+	std::mt19937 rng(seed);
+	for(int k = 0; k < 20; ++k)
+	{
+		size_t source = ids[rng() % ids.size()];
+		auto reference = Graph::dijkstraAll(graph, source).first;
+		for(int j = 0; j < 15; ++j)
+		{
+			size_t target = j == 0 ? source : ids[rng() % ids.size()];
+			size_t expected = reference.at(target);
+			size_t lower = index.lowerBound(source, target);
+			size_t upper = index.upperBound(source, target);
+			CHECK(lower <= expected);
+			CHECK(upper >= expected);
+			if(everyVertex)
+			{
+				CHECK(lower == expected && upper == expected);
+			}
+			Test::checkPath(graph, source, target, search.query(source, target), expected);
+			Test::checkPath(graph, source, target, search4.query(source, target), expected);
+			Test::checkPath(graph, source, target, plain.query(source, target), expected);
+		}
+	}
+
+	bool thrown = false;
+	try
+	{
+		search.query(3, 0);
+	}
+	catch(const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	CHECK(thrown);
+	thrown = false;
+	try
+	{
+		index.lowerBound(0, 3);
+	}
+	catch(const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	CHECK(thrown);
+
+	// Index of graph with the same count of vertices but other ids is rejected
+	auto other = graph;
+	other.removeVertex(0);
+	other.addVertex("other");
+	auto otherFrozen = Graph::freeze(other);
+	CHECK(otherFrozen.getVerticesCount() == frozen.getVerticesCount());
+	thrown = false;
+	try
+	{
+		Graph::LandmarkSearch<std::string, size_t> mismatched(otherFrozen, index);
+	}
+	catch(const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	CHECK(thrown);
+
+	// Tables do not depend on count of threads filling them
+	Graph::LandmarkIndex<size_t> parallel(graph, 6, selection, 4);
+	for(size_t i = 0; i < 40; ++i)
+	{
+		size_t from = ids[rng() % ids.size()], to = ids[rng() % ids.size()];
+		CHECK(parallel.lowerBound(from, to) == fromGraph.lowerBound(from, to) && parallel.upperBound(from, to) == fromGraph.upperBound(from, to));
+	}
+}
+
+int main()
+{
+	for(unsigned seed = 1; seed < 7; ++seed)
+	{
+		testQueries(false, seed);
+		testQueries(true, seed);
+	}
+
+	std::cout << "Landmarks OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,48 @@
+#include <sstream>
+#include "Test.h"
+
+/**
+ * Usage counts at least the values stored in graph and its parts sum to total
+ */
+template<typename S>
+Graph::MemoryUsage testUsage()
+{
+	Graph::Graph<std::string, size_t, S> graph(false);
+	Test::randomFill(graph, 200, 1000, 3);
+	graph.addVertex(std::string(100, 'x'));
+
+	auto usage = graph.memoryUsage();
+	CHECK(usage.vertexValues >= 201 * sizeof(std::string) + 101);
+	// Shared edge store keeps value of undirected edge once
+	CHECK(usage.edgeValues >= graph.getEdgesPositions().size() * sizeof(size_t));
+	CHECK(usage.total() == usage.vertices + usage.adjacency + usage.edgeValues + usage.vertexValues);
+	CHECK(!graph.listMemoryUsage().empty());
+
+	Graph::Graph<std::string, size_t, S> empty(false);
+	CHECK(empty.memoryUsage().adjacency == 0);
+	// Copy-on-write holder of empty edge store is counted as well
+	CHECK(empty.memoryUsage().edgeValues == 0 || S::template holder<int>::copy_on_write);
+	return usage;
+}
+
+int main()
+{
+	auto usage = testUsage<Graph::DefaultStorage>();
+	auto flatUsage = testUsage<Graph::FlatStorage>();
+	testUsage<Graph::SlotStorage>();
+	testUsage<Graph::PoolStorage>();
+	testUsage<Graph::SharedEdgeStorage>();
+	testUsage<Graph::CowStorage>();
+	CHECK(usage.edgeValues == flatUsage.edgeValues && flatUsage.adjacency < usage.adjacency);
+
+	Graph::Graph<int> unweighted;
+	unweighted.addVertex(1);
+	unweighted.addVertex(2);
+	unweighted.addEdge(0, 1);
+	std::ostringstream report;
+	unweighted.listMemoryUsageToStream(report);
+	CHECK(!report.str().empty());
+
+	std::cout << "MemoryUsage OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include "Test.h"
+#include "../Graph_io.h"
+
+bool fileExists(const std::string& path)
+{
+	return std::ifstream(path).good();
+}
+
+const std::string path = "OutOfCore_test.bin";
+
+/**
+ * Builder gives the same file as saving of graph built in memory, vertices may come after their edges
+ * and edges of missing vertices are dropped; run files are removed
+ */
+void testBuilder(bool directed, size_t bufferedEdges, unsigned seed)
+{
+	std::mt19937 rng(seed);
+	const size_t n = 60;
+	Graph::Graph<std::string, int> graph(directed);
+	Graph::BinaryGraphBuilder<std::string, int> builder(path, directed, bufferedEdges);
+	for(size_t i = 0; i < n; ++i)
+	{
+		graph.addVertex("v" + std::to_string(i));
+	}
+	graph.removeVertex(7);
+
+	std::vector<size_t> order;
+	for(size_t i = 0; i < n; ++i)
+	{
+		if(i != 7)
+		{
+			order.push_back(i);
+		}
+	}
+	std::shuffle(order.begin(), order.end(), rng);
+	for(size_t k = 0; k < order.size() / 2; ++k)
+	{
+		builder.addVertex(order[k], "v" + std::to_string(order[k]));
+	}
+	for(size_t i = 0; i < 300; ++i)
+	{
+		size_t from = rng() % n, to = rng() % n;
+		int value = int(rng() % 30);
+		if(from != 7 && to != 7)
+		{
+			graph.addEdge(from, to, value);
+		}
+		builder.addEdge(from, to, value);
+	}
+	for(size_t k = order.size() / 2; k < order.size(); ++k)
+	{
+		builder.addVertex(order[k], "v" + std::to_string(order[k]));
+	}
+	CHECK(builder.finish());
+	for(size_t run : { 0, 63, 64, 599, 600, 610 })
+	{
+		CHECK(!fileExists(path + ".run" + std::to_string(run)));
+	}
+
+	auto frozen = Graph::freeze(graph);
+	auto mapped = Graph::loadBinary<std::string, int>(path);
+	CHECK(Test::sameFrozen(frozen, mapped));
+	CHECK(mapped.getTargets().isView());
+	Graph::adviseAccess(mapped, Graph::AccessPattern::Sequential);
+	Graph::adviseAccess(mapped, Graph::AccessPattern::Random);
+	Graph::adviseAccess(mapped, Graph::AccessPattern::WillNeed);
+	Graph::adviseAccess(frozen, Graph::AccessPattern::Normal);
+	if(directed)
+	{
+		CHECK(Graph::bellmanFord(frozen, 0).first == Graph::bellmanFord(mapped, 0).first);
+	}
+
+	// Level-synchronous search gives the same levels, each predecessor is one level closer
+	auto levels = Graph::bfsByLevels(mapped, 0, [](const std::string&) {});
+	CHECK(Graph::bfs(mapped, 0, [](const std::string&) {}).first == levels.first);
+	for(auto& p : levels.second)
+	{
+		if(p.first != p.second && levels.first[p.first] != std::numeric_limits<size_t>::max())
+		{
+			CHECK(levels.first[p.second] + 1 == levels.first[p.first] && mapped.adjacent(p.second, p.first));
+		}
+	}
+	CHECK(Graph::bfsByLevels(mapped, 12345, [](const std::string&) {}).first.empty());
+}
+
+/**
+ * More runs than merged at once are merged in several passes
+ */
+void testManyRuns()
+{
+	std::mt19937 rng(5);
+	Graph::Graph<int, int> graph(true);
+	Graph::BinaryGraphBuilder<int, int> builder(path, true, 2);
+	for(int i = 0; i < 500; ++i)
+	{
+		graph.addVertex(i);
+		builder.addVertex(i, i);
+	}
+	for(int i = 0; i < 20000; ++i)
+	{
+		size_t from = rng() % 500, to = rng() % 500;
+		int value = int(rng() % 9);
+		graph.addEdge(from, to, value);
+		builder.addEdge(from, to, value);
+	}
+	CHECK(builder.finish());
+	CHECK(Test::sameFrozen(Graph::freeze(graph), Graph::loadBinary<int, int>(path)));
+	CHECK(!fileExists(path + ".run0") && !fileExists(path + ".run10000"));
+}
+
+/**
+ * Unweighted and empty graphs, duplicate vertex and unfinished builder
+ */
+void testSpecialCases()
+{
+	Graph::Graph<int> graph(true);
+	Graph::BinaryGraphBuilder<int, Graph::Unweight> unweighted(path, true, 3);
+	for(int i = 0; i < 30; ++i)
+	{
+		graph.addVertex(i * 2);
+		unweighted.addVertex(size_t(i), i * 2);
+	}
+	for(size_t i = 0; i < 100; ++i)
+	{
+		size_t from = (i * 7) % 30, to = (i * 11 + 3) % 30;
+		graph.addEdge(from, to);
+		unweighted.addEdge(from, to);
+	}
+	CHECK(unweighted.finish());
+	CHECK(Test::sameFrozen(Graph::freeze(graph), Graph::loadBinary<int, Graph::Unweight>(path)));
+
+	Graph::BinaryGraphBuilder<int, int> empty(path, false);
+	CHECK(empty.finish());
+	auto mapped = Graph::loadBinary<int, int>(path);
+	CHECK(mapped.getVerticesCount() == 0 && mapped.getEdgesCount() == 0);
+
+	Graph::BinaryGraphBuilder<int, int> duplicate(path, false, 1);
+	duplicate.addVertex(1);
+	duplicate.addVertex(1);
+	duplicate.addEdge(1, 1, 2);
+	duplicate.addEdge(1, 1, 3);
+	bool thrown = false;
+	try
+	{
+		duplicate.finish();
+	}
+	catch(const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	CHECK(thrown && !fileExists(path + ".run0"));
+
+	// Destructor removes runs of unfinished builder
+	{
+		Graph::BinaryGraphBuilder<int, int> unfinished(path, true, 1);
+		unfinished.addEdge(1, 2, 3);
+		unfinished.addEdge(2, 3, 3);
+		CHECK(fileExists(path + ".run0"));
+	}
+	CHECK(!fileExists(path + ".run0"));
+}
+
+/**
+ * Missing or truncated run file makes finish throw instead of writing graph without its edges
+ */
+void testBrokenRuns()
+{
+	for(int broken = 0; broken < 2; ++broken)
+	{
+		Graph::BinaryGraphBuilder<int, int> builder(path, true, 1);
+		for(size_t i = 0; i < 4; ++i)
+		{
+			builder.addVertex(i, int(i));
+			builder.addEdge(i, (i + 1) % 4, 1);
+		}
+		if(broken == 0)
+		{
+			std::remove((path + ".run1").c_str());
+		}
+		else
+		{
+			std::ofstream output(path + ".run1", std::ios::binary | std::ios::trunc);
+			output << "short";
+		}
+		bool thrown = false;
+		try
+		{
+			builder.finish();
+		}
+		catch(const std::runtime_error&)
+		{
+			thrown = true;
+		}
+		CHECK(thrown);
+	}
+	CHECK(!fileExists(path + ".run0"));
+}
+
+int main()
+{
+	for(bool directed : { false, true })
+	{
+		for(size_t bufferedEdges : { size_t(1), size_t(7), size_t(100000) })
+		{
+			for(unsigned seed = 1; seed < 5; ++seed)
+			{
+				testBuilder(directed, bufferedEdges, seed);
+			}
+		}
+	}
+	testManyRuns();
+	testSpecialCases();
+	testBrokenRuns();
+	std::remove(path.c_str());
+	std::cout << "OutOfCore OK" << std::endl;
+	return 0;
+}
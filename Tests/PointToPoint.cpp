@@ -0,0 +1,84 @@
+#include "Test.h"
+
+/**
+ * Early-exit and bidirectional queries equal dijkstraAll, transposed graph has reversed edges,
+ * removed vertices are rejected
+ */
+void testQueries(bool directed, bool incomingIndex, unsigned seed)
+{
+	Graph::Graph<std::string, size_t> graph(directed);
+	graph.setIncomingIndex(incomingIndex);
+	Test::randomFill(graph, 90, 100, seed);
+	for(size_t i = 0; i < 5; ++i)
+	{
+		graph.addVertex("isolated");
+	}
+	graph.removeVertex(3);
+	graph.removeVertex(50);
+	auto frozen = Graph::freeze(graph);
+
+	auto transposed = Graph::transpose(frozen);
+	CHECK(transposed.getEdgesCount() == frozen.getEdgesCount());
+	for(size_t v = 0; v < frozen.getVerticesCount(); ++v)
+	{
+		for(size_t e = frozen.edgesBegin(v); e < frozen.edgesEnd(v); ++e)
+		{
+			CHECK(transposed.getEdgeValue(frozen.idAt(frozen.targetAt(e)), frozen.idAt(v)) == frozen.weightAt(e));
+		}
+	}
+
+	Graph::BidirectionalDijkstra<std::string, size_t> bidirectional(frozen);
+	Graph::BidirectionalDijkstra<std::string, size_t, Graph::IndexedHeapQueue<4>> bidirectional4(frozen);
+	Graph::DijkstraSearch<std::string, size_t> search(frozen);
+	std::mt19937 rng(seed);
+	for(size_t source : { size_t(0), size_t(10), size_t(91), size_t(40), size_t(70) })
+	{
+		auto reference = Graph::dijkstraAll(graph, source);
+		for(int k = 0; k < 25; ++k)
+		{
+			size_t target = k == 0 ? source : frozen.idAt(rng() % frozen.getVerticesCount());
+			size_t expected = reference.first.at(target);
+			Test::checkPath(graph, source, target, Graph::dijkstra(graph, source, target), expected);
+			Test::checkPath(graph, source, target, Graph::dijkstraBidirectional(graph, source, target), expected);
+			Test::checkPath(graph, source, target, Graph::dijkstra(frozen, source, target), expected);
+			Test::checkPath(graph, source, target, Graph::dijkstra(frozen, source, target, Test::infinity, Graph::DialQueue()), expected);
+			Test::checkPath(graph, source, target, Graph::dijkstraBidirectional(frozen, source, target), expected);
+			Test::checkPath(graph, source, target, bidirectional.query(source, target), expected);
+			Test::checkPath(graph, source, target, bidirectional4.query(source, target), expected);
+			CHECK(search.run(frozen.indexOf(source), frozen.indexOf(target)).distance[frozen.indexOf(target)] == expected);
+		}
+	}
+
+	for(int call = 0; call < 4; ++call)
+	{
+		bool thrown = false;
+		try
+		{
+			switch(call)
+			{
+				case 0: Graph::dijkstra(graph, 3, 0); break;
+				case 1: Graph::dijkstraBidirectional(graph, 0, 50); break;
+				case 2: Graph::dijkstra(frozen, 0, 3); break;
+				default: bidirectional.query(50, 0); break;
+			}
+		}
+		catch(const std::invalid_argument&)
+		{
+			thrown = true;
+		}
+		CHECK(thrown);
+	}
+}
+
+int main()
+{
+	for(unsigned seed = 1; seed < 8; ++seed)
+	{
+		testQueries(false, false, seed);
+		testQueries(true, false, seed);
+		testQueries(true, true, seed);
+	}
+
+	std::cout << "PointToPoint OK" << std::endl;
+	return 0;
+}
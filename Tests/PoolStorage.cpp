@@ -0,0 +1,158 @@
+#include <thread>
+#include "Test.h"
+
+struct SlotPoolStorage : Graph::SlotStorage
+{
+	template<typename T>
+	using allocator = Graph::PoolAllocator<T>;
+
+	using arena = Graph::helper::SharedPoolArena;
+};
+
+struct CowPoolStorage : Graph::CowStorage
+{
+	template<typename T>
+	using allocator = Graph::PoolAllocator<T>;
+
+	using arena = Graph::helper::SharedPoolArena;
+};
+
+template<typename S>
+using TestGraph = Graph::Graph<std::string, size_t, S>;
+
+/**
+ * Graph allocating from arena gives the same results as graph with default storage
+ */
+template<typename S>
+void testResults(bool directed)
+{
+	TestGraph<S> graph(directed);
+	Graph::Graph<std::string, size_t> reference(directed);
+	Test::randomFill(graph, 50, 200, 5);
+	Test::randomFill(reference, 50, 200, 5);
+	graph.removeVertex(3);
+	reference.removeVertex(3);
+	for(auto id : reference.getVerticesIds())
+	{
+		CHECK(graph.getEdgesFrom(id) == reference.getEdgesFrom(id));
+	}
+	CHECK(Graph::dijkstraAll(graph, 0).first == Graph::dijkstraAll(reference, 0).first);
+	auto copy = graph;
+	CHECK(copy == graph);
+}
+
+/**
+ * Nodes stay valid when graph which allocated them is gone (arena is shared)
+ */
+template<typename S>
+void testLifetimes()
+{
+	Graph::Graph<std::string, size_t> reference;
+	Test::randomFill(reference, 100, 400, 3);
+	auto check = [&reference](const TestGraph<S>& graph)
+	{
+		for(auto id : reference.getVerticesIds())
+		{
+			CHECK(graph.getEdgesFrom(id) == reference.getEdgesFrom(id));
+		}
+	};
+
+	// Copy outlives its source
+	TestGraph<S>* source = new TestGraph<S>();
+	Test::randomFill(*source, 100, 400, 3);
+	TestGraph<S> copy(*source);
+	delete source;
+	check(copy);
+
+	// Assigned graph outlives its source, moved-from graph stays usable after destination is gone
+	TestGraph<S> assigned;
+	assigned.addVertex("x");
+	{
+		TestGraph<S> temporary;
+		Test::randomFill(temporary, 100, 400, 3);
+		assigned = temporary;
+	}
+	check(assigned);
+	TestGraph<S>* destination = new TestGraph<S>(std::move(assigned));
+	check(*destination);
+	delete destination;
+	size_t id = assigned.addVertex("y");
+	assigned.addEdge(id, id, 1);
+	CHECK(assigned.adjacent(id, id));
+
+	// Moved-from source is modified and destroyed after move assignment
+	TestGraph<S> target;
+	{
+		TestGraph<S> temporary;
+		Test::randomFill(temporary, 100, 400, 3);
+		target = std::move(temporary);
+		temporary.addVertex("z");
+	}
+	check(target);
+
+	// Freed nodes are reused
+	for(int i = 0; i < 50; ++i)
+	{
+		size_t added = target.addVertex("t");
+		target.addEdge(added, 0, 1);
+		target.removeVertex(added);
+	}
+	check(target);
+}
+
+/**
+ * Graphs are built in some threads and destroyed in others
+ */
+template<typename S>
+void testThreads()
+{
+	std::vector<TestGraph<S>> graphs(8);
+	std::vector<std::thread> threads;
+	for(unsigned t = 0; t < 8; ++t)
+	{
+		threads.emplace_back([&graphs, t]()
+		{
+			for(unsigned round = 0; round < 20; ++round)
+			{
+				TestGraph<S> graph;
+				Test::randomFill(graph, 200, 800, t * 100 + round);
+				graphs[t] = graph;
+			}
+		});
+	}
+	for(auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	threads.clear();
+	for(size_t t = 0; t < 8; ++t)
+	{
+		threads.emplace_back([&graphs, t]()
+		{
+			graphs[(t + 1) % 8] = TestGraph<S>();
+		});
+	}
+	for(auto& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+template<typename S>
+void testStorage()
+{
+	testResults<S>(false);
+	testResults<S>(true);
+	testLifetimes<S>();
+	testThreads<S>();
+}
+
+int main()
+{
+	testStorage<Graph::PoolStorage>();
+	testStorage<SlotPoolStorage>();
+	testStorage<CowPoolStorage>();
+	std::cout << "PoolStorage OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,242 @@
+#include <cstdio>
+#include <tuple>
+#include "Test.h"
+
+// Shared store is used also for numeric values, which SharedEdgeStorage keeps in adjacency
+struct SharedAlwaysStorage : Graph::DefaultStorage
+{
+	template<typename T, template<typename> class Allocator>
+	using edge_store = Graph::SharedEdgeStore<T, Allocator>;
+};
+
+struct SharedFlatStorage : SharedAlwaysStorage
+{
+	template<typename T, template<typename> class Allocator>
+	using edge_container = Graph::FlatMap<T, Allocator>;
+};
+
+/**
+ * Edge value without default constructor
+ */
+struct Weight
+{
+	int value;
+
+	explicit Weight(int value)
+		:value(value)
+	{}
+
+	bool operator==(const Weight& other) const
+	{
+		return value == other.value;
+	}
+};
+
+std::ostream& operator<<(std::ostream& stream, const Weight& weight)
+{
+	return stream << weight.value;
+}
+
+/**
+ * Random mutations give the same graph as default storage, released values are reused
+ */
+template<typename S>
+void testMutations(bool directed, unsigned seed)
+{
+	const std::string path = "SharedEdgeStorage_test.txt";
+	Graph::Graph<std::string, size_t> reference(directed);
+	Graph::Graph<std::string, size_t, S> graph(directed);
+	if(seed % 2)
+	{
+		reference.setIncomingIndex(true);
+		graph.setIncomingIndex(true);
+	}
+	for(int i = 0; i < 40; ++i)
+	{
+		reference.addVertex("v");
+		graph.addVertex("v");
+	}
+
+	std::mt19937 rng(seed);
+	for(int step = 0; step < 2000; ++step)
+	{
+		size_t from = rng() % 42, to = rng() % 42, value = rng() % 100;
+		switch(rng() % 8)
+		{
+			case 0:
+			case 1:
+			case 2:
+				reference.addEdge(from, to, value);
+				graph.addEdge(from, to, value);
+				break;
+			case 3:
+				CHECK(reference.removeEdge(from, to) == graph.removeEdge(from, to));
+				break;
+			case 4:
+				CHECK(reference.updateEdgeValue(from, to, value) == graph.updateEdgeValue(from, to, value));
+				break;
+			case 5:
+				if(rng() % 10 == 0)
+				{
+					CHECK(reference.removeVertex(from) == graph.removeVertex(from));
+					CHECK(reference.addVertex("n") == graph.addVertex("n"));
+				}
+				break;
+			case 6:
+			{
+				std::vector<std::tuple<size_t, size_t, size_t>> batch;
+				for(int i = 0; i < 10; ++i)
+				{
+					batch.emplace_back(rng() % 42, rng() % 42, rng() % 100);
+				}
+				CHECK(reference.addEdges(batch) == graph.addEdges(batch));
+				break;
+			}
+			case 7:
+				// Value of undirected edge is shared by both directions
+				if(reference.adjacent(from, to))
+				{
+					CHECK(reference.getEdgeValue(from, to) == graph.getEdgeValue(from, to));
+					graph.getEdgeValue(from, to) += 1;
+					reference.getEdgeValue(from, to) += 1;
+					if(!directed)
+					{
+						reference.getEdgeValue(to, from) = reference.getEdgeValue(from, to);
+					}
+				}
+				break;
+		}
+	}
+
+	CHECK(reference.getEdgesPositionsAndValues(true) == graph.getEdgesPositionsAndValues(true));
+	for(auto id : reference.getVerticesIds())
+	{
+		CHECK(reference.getEdgesFrom(id) == graph.getEdgesFrom(id));
+		if(directed)
+		{
+			CHECK(reference.getIncomingEdges(id) == graph.getIncomingEdges(id));
+		}
+	}
+	size_t source = reference.getVerticesIds()[0];
+	CHECK(Graph::dijkstraAll(reference, source).first == Graph::dijkstraAll(graph, source).first);
+	auto frozen = Graph::freeze(reference);
+	auto frozenShared = Graph::freeze(graph);
+	for(size_t e = 0; e < frozen.getEdgesCount(); ++e)
+	{
+		CHECK(frozen.weightAt(e) == frozenShared.weightAt(e));
+	}
+
+	auto copy = graph;
+	CHECK(copy == graph);
+	auto first = copy.getEdgesPositionsAndValues()[0];
+	copy.updateEdgeValue(std::get<0>(first), std::get<1>(first), 12345);
+	CHECK(!(copy == graph));
+
+	CHECK(graph.saveToFile(path));
+	Graph::Graph<std::string, size_t, S> loaded(directed);
+	CHECK(loaded.loadFromFile(path));
+	CHECK(loaded == graph);
+	std::remove(path.c_str());
+
+	// Slots of removed edges are reused, so memory does not grow
+	auto edges = graph.getEdgesPositionsAndValues();
+	size_t usage = 0;
+	for(int cycle = 0; cycle < 3; ++cycle)
+	{
+		for(auto& e : edges)
+		{
+			graph.removeEdge(std::get<0>(e), std::get<1>(e));
+		}
+		CHECK(graph.getEdgesPositions().empty());
+		graph.addEdges(edges);
+		if(cycle == 1)
+		{
+			usage = graph.memoryUsage().edgeValues;
+		}
+	}
+	CHECK(graph.memoryUsage().edgeValues == usage);
+	CHECK(graph == loaded);
+}
+
+/**
+ * Update through either direction changes the single value, released value frees its memory
+ */
+template<typename S>
+void testValues()
+{
+	Graph::Graph<int, std::string, S> graph(false);
+	graph.addVertex(1);
+	graph.addVertex(2);
+	graph.addEdge(0, 1, std::string(200, 'a'));
+	graph.updateEdgeValue(1, 0, std::string(300, 'b'));
+	CHECK(graph.getEdgeValue(0, 1) == std::string(300, 'b'));
+	size_t usage = graph.memoryUsage().edgeValues;
+	graph.removeEdge(0, 1);
+	CHECK(graph.memoryUsage().edgeValues + 250 <= usage);
+
+	Graph::Graph<int, Weight, S> weighted(false);
+	for(int i = 0; i < 600; ++i)
+	{
+		weighted.addVertex(i);
+	}
+	for(int i = 0; i + 1 < 600; ++i)
+	{
+		weighted.addEdge(i, i + 1, Weight(i));
+	}
+	CHECK(weighted.removeEdge(3, 4) == 2);
+	weighted.addEdge(3, 5, Weight(77));
+	CHECK(weighted.getEdgeValue(5, 3).value == 77);
+	auto copy = weighted;
+	CHECK(copy.getEdgeValue(598, 599).value == 598);
+	weighted.removeVertex(10);
+	CHECK(!weighted.adjacent(9, 10) && copy.adjacent(9, 10));
+}
+
+/**
+ * Numeric values of undirected graph take no more memory than with default storage,
+ * values owning heap memory are stored once
+ */
+void testMemory()
+{
+	Graph::Graph<std::string, size_t> reference(false);
+	Graph::Graph<std::string, size_t, Graph::SharedEdgeStorage> graph(false);
+	Test::randomFill(reference, 2000, 20000, 4);
+	Test::randomFill(graph, 2000, 20000, 4);
+	CHECK(graph.memoryUsage().total() <= reference.memoryUsage().total());
+
+	Graph::Graph<int, std::string> strings(false);
+	Graph::Graph<int, std::string, Graph::SharedEdgeStorage> sharedStrings(false);
+	for(int i = 0; i < 100; ++i)
+	{
+		strings.addVertex(i);
+		sharedStrings.addVertex(i);
+	}
+	for(size_t i = 0; i + 1 < 100; ++i)
+	{
+		strings.addEdge(i, i + 1, std::string(100, 'a'));
+		sharedStrings.addEdge(i, i + 1, std::string(100, 'a'));
+	}
+	CHECK(sharedStrings.memoryUsage().edgeValues < strings.memoryUsage().edgeValues);
+	CHECK(sharedStrings.memoryUsage().total() < strings.memoryUsage().total());
+}
+
+template<typename S>
+void testStorage()
+{
+	for(unsigned seed = 1; seed < 12; ++seed)
+	{
+		testMutations<S>(false, seed);
+		testMutations<S>(true, seed);
+	}
+	testValues<S>();
+}
+
+int main()
+{
+	testStorage<SharedAlwaysStorage>();
+	testStorage<SharedFlatStorage>();
+	testValues<Graph::SharedEdgeStorage>();
+	testMemory();
+	std::cout << "SharedEdgeStorage OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,96 @@
+#include <cstdio>
+#include "Test.h"
+
+/**
+ * Slot storage reuses ids of removed vertices (the last removed first) and otherwise
+ * behaves as default storage
+ */
+void testIdReuse(bool directed, unsigned seed)
+{
+	Graph::Graph<std::string, size_t> graph(directed);
+	Graph::Graph<std::string, size_t, Graph::SlotStorage> slots(directed);
+	Test::randomFill(graph, 30, 60, seed);
+	Test::randomFill(slots, 30, 60, seed);
+	graph.removeVertex(7);
+	slots.removeVertex(7);
+	graph.removeVertex(9);
+	slots.removeVertex(9);
+
+	CHECK(slots.addVertex("x") == 9);
+	CHECK(slots.addVertex("y") == 7);
+	CHECK(slots.addVertex("z") == 30);
+	CHECK(slots.getVerticesCount() == 31);
+	slots.removeVertex(9);
+	slots.removeVertex(7);
+	slots.removeVertex(30);
+
+	CHECK(graph.getVerticesIds() == slots.getVerticesIds());
+	for(auto id : graph.getVerticesIds())
+	{
+		CHECK(graph.getNeighbours(id) == slots.getNeighbours(id));
+		CHECK(graph.getEdgesFrom(id) == slots.getEdgesFrom(id));
+	}
+	CHECK(Graph::dijkstraAll(graph, 0).first == Graph::dijkstraAll(slots, 0).first);
+	CHECK(Graph::bellmanFord(slots, 0).first == Graph::dijkstraAll(slots, 0).first);
+	CHECK(Graph::dijkstra(slots, 0, 20).first == Graph::dijkstra(graph, 0, 20).first);
+	CHECK(Graph::dijkstraAll(Graph::freeze(slots), 0).first == Graph::dijkstraAll(slots, 0).first);
+
+	auto copy = slots;
+	CHECK(copy == slots);
+	copy.updateEdgeValue(0, 1, 1000);
+	CHECK(!(copy == slots));
+
+	// Free ids survive saving, graph with default storage continues after the highest id
+	const std::string path = "SlotStorage_test.txt";
+	CHECK(slots.saveToFile(path));
+	Graph::Graph<std::string, size_t, Graph::SlotStorage> loaded(directed);
+	CHECK(loaded.loadFromFile(path));
+	CHECK(loaded == slots);
+	CHECK(loaded.addVertex("new") == 9);
+	Graph::Graph<std::string, size_t> loadedDefault(directed);
+	CHECK(loadedDefault.loadFromFile(path));
+	CHECK(loadedDefault.addVertex("new") == 30);
+	std::remove(path.c_str());
+}
+
+/**
+ * Adding vertices grows slot array, views and value references of existing vertices stay valid
+ */
+void testStableViews()
+{
+	Graph::Graph<std::string, size_t, Graph::SlotStorage> graph;
+	size_t a = graph.addVertex("a"), b = graph.addVertex("b");
+	graph.addEdge(a, b, 1);
+	auto view = graph.getNeighboursView(a);
+	auto edges = graph.getEdgesFromView(a);
+	const std::string* value = &graph.getVertexValue(a);
+	for(int i = 0; i < 1000; ++i)
+	{
+		graph.addVertex("x");
+	}
+	graph.removeVertex(500);
+	graph.addVertex("y");
+
+	CHECK(std::vector<size_t>(view.begin(), view.end()) == std::vector<size_t>{ b });
+	CHECK(edges.begin() != edges.end() && (*edges.begin()).first == b && (*edges.begin()).second == 1 && std::next(edges.begin()) == edges.end());
+	CHECK(value == &graph.getVertexValue(a) && *value == "a");
+	CHECK(graph.getVerticesCount() == 1002);
+}
+
+int main()
+{
+	for(unsigned seed = 1; seed < 10; ++seed)
+	{
+		testIdReuse(false, seed);
+		testIdReuse(true, seed);
+	}
+
+	Graph::Graph<int, Graph::Unweight, Graph::SlotStorage> unweighted;
+	auto a = unweighted.addVertex(1), b = unweighted.addVertex(2);
+	unweighted.addEdge(a, b);
+	CHECK(unweighted.adjacent(a, b));
+	testStableViews();
+
+	std::cout << "SlotStorage OK" << std::endl;
+	return 0;
+}
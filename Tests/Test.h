@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define GRAPH_DEBUG
+#include "../Graph.h"
+#include "../Graph_algorithms.h"
+
+// Reports failed condition with its location and ends test with non-zero exit code
+#define CHECK(condition) \
+	do \
+	{ \
+		if(!(condition)) \
+		{ \
+			std::cerr << __FILE__ << ":" << __LINE__ << " CHECK failed: " #condition << std::endl; \
+			std::exit(1); \
+		} \
+	} while(0)
+
+namespace Test
+{
+	const size_t infinity = std::numeric_limits<size_t>::max();
+
+	/**
+	 * Adds n vertices connected into path and m random edges (duplicates are skipped by graph)
+	 * @param graph graph with string vertex values and numeric edge values
+	 * @param n count of vertices
+	 * @param m count of random edges
+	 * @param seed seed of generator
+	 * @param maxWeight maximal value of edge
+	 * @return ids of added vertices
+	 */
+	template<typename G>
+	std::vector<size_t> randomFill(G& graph, size_t n, size_t m, unsigned seed, size_t maxWeight = 20)
+	{
+		std::mt19937 rng(seed);
+		std::vector<size_t> ids;
+		for(size_t i = 0; i < n; ++i)
+		{
+			ids.push_back(graph.addVertex("v" + std::to_string(i)));
+		}
+		for(size_t i = 0; i + 1 < n; ++i)
+		{
+			graph.addEdge(ids[i], ids[i + 1], 1 + rng() % maxWeight);
+		}
+		for(size_t i = 0; i < m; ++i)
+		{
+			graph.addEdge(ids[rng() % n], ids[rng() % n], 1 + rng() % maxWeight);
+		}
+		return ids;
+	}
+
+	/**
+	 * Checks returned distance and that returned path has this length
+	 */
+	template<typename G>
+	void checkPath(const G& graph, size_t source, size_t target, const std::pair<size_t, std::vector<size_t>>& result, size_t expected)
+	{
+		CHECK(result.first == expected);
+		if(expected == infinity)
+		{
+			CHECK(result.second.size() == 1 && result.second[0] == target);
+			return;
+		}
+		CHECK(result.second.front() == source && result.second.back() == target);
+		size_t length = 0;
+		for(size_t k = 0; k + 1 < result.second.size(); ++k)
+		{
+			length += graph.getEdgeValue(result.second[k], result.second[k + 1]);
+		}
+		CHECK(length == expected);
+	}
+
+	/**
+	 * Compares frozen graphs array by array
+	 * @return true if graphs have the same direction, ids, values, offsets, targets and weights
+	 */
+	template<typename V, typename E>
+	bool sameFrozen(const Graph::FrozenGraph<V, E>& a, const Graph::FrozenGraph<V, E>& b)
+	{
+		if(a.isDirected() != b.isDirected() || a.getVerticesCount() != b.getVerticesCount() || a.getEdgesCount() != b.getEdgesCount())
+		{
+			return false;
+		}
+		for(size_t i = 0; i < a.getVerticesCount(); ++i)
+		{
+			if(a.idAt(i) != b.idAt(i) || !(a.valueAt(i) == b.valueAt(i)) || a.edgesBegin(i) != b.edgesBegin(i) || a.edgesEnd(i) != b.edgesEnd(i))
+			{
+				return false;
+			}
+		}
+		for(size_t e = 0; e < a.getEdgesCount(); ++e)
+		{
+			if(a.targetAt(e) != b.targetAt(e) || !(a.weightAt(e) == b.weightAt(e)))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
@@ -0,0 +1,139 @@
+#include <cstdio>
+#include <fstream>
+#include "Test.h"
+
+template<typename G>
+bool sameGraphs(const G& a, const G& b)
+{
+	if(a.getVerticesIds() != b.getVerticesIds())
+	{
+		return false;
+	}
+	for(auto id : a.getVerticesIds())
+	{
+		if(!(a.getVertexValue(id) == b.getVertexValue(id)) || a.getNeighbours(id) != b.getNeighbours(id))
+		{
+			return false;
+		}
+	}
+	return a.getEdgesPositionsAndValues(true) == b.getEdgesPositionsAndValues(true);
+}
+
+/**
+ * Parallel loader must read the same graph as stream-based loader
+ */
+template<typename G>
+bool loadsSame(const std::string& path, bool directed, size_t threads)
+{
+	G graph(directed), parallel(directed);
+	return graph.loadFromFile(path) && parallel.loadFromFileParallel(path, threads) && sameGraphs(graph, parallel);
+}
+
+void writeFile(const std::string& path, const std::string& text)
+{
+	std::ofstream output(path, std::ios::binary);
+	output << text;
+}
+
+const std::string path = "TextLoader_test.txt";
+
+void testSavedGraphs(bool directed, unsigned seed)
+{
+	Graph::Graph<std::string, size_t> graph(directed);
+	Test::randomFill(graph, 300, 900, seed);
+	graph.removeVertex(17);
+	CHECK(graph.saveToFile(path));
+	for(size_t threads : { 0, 1, 3, 7, 64 })
+	{
+		Graph::Graph<std::string, size_t> loaded(directed), parallel(directed);
+		CHECK(loaded.loadFromFile(path));
+		CHECK(parallel.loadFromFileParallel(path, threads));
+		CHECK(sameGraphs(loaded, parallel));
+		CHECK(loaded.addVertex("x") == parallel.addVertex("x"));
+
+		Graph::Graph<std::string, size_t, Graph::SharedEdgeStorage> shared(directed);
+		CHECK(shared.loadFromFileParallel(path, threads));
+		CHECK(shared.getEdgesPositionsAndValues(true) == graph.getEdgesPositionsAndValues(true));
+	}
+}
+
+/**
+ * Negative and floating numbers, quoted strings and unweighted edges
+ */
+void testValueTypes()
+{
+	Graph::Graph<int, double> numbers(true);
+	for(int i = 0; i < 50; ++i)
+	{
+		numbers.addVertex(i * 37 - 1000);
+	}
+	for(int i = 0; i + 1 < 50; ++i)
+	{
+		numbers.addEdge(i, i + 1, i * 0.37 - 3.1e-5);
+	}
+	numbers.addEdge(3, 4, 1e300);
+	numbers.addEdge(5, 5, -0.0);
+	CHECK(numbers.saveToFile(path));
+	CHECK((loadsSame<Graph::Graph<int, double>>(path, true, 4)));
+
+	Graph::Graph<std::string, std::string> strings(false);
+	strings.addVertex("hello world");
+	strings.addVertex("with \"quote\" inside");
+	strings.addVertex("");
+	strings.addEdge(0, 1, "edge one");
+	strings.addEdge(1, 2, "");
+	strings.addEdge(2, 2, "self");
+	CHECK(strings.saveToFile(path));
+	CHECK((loadsSame<Graph::Graph<std::string, std::string>>(path, false, 2)));
+
+	Graph::Graph<char, Graph::Unweight> unweighted(true);
+	for(int i = 0; i < 26; ++i)
+	{
+		unweighted.addVertex(char('a' + i));
+	}
+	for(int i = 0; i < 26; ++i)
+	{
+		unweighted.addEdge(i, (i * 7) % 26);
+	}
+	CHECK(unweighted.saveToFile(path));
+	CHECK((loadsSame<Graph::Graph<char, Graph::Unweight>>(path, true, 5)));
+}
+
+/**
+ * Hand written files with CRLF, missing final newline, overflowing values and malformed lines
+ */
+void testHandWritten()
+{
+	writeFile(path, "id 0 5\r\n1 7\r\nid 1 99999999999999999999\r\n0 -3\nid 2 +4\n0 12abc");
+	CHECK((loadsSame<Graph::Graph<int, int>>(path, true, 3)));
+	writeFile(path, "id 0 \"a\"\n1 \"x\"\n1 y\nid 1 \"b\"\n0 noquote\n");
+	CHECK((loadsSame<Graph::Graph<std::string, std::string>>(path, true, 2)));
+
+	// Edge before vertex, empty line, invalid id, unknown line
+	for(const char* text : { "1 5\nid 0 1\n", "id 0 1\n\nid 1 2\n", "id x 1\n", "id 0 1\nzz 4\n" })
+	{
+		writeFile(path, text);
+		Graph::Graph<int, int> graph(true);
+		CHECK(!graph.loadFromFileParallel(path, 2));
+		CHECK(graph.getVerticesCount() == 0);
+	}
+
+	Graph::Graph<int, int> graph(true);
+	CHECK(!graph.loadFromFileParallel("TextLoader_missing.txt"));
+	writeFile(path, "");
+	CHECK(graph.loadFromFileParallel(path) && graph.getVerticesCount() == 0);
+}
+
+int main()
+{
+	for(unsigned seed = 1; seed < 5; ++seed)
+	{
+		testSavedGraphs(false, seed);
+		testSavedGraphs(true, seed);
+	}
+	testValueTypes();
+	testHandWritten();
+	std::remove(path.c_str());
+	std::cout << "TextLoader OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,76 @@
+#include <iterator>
+#include <map>
+#include "Test.h"
+
+struct SlotFlatStorage : Graph::SlotStorage
+{
+	template<typename T, template<typename> class Allocator>
+	using edge_container = Graph::FlatMap<T, Allocator>;
+};
+
+struct SharedFlatStorage : Graph::FlatStorage
+{
+	template<typename T, template<typename> class Allocator>
+	using edge_store = Graph::SharedEdgeStore<T, Allocator>;
+};
+
+/**
+ * Views iterate the same neighbours and edges as copying getters
+ */
+template<typename S>
+void testViews(bool directed)
+{
+	Graph::Graph<std::string, size_t, S> graph(directed);
+	Test::randomFill(graph, 30, 80, 3);
+	for(auto id : graph.getVerticesIds())
+	{
+		std::vector<size_t> neighbours;
+		for(auto to : graph.getNeighboursView(id))
+		{
+			neighbours.push_back(to);
+		}
+		CHECK(neighbours == graph.getNeighbours(id));
+		CHECK(graph.getNeighboursView(id).size() == neighbours.size());
+		auto view = graph.getNeighboursView(id);
+		CHECK(size_t(std::distance(view.begin(), view.end())) == neighbours.size());
+
+		std::map<size_t, size_t> edges;
+		for(const auto& e : graph.getEdgesFromView(id))
+		{
+			edges.emplace(e.first, e.second);
+		}
+		CHECK(edges == graph.getEdgesFrom(id));
+	}
+
+	CHECK(graph.getNeighboursView(12345).empty());
+	bool thrown = false;
+	try
+	{
+		graph.getEdgesFromView(12345);
+	}
+	catch(const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	CHECK(thrown);
+	CHECK(Graph::bellmanFord(graph, 0).first == Graph::dijkstraAll(graph, 0).first);
+}
+
+template<typename S>
+void testStorage()
+{
+	testViews<S>(false);
+	testViews<S>(true);
+}
+
+int main()
+{
+	testStorage<Graph::DefaultStorage>();
+	testStorage<Graph::SlotStorage>();
+	testStorage<Graph::FlatStorage>();
+	testStorage<SlotFlatStorage>();
+	testStorage<Graph::SharedEdgeStorage>();
+	testStorage<SharedFlatStorage>();
+	std::cout << "Views OK" << std::endl;
+	return 0;
+}
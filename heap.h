@@ -2,17 +2,11 @@
 #include <initializer_list>
 #include <vector>
 #include <memory>
-#include <cmath>
+#include <algorithm> // min
 
 #ifndef CPP14_HEAP
 #define CPP14_HEAP
 
-namespace Graph {
-	template<typename V, typename E>
-	std::pair<std::map<size_t, E>, std::map<size_t, size_t>> dijkstraAll(const Graph<V, E>& graph, size_t source, E infinity = std::numeric_limits<E>::max());
-}
-
-
 	/*
 	The heap type, parametrized by the type of elements and by the type that
 	defines a comparator. The comparator is expected to be stateless and default
@@ -40,10 +34,6 @@ namespace Graph {
 	template< typename T, typename Compare >
 	struct Heap {
 
-		
-		template<typename V, typename E>
-		friend std::pair<std::map<size_t, E>, std::map<size_t, size_t>> Graph::dijkstraAll(const Graph::Graph<V, E>& graph, size_t source, E infinity);
-		
 		using value_type = T;
 
 		struct Node {
@@ -283,29 +273,36 @@ namespace Graph {
 		{
 			Compare comparator;
 			int child = node;
-			int parent = int(std::floor((child - 1) / 2));
-			while (comparator(heap_imp[parent]._node->data, heap_imp[child]._node->data) && child > 0)
+			while (child > 0)
 			{
+				int parent = (child - 1) / 2;
+				if (!comparator(heap_imp[parent]._node->data, heap_imp[child]._node->data))
+				{
+					break;
+				}
 				std::swap(heap_imp[parent], heap_imp[child]);
 				std::swap((heap_imp[parent])._node->pos, (heap_imp[child])._node->pos);
 				child = parent;
-				parent = int(std::floor((child - 1) / 2));
 			}
 		}
 
 		void heapify(int node)
 		{
 			Compare comparator;
-			int left = 2 * node + 1;
-			int right = 2 * node + 2;
-			int m = node;
-			if (left < int(heap_imp.size()) && comparator((heap_imp[m])._node->data, (heap_imp[left])._node->data)) { m = left; }
-			if (right < int(heap_imp.size()) && comparator((heap_imp[m])._node->data, (heap_imp[right])._node->data)) { m = right; }
-			if (m != node)
+			while (true)
 			{
+				int left = 2 * node + 1;
+				int right = 2 * node + 2;
+				int m = node;
+				if (left < int(heap_imp.size()) && comparator((heap_imp[m])._node->data, (heap_imp[left])._node->data)) { m = left; }
+				if (right < int(heap_imp.size()) && comparator((heap_imp[m])._node->data, (heap_imp[right])._node->data)) { m = right; }
+				if (m == node)
+				{
+					break;
+				}
 				std::swap(heap_imp[node], heap_imp[m]);
 				std::swap((heap_imp[node])._node->pos, (heap_imp[m])._node->pos);
-				heapify(m);
+				node = m;
 			}
 		}
 
@@ -366,6 +363,232 @@ namespace Graph {
 	template< typename T, typename Cmp >
 	void swap(Heap< T, Cmp > & a, Heap< T, Cmp > & b) { a.swap(b); }
 
+	/*
+	Indexed d-ary heap of elements identified by dense ids in range [0, capacity).
+	Ordering of Compare is the same as in Heap (std::less< Key > creates max-heap).
+
+	Heap entries (key and id) are stored in one contiguous array in heap order and
+	position of every id is stored in array indexed by id, so no element is
+	allocated separately and decrease-key only moves entries within the array.
+	Wider Arity makes the heap shallower, which suits frequent decrease-key and
+	push operations of shortest path searches (4 or 8 are good choices).
+	 */
+	template< typename Key, typename Compare, size_t Arity = 4 >
+	struct IndexedHeap {
+		static_assert(Arity >= 2, "arity of heap must be at least 2");
+
+		using key_type = Key;
+
+		// Position of ids which are not in heap.
+		static constexpr size_t npos = size_t(-1);
+
+		// O(1). Creates heap for no ids.
+		IndexedHeap()
+		{}
+
+		// O(capacity). Creates heap for ids in range [0, capacity).
+		explicit IndexedHeap(size_t capacity) :positions(capacity, npos)
+		{}
+
+		// O(capacity). Extends range of ids, elements in heap stay.
+		void resize(size_t capacity)
+		{
+			if (capacity > positions.size())
+			{
+				positions.resize(capacity, npos);
+			}
+		}
+
+		// O(1). Get size of range of ids.
+		size_t capacity() const
+		{
+			return positions.size();
+		}
+
+		// O(1). Is element with given id in the heap?
+		bool contains(size_t id) const
+		{
+			return positions[id] != npos;
+		}
+
+		// O(1). Get the id of top element of the heap.
+		size_t top() const
+		{
+			return heap_imp[0].id;
+		}
+
+		// O(1). Get the key of top element of the heap.
+		const Key &topKey() const
+		{
+			return heap_imp[0].key;
+		}
+
+		// O(1). Get key of element with given id.
+		// Precondition: contains(id).
+		const Key &key(size_t id) const
+		{
+			return heap_imp[positions[id]].key;
+		}
+
+		// O(log n). Insert element with given id.
+		// Precondition: !contains(id).
+		void push(size_t id, const Key &key)
+		{
+			heap_imp.push_back(Entry{ key, id });
+			positions[id] = heap_imp.size() - 1;
+			bubble_up(heap_imp.size() - 1);
+		}
+
+		// O(log n). Replace key of element with given id.
+		// Precondition: contains(id).
+		void update(size_t id, const Key &key)
+		{
+			size_t pos = positions[id];
+			Compare comparator;
+			bool up = comparator(heap_imp[pos].key, key);
+			heap_imp[pos].key = key;
+			if (up)
+			{
+				bubble_up(pos);
+			}
+			else
+			{
+				sift_down(pos);
+			}
+		}
+
+		// O(log n). Insert element or replace its key if it is already in the heap.
+		void pushOrUpdate(size_t id, const Key &key)
+		{
+			if (contains(id))
+			{
+				update(id, key);
+			}
+			else
+			{
+				push(id, key);
+			}
+		}
+
+		// O(log n). Remove the top element from the heap.
+		void pop()
+		{
+			erase(heap_imp[0].id);
+		}
+
+		// O(log n). Remove element with given id from the heap.
+		// Precondition: contains(id).
+		void erase(size_t id)
+		{
+			size_t pos = positions[id];
+			positions[id] = npos;
+			Entry last = std::move(heap_imp.back());
+			heap_imp.pop_back();
+			if (pos < heap_imp.size())
+			{
+				Compare comparator;
+				bool up = comparator(heap_imp[pos].key, last.key);
+				heap_imp[pos] = std::move(last);
+				positions[heap_imp[pos].id] = pos;
+				if (up)
+				{
+					bubble_up(pos);
+				}
+				else
+				{
+					sift_down(pos);
+				}
+			}
+		}
+
+		// O(n). Remove all elements, range of ids stays.
+		void clear()
+		{
+			for (const auto &entry : heap_imp)
+			{
+				positions[entry.id] = npos;
+			}
+			heap_imp.clear();
+		}
+
+		// O(1). Get size (number of elements) of the heap.
+		size_t size() const
+		{
+			return heap_imp.size();
+		}
+
+		// O(1). Is the heap empty?
+		bool empty() const
+		{
+			return heap_imp.empty();
+		}
+
+	private:
+		struct Entry {
+			Key key;
+			size_t id;
+		};
+
+		std::vector<Entry> heap_imp;
+		std::vector<size_t> positions;
+
+		// Entries are moved into the hole instead of being swapped
+		void bubble_up(size_t pos)
+		{
+			Compare comparator;
+			Entry entry = std::move(heap_imp[pos]);
+			while (pos > 0)
+			{
+				size_t parent = (pos - 1) / Arity;
+				if (!comparator(heap_imp[parent].key, entry.key))
+				{
+					break;
+				}
+				heap_imp[pos] = std::move(heap_imp[parent]);
+				positions[heap_imp[pos].id] = pos;
+				pos = parent;
+			}
+			heap_imp[pos] = std::move(entry);
+			positions[heap_imp[pos].id] = pos;
+		}
+
+		void sift_down(size_t pos)
+		{
+			Compare comparator;
+			Entry entry = std::move(heap_imp[pos]);
+			const size_t count = heap_imp.size();
+			while (true)
+			{
+				size_t first = pos * Arity + 1;
+				if (first >= count)
+				{
+					break;
+				}
+				size_t last = std::min(first + Arity, count);
+				size_t best = first;
+				for (size_t child = first + 1; child < last; ++child)
+				{
+					if (comparator(heap_imp[best].key, heap_imp[child].key))
+					{
+						best = child;
+					}
+				}
+				if (!comparator(entry.key, heap_imp[best].key))
+				{
+					break;
+				}
+				heap_imp[pos] = std::move(heap_imp[best]);
+				positions[heap_imp[pos].id] = pos;
+				pos = best;
+			}
+			heap_imp[pos] = std::move(entry);
+			positions[heap_imp[pos].id] = pos;
+		}
+	};
+
+	template< typename Key, typename Compare, size_t Arity >
+	constexpr size_t IndexedHeap< Key, Compare, Arity >::npos;
+
 	// examples of concrete heaps
 
 	template< typename T >
@@ -374,6 +597,9 @@ namespace Graph {
 	template< typename T >
 	using MinHeap = Heap< T, std::greater< T > >;
 
+	template< typename Key, size_t Arity = 4 >
+	using MinIndexedHeap = IndexedHeap< Key, std::greater< Key >, Arity >;
+
 	template< typename A, typename B, typename Cmp >
 	struct PairCompare {
 		bool operator()(const std::pair< A, B > & a, const std::pair< A, B > & b) const {